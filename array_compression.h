@@ -0,0 +1,513 @@
+/**
+ * @file array_compression.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Compressed on-disk Array container for Better Array. Block based, with random access slices.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17. Files are stored in native (little-endian) byte order.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef ARRAY_COMPRESSION_H
+#define ARRAY_COMPRESSION_H
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+#include "better_array.h"
+using namespace std;
+/**
+ * @brief Compression namespace containing block codecs used by compressed Array files
+ *
+ * File layout: header (magic "BAZ1", codec, element size, block size, element count, block count),
+ * block index (offset and byte length of every block) and independently decodable data blocks.
+ */
+namespace Compression {
+    enum Codec {RAW = 0, DELTA = 1, XOR = 2, LZ = 3};
+    const char Magic[4] = {'B', 'A', 'Z', '1'};
+    const unsigned DefaultBlockSize = 16384;
+    /**
+     * @brief Codec used for given Array type
+     * @tparam T Array Type
+     * @return Codec DELTA for integers, XOR for floating point, LZ for strings and other types
+     */
+    template <class T>
+    constexpr Codec codecFor () {
+        if (is_integral<T>::value && !is_same<T, bool>::value) return DELTA;
+        if (is_same<T, float>::value || is_same<T, double>::value) return XOR;
+        return LZ;
+    }
+    // Bit level writer used by packing codecs
+    class BitWriter {
+        private:
+            vector<uint8_t> &Out;
+            uint64_t acc;
+            unsigned filled;
+        public:
+            explicit BitWriter (vector<uint8_t> &Buffer) : Out(Buffer), acc(0), filled(0) {}
+            void write (uint64_t value, unsigned bits) {
+                while (bits > 0) {
+                    unsigned take = bits < 8 - filled ? bits : 8 - filled;
+                    uint64_t part = (value >> (bits - take)) & ((1ull << take) - 1);
+                    acc = (acc << take) | part;
+                    filled += take;
+                    bits -= take;
+                    if (filled == 8) {
+                        Out.push_back((uint8_t) acc);
+                        acc = 0;
+                        filled = 0;
+                    }
+                }
+            }
+            void flush () {
+                if (filled > 0) Out.push_back((uint8_t) (acc << (8 - filled)));
+                acc = 0;
+                filled = 0;
+            }
+    };
+    // Bit level reader used by packing codecs
+    class BitReader {
+        private:
+            const uint8_t* In;
+            size_t bytes, pos;
+            unsigned used;
+        public:
+            BitReader (const uint8_t* Buffer, size_t Length) : In(Buffer), bytes(Length), pos(0), used(0) {}
+            uint64_t read (unsigned bits) {
+                uint64_t value = 0;
+                while (bits > 0) {
+                    if (pos >= bytes) throw std::invalid_argument("Corrupted compressed Array block!");
+                    unsigned take = bits < 8 - used ? bits : 8 - used;
+                    uint64_t part = (In[pos] >> (8 - used - take)) & ((1u << take) - 1);
+                    value = (value << take) | part;
+                    used += take;
+                    bits -= take;
+                    if (used == 8) {
+                        pos++;
+                        used = 0;
+                    }
+                }
+                return value;
+            }
+    };
+    inline void putVarint (vector<uint8_t> &Out, uint64_t value) {
+        while (value >= 0x80) {
+            Out.push_back((uint8_t) (value | 0x80));
+            value >>= 7;
+        }
+        Out.push_back((uint8_t) value);
+    }
+    inline uint64_t getVarint (const uint8_t* In, size_t bytes, size_t &pos) {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos >= bytes) throw std::invalid_argument("Corrupted compressed Array block!");
+            uint8_t b = In[pos++];
+            value |= (uint64_t) (b & 0x7f) << shift;
+            if (!(b & 0x80)) return value;
+        }
+        throw std::invalid_argument("Corrupted compressed Array block!");
+    }
+    /**
+     * @brief LZ-style compression of generic bytes (literal runs and back-references)
+     * @param Src Source bytes
+     * @param n Source length
+     * @param Out Output buffer (appended)
+     */
+    inline void lzCompress (const uint8_t* Src, size_t n, vector<uint8_t> &Out) {
+        const unsigned hashBits = 14;
+        vector<int64_t> table(1u << hashBits, -1);
+        putVarint(Out, n);
+        size_t i = 0, anchor = 0;
+        while (i + 4 <= n) {
+            uint32_t seq;
+            memcpy(&seq, Src + i, 4);
+            uint32_t h = (seq * 2654435761u) >> (32 - hashBits);
+            int64_t cand = table[h];
+            table[h] = (int64_t) i;
+            if (cand >= 0 && memcmp(Src + cand, Src + i, 4) == 0) {
+                size_t len = 4;
+                while (i + len < n && Src[cand + len] == Src[i + len]) len++;
+                putVarint(Out, i - anchor);
+                Out.insert(Out.end(), Src + anchor, Src + i);
+                putVarint(Out, len);
+                putVarint(Out, i - (size_t) cand);
+                i += len;
+                anchor = i;
+            }
+            else i++;
+        }
+        putVarint(Out, n - anchor);
+        Out.insert(Out.end(), Src + anchor, Src + n);
+        putVarint(Out, 0);
+    }
+    /**
+     * @brief Decompress bytes produced by lzCompress()
+     * @param In Compressed bytes
+     * @param bytes Compressed length
+     * @param limit Largest accepted decompressed length
+     * @return vector<uint8_t> Decompressed bytes
+     */
+    inline vector<uint8_t> lzDecompress (const uint8_t* In, size_t bytes, size_t limit = SIZE_MAX) {
+        size_t pos = 0;
+        uint64_t n = getVarint(In, bytes, pos);
+        if (n > limit) throw std::invalid_argument("Corrupted compressed Array block!");
+        vector<uint8_t> Out;
+        // Length is read from the file, so without a limit only what the input can back is reserved up front
+        Out.reserve(limit != SIZE_MAX || n / 64 < bytes ? n : bytes * 64);
+        while (true) {
+            uint64_t lit = getVarint(In, bytes, pos);
+            if (lit > bytes - pos || lit > n - Out.size()) throw std::invalid_argument("Corrupted compressed Array block!");
+            Out.insert(Out.end(), In + pos, In + pos + lit);
+            pos += lit;
+            uint64_t len = getVarint(In, bytes, pos);
+            if (len == 0) break;
+            uint64_t offset = getVarint(In, bytes, pos);
+            if (offset == 0 || offset > Out.size() || len > n - Out.size()) throw std::invalid_argument("Corrupted compressed Array block!");
+            size_t from = Out.size() - offset;
+            for (uint64_t k = 0; k < len; k++) Out.push_back(Out[from + k]);
+        }
+        if (Out.size() != n) throw std::invalid_argument("Corrupted compressed Array block!");
+        return Out;
+    }
+    // Delta + zig-zag + bit-packing for integral types
+    template <class T>
+    void encodeDelta (const T* Values, size_t n, vector<uint8_t> &Out) {
+        typedef typename make_unsigned<T>::type U;
+        const unsigned bits = sizeof(T) * 8;
+        U prev = (U) Values[0];
+        for (unsigned b = 0; b < sizeof(U); b++) Out.push_back((uint8_t) ((uint64_t) prev >> (8 * b)));
+        vector<U> zig(n > 0 ? n - 1 : 0);
+        U all = 0;
+        for (size_t i = 1; i < n; i++) {
+            U d = (U) ((U) Values[i] - prev);
+            U mask = (U) (0 - (U) (d >> (bits - 1)));
+            zig[i - 1] = (U) ((U) (d << 1) ^ mask);
+            all |= zig[i - 1];
+            prev = (U) Values[i];
+        }
+        unsigned width = 0;
+        while (width < bits && (uint64_t) all >> width) width++;
+        Out.push_back((uint8_t) width);
+        if (width == 0) return;
+        BitWriter W(Out);
+        for (size_t i = 0; i < zig.size(); i++) W.write(zig[i], width);
+        W.flush();
+    }
+    template <class T>
+    void decodeDelta (const uint8_t* In, size_t bytes, T* Out, size_t n) {
+        typedef typename make_unsigned<T>::type U;
+        if (bytes < sizeof(U) + 1) throw std::invalid_argument("Corrupted compressed Array block!");
+        uint64_t first = 0;
+        for (unsigned b = 0; b < sizeof(U); b++) first |= (uint64_t) In[b] << (8 * b);
+        U prev = (U) first;
+        unsigned width = In[sizeof(U)];
+        if (width > sizeof(U) * 8) throw std::invalid_argument("Corrupted compressed Array block!");
+        Out[0] = (T) prev;
+        BitReader R(In + sizeof(U) + 1, bytes - sizeof(U) - 1);
+        for (size_t i = 1; i < n; i++) {
+            U zig = width > 0 ? (U) R.read(width) : 0;
+            U d = (U) ((U) (zig >> 1) ^ (U) (0 - (U) (zig & 1)));
+            prev = (U) (prev + d);
+            Out[i] = (T) prev;
+        }
+    }
+    // XOR (Gorilla-style) coding for floating point types
+    template <class T>
+    void encodeXor (const T* Values, size_t n, vector<uint8_t> &Out) {
+        typedef typename conditional<sizeof(T) == 8, uint64_t, uint32_t>::type U;
+        const unsigned bits = sizeof(U) * 8;
+        U prev;
+        memcpy(&prev, &Values[0], sizeof(U));
+        BitWriter W(Out);
+        W.write(prev, bits);
+        unsigned prevLead = bits + 1, prevTrail = 0;
+        for (size_t i = 1; i < n; i++) {
+            U cur;
+            memcpy(&cur, &Values[i], sizeof(U));
+            U x = cur ^ prev;
+            prev = cur;
+            if (x == 0) {
+                W.write(0, 1);
+                continue;
+            }
+            unsigned lead = bits == 64 ? __builtin_clzll((uint64_t) x) : __builtin_clz((uint32_t) x);
+            unsigned trail = bits == 64 ? __builtin_ctzll((uint64_t) x) : __builtin_ctz((uint32_t) x);
+            if (prevLead <= bits && lead >= prevLead && trail >= prevTrail) {
+                W.write(2, 2);
+                W.write(x >> prevTrail, bits - prevLead - prevTrail);
+            }
+            else {
+                unsigned sig = bits - lead - trail;
+                W.write(3, 2);
+                W.write(lead, 6);
+                W.write(sig - 1, 6);
+                W.write(x >> trail, sig);
+                prevLead = lead;
+                prevTrail = trail;
+            }
+        }
+        W.flush();
+    }
+    template <class T>
+    void decodeXor (const uint8_t* In, size_t bytes, T* Out, size_t n) {
+        typedef typename conditional<sizeof(T) == 8, uint64_t, uint32_t>::type U;
+        const unsigned bits = sizeof(U) * 8;
+        BitReader R(In, bytes);
+        U prev = (U) R.read(bits);
+        memcpy(&Out[0], &prev, sizeof(U));
+        unsigned lead = 0, trail = 0;
+        for (size_t i = 1; i < n; i++) {
+            if (R.read(1) == 1) {
+                if (R.read(1) == 1) {
+                    lead = (unsigned) R.read(6);
+                    unsigned sig = (unsigned) R.read(6) + 1;
+                    if (lead + sig > bits) throw std::invalid_argument("Corrupted compressed Array block!");
+                    trail = bits - lead - sig;
+                }
+                prev ^= (U) (R.read(bits - lead - trail) << trail);
+            }
+            memcpy(&Out[i], &prev, sizeof(U));
+        }
+    }
+    // LZ coding of serialized elements (strings or raw bytes)
+    template <class T>
+    void encodeBytes (const T* Values, size_t n, vector<uint8_t> &Out) {
+        vector<uint8_t> raw;
+        if constexpr (is_same<T, string>::value) {
+            for (size_t i = 0; i < n; i++) {
+                putVarint(raw, Values[i].size());
+                raw.insert(raw.end(), Values[i].begin(), Values[i].end());
+            }
+        }
+        else {
+            static_assert(is_trivially_copyable<T>::value, "Compressed Array files support integral, floating point, string and trivially copyable types only!");
+            raw.resize(n * sizeof(T));
+            for (size_t i = 0; i < n; i++) memcpy(raw.data() + i * sizeof(T), &Values[i], sizeof(T));
+        }
+        lzCompress(raw.data(), raw.size(), Out);
+    }
+    template <class T>
+    void decodeBytes (const uint8_t* In, size_t bytes, T* Out, size_t n) {
+        size_t need = SIZE_MAX;
+        if constexpr (!is_same<T, string>::value) {
+            if (__builtin_mul_overflow(n, sizeof(T), &need)) throw std::invalid_argument("Corrupted compressed Array block!");
+        }
+        vector<uint8_t> raw = lzDecompress(In, bytes, need);
+        if constexpr (is_same<T, string>::value) {
+            size_t pos = 0;
+            for (size_t i = 0; i < n; i++) {
+                uint64_t len = getVarint(raw.data(), raw.size(), pos);
+                if (len > raw.size() - pos) throw std::invalid_argument("Corrupted compressed Array block!");
+                Out[i].assign((const char*) raw.data() + pos, len);
+                pos += len;
+            }
+        }
+        else {
+            if (raw.size() != need) throw std::invalid_argument("Corrupted compressed Array block!");
+            for (size_t i = 0; i < n; i++) memcpy(&Out[i], raw.data() + i * sizeof(T), sizeof(T));
+        }
+    }
+    /**
+     * @brief Encode one block of values with codec matching type T
+     * @tparam T Array Type
+     * @param Values Block values
+     * @param n Block length (at least 1)
+     * @return vector<uint8_t> Encoded block
+     */
+    template <class T>
+    vector<uint8_t> encodeBlock (const T* Values, size_t n) {
+        vector<uint8_t> Out;
+        if constexpr (codecFor<T>() == DELTA) encodeDelta(Values, n, Out);
+        else if constexpr (codecFor<T>() == XOR) encodeXor(Values, n, Out);
+        else encodeBytes(Values, n, Out);
+        return Out;
+    }
+    /**
+     * @brief Decode one block of values encoded by encodeBlock()
+     * @tparam T Array Type
+     * @param In Encoded block
+     * @param bytes Encoded block length
+     * @param Out Output values
+     * @param n Block length
+     */
+    template <class T>
+    void decodeBlock (const uint8_t* In, size_t bytes, T* Out, size_t n) {
+        if constexpr (codecFor<T>() == DELTA) decodeDelta(In, bytes, Out, n);
+        else if constexpr (codecFor<T>() == XOR) decodeXor(In, bytes, Out, n);
+        else decodeBytes(In, bytes, Out, n);
+    }
+    // Parsed file header with block index
+    struct FileIndex {
+        uint8_t codec, elemSize;
+        uint32_t blockSize;
+        uint64_t count;
+        uint64_t dataStart;
+        vector<uint64_t> offsets, lengths;
+    };
+    template <class T>
+    FileIndex readIndex (ifstream &f) {
+        FileIndex I;
+        char magic[4];
+        uint16_t reserved;
+        uint32_t blocks;
+        f.seekg(0, ios::end);
+        uint64_t fileLength = (uint64_t) f.tellg();
+        f.seekg(0, ios::beg);
+        f.read(magic, 4);
+        f.read((char*) &I.codec, 1);
+        f.read((char*) &I.elemSize, 1);
+        f.read((char*) &reserved, 2);
+        f.read((char*) &I.blockSize, 4);
+        f.read((char*) &I.count, 8);
+        f.read((char*) &blocks, 4);
+        if (!f || memcmp(magic, Magic, 4) != 0) throw std::invalid_argument("File is not a compressed Array file!");
+        if (I.codec != codecFor<T>() || I.elemSize != sizeof(T)) throw std::invalid_argument("Compressed Array file type does not match Array type!");
+        // Counts come from the file: Array sizes are 32-bit and the block index must fit in the file
+        if (I.count > 0xFFFFFFFFull || I.blockSize == 0 || blocks != (I.count + I.blockSize - 1) / I.blockSize) throw std::invalid_argument("Corrupted compressed Array file!");
+        if ((uint64_t) blocks * 16 > fileLength - (uint64_t) f.tellg()) throw std::invalid_argument("Corrupted compressed Array file!");
+        I.offsets.resize(blocks);
+        I.lengths.resize(blocks);
+        for (uint32_t b = 0; b < blocks; b++) {
+            f.read((char*) &I.offsets[b], 8);
+            f.read((char*) &I.lengths[b], 8);
+        }
+        if (!f) throw std::invalid_argument("Corrupted compressed Array file!");
+        I.dataStart = (uint64_t) f.tellg();
+        // Blocks must follow each other inside the data section
+        uint64_t available = fileLength - I.dataStart, next = 0;
+        for (uint32_t b = 0; b < blocks; b++) {
+            if (I.offsets[b] < next || I.lengths[b] > available || I.offsets[b] > available - I.lengths[b]) throw std::invalid_argument("Corrupted compressed Array file!");
+            next = I.offsets[b] + I.lengths[b];
+        }
+        return I;
+    }
+    /**
+     * @brief Decode blocks [FirstBlock, LastBlock] and copy elements [From, To] (global, inclusive) into Out
+     */
+    template <class T>
+    void decodeRange (ifstream &f, const FileIndex &I, uint64_t From, uint64_t To, T* Out) {
+        uint64_t firstBlock = From / I.blockSize, lastBlock = To / I.blockSize;
+        uint64_t begin = I.offsets[firstBlock], end = I.offsets[lastBlock] + I.lengths[lastBlock];
+        vector<uint8_t> raw(end - begin);
+        f.seekg(I.dataStart + begin);
+        f.read((char*) raw.data(), raw.size());
+        if (!f) throw std::invalid_argument("Corrupted compressed Array file!");
+        uint64_t blocks = lastBlock - firstBlock + 1;
+        Parallel::forChunks(blocks, Parallel::chunks(blocks, 1), [&] (unsigned, unsigned long long b0, unsigned long long b1) {
+            vector<T> block;
+            for (uint64_t b = firstBlock + b0; b < firstBlock + b1; b++) {
+                uint64_t blockFrom = b * I.blockSize;
+                uint64_t blockLen = I.count - blockFrom < I.blockSize ? I.count - blockFrom : I.blockSize;
+                uint64_t lo = From > blockFrom ? From : blockFrom;
+                uint64_t hi = To < blockFrom + blockLen - 1 ? To : blockFrom + blockLen - 1;
+                const uint8_t* src = raw.data() + (I.offsets[b] - begin);
+                if (lo == blockFrom && hi == blockFrom + blockLen - 1) decodeBlock(src, I.lengths[b], Out + (lo - From), blockLen);
+                else {
+                    block.resize(blockLen);
+                    decodeBlock(src, I.lengths[b], block.data(), blockLen);
+                    for (uint64_t k = lo; k <= hi; k++) Out[k - From] = block[k - blockFrom];
+                }
+            }
+        });
+    }
+}
+namespace Files {
+    /**
+     * @brief Save Array to a compressed, block indexed file
+     * @tparam T Integral, floating point, string or trivially copyable type
+     * @param Arr Array
+     * @param FileName File Name
+     * @param blockSize Elements per independently decodable block (default = 16384)
+     */
+    template <class T>
+    void saveCompressed (const Array<T> &Arr, const string &FileName, unsigned blockSize = Compression::DefaultBlockSize) {
+        BA_PROFILE_SCOPE("Files::saveCompressed");
+        if (blockSize == 0) throw std::invalid_argument("Block size must be at least 1!");
+        uint64_t count = Arr.size();
+        uint32_t blocks = (uint32_t) ((count + blockSize - 1) / blockSize);
+        vector<vector<uint8_t>> encoded(blocks);
+        const T* src = Arr.data();
+        Parallel::forChunks(blocks, Parallel::chunks(blocks, 1), [&] (unsigned, unsigned long long b0, unsigned long long b1) {
+            for (uint64_t b = b0; b < b1; b++) {
+                uint64_t from = b * blockSize;
+                uint64_t len = count - from < blockSize ? count - from : blockSize;
+                encoded[b] = Compression::encodeBlock(src + from, len);
+            }
+        });
+        ofstream f(FileName, ios::out | ios::binary);
+        if (!f) throw std::invalid_argument("Cannot open file for writing!");
+        uint8_t codec = Compression::codecFor<T>(), elemSize = sizeof(T);
+        uint16_t reserved = 0;
+        uint32_t bs = blockSize;
+        f.write(Compression::Magic, 4);
+        f.write((const char*) &codec, 1);
+        f.write((const char*) &elemSize, 1);
+        f.write((const char*) &reserved, 2);
+        f.write((const char*) &bs, 4);
+        f.write((const char*) &count, 8);
+        f.write((const char*) &blocks, 4);
+        uint64_t offset = 0;
+        for (uint32_t b = 0; b < blocks; b++) {
+            uint64_t len = encoded[b].size();
+            f.write((const char*) &offset, 8);
+            f.write((const char*) &len, 8);
+            offset += len;
+        }
+        for (uint32_t b = 0; b < blocks; b++) f.write((const char*) encoded[b].data(), encoded[b].size());
+        f.close();
+    }
+    /**
+     * @brief Get number of elements stored in compressed Array file
+     * @tparam T Array Type
+     * @param FileName File Name
+     * @return unsigned Element count
+     */
+    template <class T>
+    unsigned compressedSize (const string &FileName) {
+        ifstream f(FileName, ios::in | ios::binary);
+        if (!f) throw std::invalid_argument("Cannot open file for reading!");
+        return (unsigned) Compression::readIndex<T>(f).count;
+    }
+    /**
+     * @brief Get Array from compressed file
+     * @tparam T Array Type
+     * @param FileName File Name
+     * @return Array<T>
+     */
+    template <class T>
+    Array<T> readCompressed (const string &FileName) {
+        BA_PROFILE_SCOPE("Files::readCompressed");
+        ifstream f(FileName, ios::in | ios::binary);
+        if (!f) throw std::invalid_argument("Cannot open file for reading!");
+        Compression::FileIndex I = Compression::readIndex<T>(f);
+        Array<T> X((unsigned) I.count);
+        if (I.count > 0) Compression::decodeRange(f, I, 0, I.count - 1, X.data());
+        return X;
+    }
+    /**
+     * @brief Get Array slice from compressed file. Only blocks containing the slice are decoded
+     * @tparam T Array Type
+     * @param FileName File Name
+     * @param From Starting Index (Inclusive, negative index supported)
+     * @param To End Index (Inclusive, negative index supported)
+     * @return Array<T> Array Slice
+     */
+    template <class T>
+    Array<T> readCompressed (const string &FileName, int From, int To = ArrayEnd) {
+        BA_PROFILE_SCOPE("Files::readCompressed");
+        ifstream f(FileName, ios::in | ios::binary);
+        if (!f) throw std::invalid_argument("Cannot open file for reading!");
+        Compression::FileIndex I = Compression::readIndex<T>(f);
+        long long n = (long long) I.count;
+        if (To == ArrayEnd && n < ArrayEnd) To = (int) (n - 1);
+        long long from = From < 0 ? From + n : From, to = To < 0 ? To + n : To;
+        if (from < 0 || from >= n || to < 0 || to >= n || from > to) throw std::invalid_argument("Invalid From-To Range");
+        Array<T> X((unsigned) (to - from + 1));
+        Compression::decodeRange(f, I, (uint64_t) from, (uint64_t) to, X.data());
+        return X;
+    }
+}
+#endif // !ARRAY_COMPRESSION_H
@@ -0,0 +1,556 @@
+/**
+ * @file async_files.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Asynchronous Array files for Better Array. Saves and reads run in background and return futures.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17. Uses io_uring on Linux when the kernel allows it, a thread pool otherwise.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef ASYNC_FILES_H
+#define ASYNC_FILES_H
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <set>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include "better_array.h"
+#if defined(__linux__) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #include <linux/io_uring.h>
+        #include <sys/mman.h>
+        #include <sys/stat.h>
+        #include <sys/syscall.h>
+        #include <sys/uio.h>
+        #include <fcntl.h>
+        #include <unistd.h>
+        #include <cerrno>
+        #include <sched.h>
+        #define BA_IO_URING
+    #endif
+#endif
+using namespace std;
+namespace AsyncIO {
+    // Engine running file transfers
+    enum Backend {
+        ASYNC_THREADS = 0,  // Blocking reads and writes on background threads
+        ASYNC_URING = 1     // io_uring submissions, every batch is submitted together
+    };
+    const size_t ChunkBytes = 1 << 20;      // Bytes per single read or write request
+    const unsigned RingEntries = 64;        // Requests in flight per ring
+    const unsigned PoolThreads = 4;         // Upper bound of background threads
+    typedef vector < char, Memory::AlignedAllocator < char > > Buffer;
+    // Stream buffer appending formatted text to Buffer through a small staging area
+    class BufferWriter : public streambuf {
+        private:
+            Buffer &B;
+            char chunk[1 << 14];
+            void flushChunk () {
+                B.insert(B.end(), pbase(), pptr());
+                setp(chunk, chunk + sizeof(chunk));
+            }
+        protected:
+            int_type overflow (int_type c) override {
+                flushChunk();
+                if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                    *pptr() = traits_type::to_char_type(c);
+                    pbump(1);
+                }
+                return traits_type::not_eof(c);
+            }
+            int sync () override {
+                flushChunk();
+                return 0;
+            }
+        public:
+            explicit BufferWriter (Buffer &Out) : B(Out) {setp(chunk, chunk + sizeof(chunk));}
+    };
+    // Stream buffer reading text straight from Buffer
+    class BufferReader : public streambuf {
+        public:
+            BufferReader (char* data, size_t n) {setg(data, data, data + n);}
+    };
+    /**
+     * @brief Format Array the way Files::saveArray() does (one value per line)
+     */
+    template <class T>
+    void format (const Array<T> &Arr, Buffer &Out) {
+        BufferWriter W(Out);
+        ostream os(&W);
+        for (unsigned i = 0; i < Arr.size(); i++) os<<Arr[i]<<'\n';
+        os.flush();
+    }
+    /**
+     * @brief Parse whitespace separated values the way Files::readChunks() does
+     */
+    template <class T>
+    Array<T> parse (Buffer &In) {
+        BufferReader R(In.data(), In.size());
+        istream is(&R);
+        Array<T> X;
+        T val;
+        while (is>>val) X.append(val);
+        return X;
+    }
+    /**
+     * @brief Fixed set of background threads running queued jobs. Jobs naming a common file run one after another
+     * in queue order, other jobs run in parallel. Pending jobs finish before destruction
+     */
+    class Pool {
+        private:
+            struct Job {
+                function<void()> run;
+                vector<string> files;
+            };
+            mutex M;
+            condition_variable CV;
+            deque < Job > Q;
+            set < string > busy;        // Files of running jobs
+            vector < thread > W;
+            bool stop;
+            // Take first job whose files are neither running nor named by an earlier queued job
+            bool take (Job &Out) {
+                set<string> earlier;
+                for (auto it = this->Q.begin(); it != this->Q.end(); ++it) {
+                    bool ready = true;
+                    for (const string &f : it->files) if (this->busy.count(f) || earlier.count(f)) ready = false;
+                    if (ready) {
+                        Out = std::move(*it);
+                        this->Q.erase(it);
+                        this->busy.insert(Out.files.begin(), Out.files.end());
+                        return true;
+                    }
+                    earlier.insert(it->files.begin(), it->files.end());
+                }
+                return false;
+            }
+            void loop () {
+                for (;;) {
+                    Job job;
+                    {
+                        unique_lock<mutex> L(this->M);
+                        while (!take(job)) {
+                            if (this->stop && this->Q.empty()) return;
+                            this->CV.wait(L);
+                        }
+                    }
+                    job.run();
+                    {
+                        lock_guard<mutex> L(this->M);
+                        for (const string &f : job.files) this->busy.erase(f);
+                    }
+                    // Jobs waiting for these files may run now
+                    this->CV.notify_all();
+                }
+            }
+        public:
+            explicit Pool (unsigned n) : stop(false) {
+                for (unsigned i = 0; i < n; i++) this->W.emplace_back([this] () {loop();});
+            }
+            ~Pool () {
+                {
+                    lock_guard<mutex> L(this->M);
+                    this->stop = true;
+                }
+                this->CV.notify_all();
+                for (unsigned i = 0; i < this->W.size(); i++) this->W[i].join();
+            }
+            /**
+             * @brief Queue job
+             * @param job Job
+             * @param files Names of files the job reads or writes
+             */
+            void push (function<void()> job, vector<string> files) {
+                {
+                    lock_guard<mutex> L(this->M);
+                    this->Q.push_back({std::move(job), std::move(files)});
+                }
+                this->CV.notify_one();
+            }
+    };
+    #ifdef BA_IO_URING
+        // Contiguous byte range of one file
+        struct Request {
+            int fd;
+            char* data;
+            size_t length;
+            unsigned long long offset;
+        };
+        /**
+         * @brief Minimal io_uring instance driven through raw syscalls (no liburing needed)
+         */
+        class Ring {
+            private:
+                int fd;
+                unsigned entries;
+                void* sqPtr;
+                void* cqPtr;
+                void* sqePtr;
+                size_t sqLen, cqLen, sqeLen;
+                unsigned *sqHead, *sqTail, *sqMask, *sqArray, *cqHead, *cqTail, *cqMask;
+                io_uring_sqe* sqes;
+                io_uring_cqe* cqes;
+                void release () {
+                    if (this->sqePtr != MAP_FAILED) munmap(this->sqePtr, this->sqeLen);
+                    if (this->cqPtr != MAP_FAILED && this->cqPtr != this->sqPtr) munmap(this->cqPtr, this->cqLen);
+                    if (this->sqPtr != MAP_FAILED) munmap(this->sqPtr, this->sqLen);
+                    if (this->fd >= 0) close(this->fd);
+                    this->fd = -1;
+                }
+                int enter (unsigned toSubmit, unsigned minComplete) {
+                    return (int) syscall(__NR_io_uring_enter, this->fd, toSubmit, minComplete, minComplete > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+                }
+            public:
+                Ring () : fd(-1), entries(0), sqPtr(MAP_FAILED), cqPtr(MAP_FAILED), sqePtr(MAP_FAILED), sqLen(0), cqLen(0), sqeLen(0) {
+                    io_uring_params p;
+                    memset(&p, 0, sizeof(p));
+                    this->fd = (int) syscall(__NR_io_uring_setup, RingEntries, &p);
+                    // Kernels without io_uring (or sandboxes blocking it) use the thread fallback
+                    if (this->fd < 0) return;
+                    this->sqLen = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+                    this->cqLen = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+                    bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                    if (single) this->sqLen = this->cqLen = this->sqLen > this->cqLen ? this->sqLen : this->cqLen;
+                    this->sqPtr = mmap(NULL, this->sqLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQ_RING);
+                    this->cqPtr = single ? this->sqPtr : mmap(NULL, this->cqLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_CQ_RING);
+                    this->sqeLen = p.sq_entries * sizeof(io_uring_sqe);
+                    this->sqePtr = mmap(NULL, this->sqeLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQES);
+                    if (this->sqPtr == MAP_FAILED || this->cqPtr == MAP_FAILED || this->sqePtr == MAP_FAILED) {
+                        release();
+                        return;
+                    }
+                    char* sq = (char*) this->sqPtr;
+                    char* cq = (char*) this->cqPtr;
+                    this->sqHead = (unsigned*) (sq + p.sq_off.head);
+                    this->sqTail = (unsigned*) (sq + p.sq_off.tail);
+                    this->sqMask = (unsigned*) (sq + p.sq_off.ring_mask);
+                    this->sqArray = (unsigned*) (sq + p.sq_off.array);
+                    this->cqHead = (unsigned*) (cq + p.cq_off.head);
+                    this->cqTail = (unsigned*) (cq + p.cq_off.tail);
+                    this->cqMask = (unsigned*) (cq + p.cq_off.ring_mask);
+                    this->cqes = (io_uring_cqe*) (cq + p.cq_off.cqes);
+                    this->sqes = (io_uring_sqe*) this->sqePtr;
+                    this->entries = p.sq_entries;
+                }
+                Ring (const Ring&) = delete;
+                Ring& operator= (const Ring&) = delete;
+                ~Ring () {release();}
+                bool ready () const {return this->fd >= 0;}
+                /**
+                 * @brief Transfer every request, keeping up to RingEntries in flight. Short transfers are resubmitted.
+                 * Errors are thrown once no request is in flight
+                 * @param Q Requests, consumed
+                 * @param write true = write requests, false = read requests
+                 */
+                void run (deque<Request> &Q, bool write) {
+                    vector<iovec> iov(this->entries);
+                    vector<Request> slots(this->entries);
+                    vector<unsigned> freeSlots;
+                    for (unsigned s = 0; s < this->entries; s++) freeSlots.push_back(this->entries - 1 - s);
+                    unsigned inFlight = 0, pending = 0;
+                    int error = 0;
+                    while ((!Q.empty() && error == 0) || inFlight > 0) {
+                        // Queue as many requests as there are free slots, then submit them with one syscall
+                        unsigned tail = *this->sqTail;
+                        while (!Q.empty() && !freeSlots.empty() && error == 0) {
+                            unsigned s = freeSlots.back();
+                            freeSlots.pop_back();
+                            slots[s] = Q.front();
+                            Q.pop_front();
+                            iov[s].iov_base = slots[s].data;
+                            iov[s].iov_len = slots[s].length;
+                            unsigned at = tail & *this->sqMask;
+                            io_uring_sqe &e = this->sqes[at];
+                            memset(&e, 0, sizeof(e));
+                            e.opcode = write ? IORING_OP_WRITEV : IORING_OP_READV;
+                            e.fd = slots[s].fd;
+                            e.addr = (unsigned long long) &iov[s];
+                            e.len = 1;
+                            e.off = slots[s].offset;
+                            e.user_data = s;
+                            this->sqArray[at] = at;
+                            tail++;
+                            pending++;
+                            inFlight++;
+                        }
+                        __atomic_store_n(this->sqTail, tail, __ATOMIC_RELEASE);
+                        int r = enter(pending, 1);
+                        if (r < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                            // Submitted requests still use the buffers, so the error is raised only after they complete.
+                            // Entries the kernel has not taken are withdrawn (the ring is only read inside enter())
+                            if (error == 0) error = errno;
+                            unsigned taken = __atomic_load_n(this->sqHead, __ATOMIC_ACQUIRE);
+                            for (unsigned t = taken; t != tail; t++) freeSlots.push_back((unsigned) this->sqes[this->sqArray[t & *this->sqMask]].user_data);
+                            inFlight -= tail - taken;
+                            pending = 0;
+                            __atomic_store_n(this->sqTail, taken, __ATOMIC_RELEASE);
+                            sched_yield();
+                        }
+                        else if (r > 0) pending -= (unsigned) r < pending ? (unsigned) r : pending;
+                        unsigned head = *this->cqHead;
+                        unsigned last = __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE);
+                        for (; head != last; head++) {
+                            io_uring_cqe &c = this->cqes[head & *this->cqMask];
+                            unsigned s = (unsigned) c.user_data;
+                            int res = c.res;
+                            inFlight--;
+                            freeSlots.push_back(s);
+                            Request &R = slots[s];
+                            if (res < 0 || (res == 0 && R.length > 0)) {
+                                error = res < 0 ? -res : EIO;
+                                continue;
+                            }
+                            if ((size_t) res < R.length) Q.push_back({R.fd, R.data + res, R.length - res, R.offset + res});
+                        }
+                        __atomic_store_n(this->cqHead, head, __ATOMIC_RELEASE);
+                    }
+                    if (error != 0) throw std::invalid_argument(write ? "Asynchronous write failed!" : "Asynchronous read failed!");
+                }
+        };
+        // Split byte range into ChunkBytes requests
+        inline void addRequests (deque<Request> &Q, int fd, char* data, size_t length, unsigned long long offset) {
+            for (size_t done = 0; done < length; done += ChunkBytes) {
+                size_t n = length - done < ChunkBytes ? length - done : ChunkBytes;
+                Q.push_back({fd, data + done, n, offset + done});
+            }
+        }
+    #endif // BA_IO_URING
+    // Ring shared by all jobs and the thread pool running them. Pool is declared last, so pending jobs finish before the ring closes
+    class Engine {
+        public:
+            #ifdef BA_IO_URING
+                Ring R;
+                mutex ringLock;
+            #endif // BA_IO_URING
+            Backend mode;
+            Pool P;
+            Engine () : mode(ASYNC_THREADS), P(Parallel::threads() < PoolThreads ? Parallel::threads() : PoolThreads) {
+                #ifdef BA_IO_URING
+                    const char* env = getenv("BETTER_ARRAY_ASYNC");
+                    if (this->R.ready() && !(env && string(env) == "threads")) this->mode = ASYNC_URING;
+                #endif // BA_IO_URING
+            }
+    };
+    inline Engine& engine () {
+        static Engine E;
+        return E;
+    }
+    /**
+     * @brief Get backend used by asynchronous file functions
+     * @return Backend ASYNC_URING when io_uring is available (unless BETTER_ARRAY_ASYNC=threads), ASYNC_THREADS otherwise
+     */
+    inline Backend backend () {return engine().mode;}
+    /**
+     * @brief Choose backend. ASYNC_URING is ignored when io_uring is not available
+     * @param B Backend
+     */
+    inline void setBackend (Backend B) {
+        #ifdef BA_IO_URING
+            if (B == ASYNC_URING && !engine().R.ready()) return;
+        #else
+            if (B == ASYNC_URING) return;
+        #endif // BA_IO_URING
+        engine().mode = B;
+    }
+    inline const char* backendName (Backend B) {return B == ASYNC_URING ? "io_uring" : "threads";}
+    // One file of a batch
+    struct WriteJob {
+        string name;
+        bool append;
+        function<void(Buffer&)> fill;
+        Buffer data;
+    };
+    // Write formatted files, with io_uring all of them go through one submission loop
+    inline void writeFiles (vector<WriteJob> &Jobs) {
+        #ifdef BA_IO_URING
+            if (backend() == ASYNC_URING) {
+                vector<int> fds;
+                map<string, pair<int, unsigned long long>> files;
+                deque<Request> Q;
+                try {
+                    for (unsigned j = 0; j < Jobs.size(); j++) {
+                        auto it = files.find(Jobs[j].name);
+                        if (it == files.end()) {
+                            int fd = ::open(Jobs[j].name.c_str(), O_WRONLY | O_CREAT | (Jobs[j].append ? 0 : O_TRUNC), 0644);
+                            if (fd < 0) throw std::invalid_argument("Cannot open file for writing!");
+                            fds.push_back(fd);
+                            off_t end = Jobs[j].append ? lseek(fd, 0, SEEK_END) : 0;
+                            it = files.insert({Jobs[j].name, {fd, (unsigned long long) (end < 0 ? 0 : end)}}).first;
+                        }
+                        // Later appends to the same file continue where the previous job of the batch ends
+                        addRequests(Q, it->second.first, Jobs[j].data.data(), Jobs[j].data.size(), it->second.second);
+                        it->second.second += Jobs[j].data.size();
+                    }
+                    lock_guard<mutex> L(engine().ringLock);
+                    engine().R.run(Q, true);
+                }
+                catch (...) {
+                    for (unsigned i = 0; i < fds.size(); i++) close(fds[i]);
+                    throw;
+                }
+                for (unsigned i = 0; i < fds.size(); i++) close(fds[i]);
+                return;
+            }
+        #endif // BA_IO_URING
+        for (unsigned j = 0; j < Jobs.size(); j++) {
+            ofstream f(Jobs[j].name, ios::out | ios::binary | (Jobs[j].append ? ios::app : ios::trunc));
+            if (!f) throw std::invalid_argument("Cannot open file for writing!");
+            f.write(Jobs[j].data.data(), Jobs[j].data.size());
+            if (!f) throw std::invalid_argument("Asynchronous write failed!");
+        }
+    }
+    // Load whole file into aligned buffer
+    inline Buffer readFile (const string &FileName) {
+        Buffer B;
+        #ifdef BA_IO_URING
+            if (backend() == ASYNC_URING) {
+                int fd = ::open(FileName.c_str(), O_RDONLY);
+                if (fd < 0) throw std::invalid_argument("Cannot open file for reading!");
+                try {
+                    struct stat st;
+                    if (fstat(fd, &st) != 0) throw std::invalid_argument("Cannot open file for reading!");
+                    B.resize((size_t) st.st_size);
+                    deque<Request> Q;
+                    addRequests(Q, fd, B.data(), B.size(), 0);
+                    lock_guard<mutex> L(engine().ringLock);
+                    engine().R.run(Q, false);
+                }
+                catch (...) {
+                    close(fd);
+                    throw;
+                }
+                close(fd);
+                return B;
+            }
+        #endif // BA_IO_URING
+        ifstream f(FileName, ios::in | ios::binary | ios::ate);
+        if (!f) throw std::invalid_argument("Cannot open file for reading!");
+        B.resize((size_t) f.tellg());
+        f.seekg(0);
+        f.read(B.data(), B.size());
+        if (!f) throw std::invalid_argument("Asynchronous read failed!");
+        return B;
+    }
+    /**
+     * @brief Group of saves written by a single background job (one io_uring submission loop)
+     *
+     * Arrays are copied when added (moved when passed as temporaries), so they may change right after.
+     */
+    class Batch {
+        private:
+            vector<WriteJob> Jobs;
+            void add (const string &FileName, bool append, function<void(Buffer&)> fill) {
+                for (unsigned j = 0; j < this->Jobs.size(); j++) {
+                    if (this->Jobs[j].name == FileName && !append) throw std::invalid_argument("File is already saved in this batch!");
+                }
+                this->Jobs.push_back({FileName, append, std::move(fill), Buffer()});
+            }
+        public:
+            /**
+             * @brief Add save of Array (same format as Files::saveArray())
+             * @param Arr Array
+             * @param FileName File Name
+             */
+            template <class T>
+            void save (Array<T> Arr, const string &FileName) {
+                add(FileName, false, [A = std::move(Arr)] (Buffer &Out) {format(A, Out);});
+            }
+            /**
+             * @brief Add append of Array (same format as Files::appendArray())
+             * @param Arr Array
+             * @param FileName File Name
+             */
+            template <class T>
+            void append (Array<T> Arr, const string &FileName) {
+                add(FileName, true, [A = std::move(Arr)] (Buffer &Out) {format(A, Out);});
+            }
+            /**
+             * @brief Get number of queued files
+             * @return unsigned
+             */
+            unsigned size () const {return this->Jobs.size();}
+            /**
+             * @brief Format and write every queued file in background, after earlier saves, appends and reads
+             * of the same files. Batch is empty afterwards
+             * @return future<void> Ready when all files are written, rethrows the first error
+             */
+            future<void> submit () {
+                shared_ptr<vector<WriteJob>> Jobs = make_shared<vector<WriteJob>>(std::move(this->Jobs));
+                this->Jobs.clear();
+                vector<string> files;
+                for (const WriteJob &J : *Jobs) files.push_back(J.name);
+                shared_ptr<promise<void>> P = make_shared<promise<void>>();
+                future<void> F = P->get_future();
+                engine().P.push([Jobs, P] () {
+                    BA_PROFILE_SCOPE("AsyncIO::Batch");
+                    try {
+                        Parallel::forChunks(Jobs->size(), Parallel::chunks(Jobs->size(), 1), [&] (unsigned, unsigned long long b, unsigned long long e) {
+                            for (unsigned long long j = b; j < e; j++) (*Jobs)[j].fill((*Jobs)[j].data);
+                        });
+                        writeFiles(*Jobs);
+                        P->set_value();
+                    }
+                    catch (...) {P->set_exception(current_exception());}
+                }, std::move(files));
+                return F;
+            }
+    };
+}
+namespace Files {
+    /**
+     * @brief Save Array to a file in background (same format as saveArray())
+     * @tparam T Any
+     * @param Arr Array, copied before returning
+     * @param FileName File Name
+     * @return future<void> Ready when the file is written
+     */
+    template <class T>
+    future<void> saveArrayAsync (Array<T> Arr, const string &FileName) {
+        AsyncIO::Batch B;
+        B.save(std::move(Arr), FileName);
+        return B.submit();
+    }
+    /**
+     * @brief Append Array to a file in background (same format as appendArray())
+     * @tparam T Any
+     * @param Arr Array, copied before returning
+     * @param FileName File Name
+     * @return future<void> Ready when the values are written
+     */
+    template <class T>
+    future<void> appendArrayAsync (Array<T> Arr, const string &FileName) {
+        AsyncIO::Batch B;
+        B.append(std::move(Arr), FileName);
+        return B.submit();
+    }
+    /**
+     * @brief Read Array from file written by saveArray() in background
+     * @tparam T Array Type
+     * @param FileName File Name
+     * @return future<Array<T>> Ready with the values once the file is read and parsed
+     */
+    template <class T>
+    future<Array<T>> readArrayAsync (const string &FileName) {
+        shared_ptr<promise<Array<T>>> P = make_shared<promise<Array<T>>>();
+        future<Array<T>> F = P->get_future();
+        AsyncIO::engine().P.push([FileName, P] () {
+            BA_PROFILE_SCOPE("Files::readArrayAsync");
+            try {
+                AsyncIO::Buffer B = AsyncIO::readFile(FileName);
+                P->set_value(AsyncIO::parse<T>(B));
+            }
+            catch (...) {P->set_exception(current_exception());}
+        }, {FileName});
+        return F;
+    }
+}
+#endif // !ASYNC_FILES_H
@@ -0,0 +1,299 @@
+/**
+ * @file batched_array.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Batched Arrays for Better Array. Many small Arrays stored as segments of one flat buffer.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef BATCHED_ARRAY_H
+#define BATCHED_ARRAY_H
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "better_array.h"
+using namespace std;
+/**
+ * @brief Ragged batch of Arrays: values of all segments back to back in one buffer and segment offsets
+ *
+ * Segment i holds values V[O[i]] .. V[O[i + 1] - 1]. Methods run over every segment in one parallel pass
+ * through the flat buffer and return one result per segment, so a batch of millions of short Arrays
+ * costs two allocations instead of one per Array and bounds are checked once per call.
+ * @tparam T Type of values
+ */
+template <class T>
+class BatchedArray {
+    private:
+        static constexpr bool kernelType = Simd::isKernelType<T>::value;
+        Array < T > V;              // Values of all segments
+        Array < unsigned > O;       // Segment offsets, size() + 1 values, O[0] = 0
+        void SegmentError (unsigned i) const {
+            if (i >= this->size()) throw std::invalid_argument("Segment Index out of range!");
+        }
+        void EmptyError () const {
+            const unsigned* o = this->O.data();
+            for (unsigned i = 0; i < this->size(); i++) if (o[i] == o[i + 1]) throw std::invalid_argument("Segments must not be empty!");
+        }
+        // Run f(begin, end) on ranges of segments split between threads
+        template <class F>
+        void ForSegments (F f) const {
+            Parallel::forChunks(this->size(), Parallel::chunks(this->V.size(), 1u << 16), [&] (unsigned, unsigned long long b, unsigned long long e) {f(b, e);});
+        }
+        // Extreme of segments [b, e) into out[0] ... out[e - b - 1]
+        template <bool Largest>
+        void Extremes (unsigned long long b, unsigned long long e, T* out) const {
+            const T* v = this->V.data();
+            const unsigned* o = this->O.data();
+            if constexpr (kernelType) Simd::segmentExtreme<Largest>(v, o + b, e - b, out);
+            else {
+                for (unsigned long long i = b; i < e; i++) {
+                    T M = v[o[i]];
+                    for (unsigned j = o[i] + 1; j < o[i + 1]; j++) if (Largest ? v[j] > M : v[j] < M) M = v[j];
+                    out[i - b] = M;
+                }
+            }
+        }
+        template <bool Largest>
+        Array<int> ArgExtremes () const {
+            EmptyError();
+            Array<int> X(this->size());
+            int* out = X.data();
+            const T* v = this->V.data();
+            const unsigned* o = this->O.data();
+            ForSegments([&] (unsigned long long b, unsigned long long e) {
+                vector<T> M(e - b);
+                this->Extremes<Largest>(b, e, M.data());
+                for (unsigned long long i = b; i < e; i++) {
+                    // Extreme is known, so the scan stops at its first occurrence
+                    unsigned j = o[i], end = o[i + 1];
+                    while (j < end && !(v[j] == M[i - b])) j++;
+                    // Extreme is NaN only when the segment starts with NaN (NaN never equals itself), so index 0 is the fallback
+                    out[i] = j < end ? (int) (j - o[i]) : 0;
+                }
+            });
+            return X;
+        }
+    public:
+        /**
+         * @brief Create empty batch
+         */
+        BatchedArray () : O(1u) {}
+        /**
+         * @brief Create batch from Arrays
+         * @param Arrays Segments
+         */
+        explicit BatchedArray (const Array<Array<T>> &Arrays) : O(Arrays.size() + 1) {
+            const Array<T>* a = Arrays.data();
+            unsigned* o = this->O.data();
+            unsigned long long total = 0;
+            for (unsigned i = 0; i < Arrays.size(); i++) {
+                o[i] = (unsigned) total;
+                total += a[i].size();
+            }
+            if (total > 0xFFFFFFFFull) throw std::invalid_argument("Batch is too large!");
+            o[Arrays.size()] = (unsigned) total;
+            this->V = Array<T>((unsigned) total);
+            T* v = this->V.data();
+            for (unsigned i = 0; i < Arrays.size(); i++) copy(a[i].data(), a[i].data() + a[i].size(), v + o[i]);
+        }
+        /**
+         * @brief Create batch from flat values and segment lengths
+         * @param Values Values of all segments, back to back
+         * @param Lengths Length of every segment
+         */
+        explicit BatchedArray (const Array<T> &Values, const Array<unsigned> &Lengths) : V(Values), O(Lengths.size() + 1) {
+            unsigned* o = this->O.data();
+            unsigned long long total = 0;
+            for (unsigned i = 0; i < Lengths.size(); i++) {
+                o[i] = (unsigned) total;
+                total += Lengths[i];
+                if (total > Values.size()) break;
+            }
+            if (total != Values.size()) throw std::invalid_argument("Lengths must sum to Values length!");
+            o[Lengths.size()] = (unsigned) total;
+        }
+        /**
+         * @brief Convert to Array of Arrays
+         * @return Array<Array<T>>
+         */
+        Array<Array<T>> toArrays () const {
+            BA_PROFILE_SCOPE("BatchedArray::toArrays");
+            Array<Array<T>> X(this->size());
+            Array<T>* x = X.data();
+            const T* v = this->V.data();
+            const unsigned* o = this->O.data();
+            for (unsigned i = 0; i < this->size(); i++) {
+                x[i] = Array<T>(o[i + 1] - o[i]);
+                copy(v + o[i], v + o[i + 1], x[i].data());
+            }
+            return X;
+        }
+        /**
+         * @brief Get number of segments
+         */
+        unsigned size () const {return this->O.size() - 1;}
+        /**
+         * @brief Get number of values in all segments
+         */
+        unsigned fullSize () const {return this->V.size();}
+        /**
+         * @brief Get length of segment
+         * @param i Segment Index
+         */
+        unsigned length (unsigned i) const {
+            SegmentError(i);
+            return this->O[i + 1] - this->O[i];
+        }
+        /**
+         * @brief Get length of every segment
+         * @return Array<unsigned>
+         */
+        Array<unsigned> lengths () const {
+            Array<unsigned> X(this->size());
+            for (unsigned i = 0; i < this->size(); i++) X[i] = this->O[i + 1] - this->O[i];
+            return X;
+        }
+        /**
+         * @brief Get values of all segments, back to back
+         */
+        const Array<T>& values () const {return this->V;}
+        /**
+         * @brief Get segment offsets (size() + 1 values, segment i starts at offsets()[i])
+         */
+        const Array<unsigned>& offsets () const {return this->O;}
+        /**
+         * @brief Get copy of segment
+         * @param i Segment Index
+         * @return Array<T>
+         */
+        Array<T> segment (unsigned i) const {
+            SegmentError(i);
+            Array<T> X(this->O[i + 1] - this->O[i]);
+            copy(this->V.data() + this->O[i], this->V.data() + this->O[i + 1], X.data());
+            return X;
+        }
+        Array<T> operator[] (unsigned i) const {return this->segment(i);}
+        /**
+         * @brief Append segment at the end of batch
+         * @param Values Segment values
+         */
+        void append (const Array<T> &Values) {
+            if ((unsigned long long) this->V.size() + Values.size() > 0xFFFFFFFFull) throw std::invalid_argument("Batch is too large!");
+            for (unsigned i = 0; i < Values.size(); i++) this->V.append(Values[i]);
+            this->O.append(this->V.size());
+        }
+        /**
+         * @brief Get maximum value of every segment
+         * @return Array<T>
+         */
+        Array<T> max () const {
+            BA_PROFILE_SCOPE("BatchedArray::max");
+            EmptyError();
+            Array<T> X(this->size());
+            ForSegments([&] (unsigned long long b, unsigned long long e) {this->Extremes<true>(b, e, X.data() + b);});
+            return X;
+        }
+        /**
+         * @brief Get minimum value of every segment
+         * @return Array<T>
+         */
+        Array<T> min () const {
+            BA_PROFILE_SCOPE("BatchedArray::min");
+            EmptyError();
+            Array<T> X(this->size());
+            ForSegments([&] (unsigned long long b, unsigned long long e) {this->Extremes<false>(b, e, X.data() + b);});
+            return X;
+        }
+        /**
+         * @brief Get index of first maximum value in every segment (relative to segment start)
+         * @return Array<int>
+         */
+        Array<int> argmax () const {
+            BA_PROFILE_SCOPE("BatchedArray::argmax");
+            return ArgExtremes<true>();
+        }
+        /**
+         * @brief Get index of first minimum value in every segment (relative to segment start)
+         * @return Array<int>
+         */
+        Array<int> argmin () const {
+            BA_PROFILE_SCOPE("BatchedArray::argmin");
+            return ArgExtremes<false>();
+        }
+        /**
+         * @brief Get sum of every segment (empty segments sum to T())
+         * @return Array<T>
+         */
+        Array<T> sum () const {
+            BA_PROFILE_SCOPE("BatchedArray::sum");
+            Array<T> X(this->size());
+            T* out = X.data();
+            const T* v = this->V.data();
+            const unsigned* o = this->O.data();
+            ForSegments([&] (unsigned long long b, unsigned long long e) {
+                for (unsigned long long i = b; i < e; i++) {
+                    T S = T();
+                    for (unsigned j = o[i]; j < o[i + 1]; j++) S += v[j];
+                    out[i] = S;
+                }
+            });
+            return X;
+        }
+        /**
+         * @brief Get average of every segment
+         * @return Array<double>
+         */
+        Array<double> mean () const {
+            BA_PROFILE_SCOPE("BatchedArray::mean");
+            EmptyError();
+            Array<double> X(this->size());
+            double* out = X.data();
+            const T* v = this->V.data();
+            const unsigned* o = this->O.data();
+            ForSegments([&] (unsigned long long b, unsigned long long e) {
+                if constexpr (kernelType) Simd::segmentSum(v, o + b, e - b, out + b);
+                else {
+                    for (unsigned long long i = b; i < e; i++) {
+                        out[i] = 0.0;
+                        for (unsigned j = o[i]; j < o[i + 1]; j++) out[i] += (double) v[j];
+                    }
+                }
+                for (unsigned long long i = b; i < e; i++) out[i] /= (double) (o[i + 1] - o[i]);
+            });
+            return X;
+        }
+        /**
+         * @brief Sort every segment, segments keep their positions and lengths
+         * @param SOrder ASCending = 1, DESCending = -1. Default ASC
+         */
+        void sort (Order SOrder = ASC) {
+            BA_PROFILE_SCOPE("BatchedArray::sort");
+            T* v = this->V.data();
+            const unsigned* o = this->O.data();
+            Parallel::forChunks(this->size(), Parallel::chunks(this->V.size(), 1u << 14), [&] (unsigned, unsigned long long b, unsigned long long e) {
+                for (unsigned long long i = b; i < e; i++) {
+                    if (SOrder == DESC) std::sort(v + o[i], v + o[i + 1], greater<T>());
+                    else std::sort(v + o[i], v + o[i + 1]);
+                }
+            });
+        }
+        /**
+         * @brief Get sorted copy of batch
+         * @param SOrder ASCending = 1, DESCending = -1. Default ASC
+         * @return BatchedArray<T>
+         */
+        BatchedArray<T> sorted (Order SOrder = ASC) const {
+            BatchedArray<T> X = *this;
+            X.sort(SOrder);
+            return X;
+        }
+        bool operator== (const BatchedArray<T> &Other) const {
+            if (this->O.size() != Other.O.size() || this->V.size() != Other.V.size()) return false;
+            return equal(this->O.data(), this->O.data() + this->O.size(), Other.O.data()) && equal(this->V.data(), this->V.data() + this->V.size(), Other.V.data());
+        }
+        bool operator!= (const BatchedArray<T> &Other) const {return !(*this == Other);}
+};
+#endif // !BATCHED_ARRAY_H
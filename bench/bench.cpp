@@ -0,0 +1,318 @@
+/**
+ * @file bench.cpp
+ * @author DingoMC (www.dingomc.net)
+ * @brief Benchmark suite for better_array.h and ndarray.h. Results are written as JSON.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @note Usage: bench [--out results.json] [--min-size N] [--max-size N] [--min-time seconds] [--filter text]
+ *       Compare against a stored baseline with bench/compare.py baseline.json results.json
+ *       Set BETTER_ARRAY_SIMD=scalar|sse2|avx2|avx512 to measure a lower kernel level
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <cstdio>
+#include <cstdlib>
+#include "better_array.h"
+#include "ndarray.h"
+#include "array_compression.h"
+#include "table.h"
+#include "groupby.h"
+#include "join.h"
+#include "sparse_ndarray.h"
+#include "mapped_ndarray.h"
+#include "async_files.h"
+#include "convolution.h"
+#include "fft.h"
+#include "batched_array.h"
+using namespace std;
+// Benchmark settings
+struct Settings {
+    unsigned long long minSize = 100;
+    unsigned long long maxSize = 100000000;
+    double minTime = 0.1;
+    string filter = "";
+    string out = "bench_results.json";
+};
+// Single benchmark result
+struct Result {
+    string name, type;
+    unsigned long long size, iterations;
+    double nsPerOp, nsMin;
+};
+Settings settings;
+vector<Result> results;
+// Largest size any case of given type may use (keeps memory bounded for strings)
+template <class T> unsigned long long typeLimit () {return 100000000ull;}
+template <> unsigned long long typeLimit<string> () {return 1000000ull;}
+template <class T> string typeName ();
+template <> string typeName<int> () {return "int";}
+template <> string typeName<float> () {return "float";}
+template <> string typeName<double> () {return "double";}
+template <> string typeName<string> () {return "string";}
+template <class T> T makeValue (unsigned long long v) {return (T) v;}
+template <> string makeValue<string> (unsigned long long v) {return "id_" + to_string(v);}
+template <class T>
+Array<T> makeArray (unsigned long long n, unsigned seed) {
+    mt19937_64 rng(seed);
+    Array<T> X((unsigned) n);
+    T* d = X.data();
+    for (unsigned long long i = 0; i < n; i++) d[i] = makeValue<T>(rng() % (n + 1));
+    return X;
+}
+// O(n^2) DFT with precomputed roots of unity, reference for the fft cases
+Array<complex<double>> naiveDFT (const Array<complex<double>> &X) {
+    size_t n = X.size();
+    vector<complex<double>> W(n);
+    for (size_t k = 0; k < n; k++) W[k] = polar(1.0, -2.0 * FFT::Pi * (double) k / (double) n);
+    Array<complex<double>> Y((unsigned) n);
+    const complex<double>* x = X.data();
+    complex<double>* y = Y.data();
+    for (size_t k = 0; k < n; k++) {
+        complex<double> s;
+        for (size_t j = 0, e = 0; j < n; j++, e = (e + k) % n) s += x[j] * W[e];
+        y[k] = s;
+    }
+    return Y;
+}
+bool isPrime (unsigned long long n) {
+    if (n < 2) return false;
+    for (unsigned long long d = 2; d * d <= n; d++) if (n % d == 0) return false;
+    return true;
+}
+/**
+ * @brief Time run() until settings.minTime elapsed, calling untimed setup() before each iteration
+ */
+void measure (const string &name, const string &type, unsigned long long n, const function<void()> &setup, const function<void()> &run) {
+    if (!settings.filter.empty() && name.find(settings.filter) == string::npos) return;
+    typedef chrono::steady_clock Clock;
+    double total = 0.0, best = 0.0;
+    unsigned long long iterations = 0;
+    while (total < settings.minTime || iterations == 0) {
+        setup();
+        Clock::time_point t0 = Clock::now();
+        run();
+        double ns = chrono::duration<double, nano>(Clock::now() - t0).count();
+        if (iterations == 0 || ns < best) best = ns;
+        total += ns * 1e-9;
+        iterations++;
+    }
+    Result R = {name, type, n, iterations, total * 1e9 / iterations, best};
+    results.push_back(R);
+    cerr<<name<<" <"<<type<<"> n="<<n<<": "<<R.nsPerOp<<" ns/op ("<<iterations<<" iterations)"<<endl;
+}
+void noSetup () {}
+// Volatile sink preventing the optimizer from removing measured work
+volatile unsigned long long sink;
+template <class T>
+void benchArray (unsigned long long n) {
+    const string type = typeName<T>();
+    Array<T> A = makeArray<T>(n, 1), B = makeArray<T>(n, 2), W;
+    T pivot = A[(int) (n / 2)];
+    ArrayMask M = A < pivot;
+    // O(n^2) methods are kept to small sizes
+    if (n <= 10000) {
+        measure("sort", type, n, [&] () {W = A;}, [&] () {W.sort();});
+        measure("unique", type, n, noSetup, [&] () {sink = A.unique().size();});
+    }
+    measure("find", type, n, noSetup, [&] () {sink = A.find(makeValue<T>(n + 1));});
+    measure("findAll", type, n, noSetup, [&] () {sink = A.findAll(pivot).size();});
+    measure("mask", type, n, noSetup, [&] () {sink = (A < pivot).size();});
+    measure("masked", type, n, noSetup, [&] () {sink = A.masked(M).size();});
+    measure("slice", type, n, noSetup, [&] () {sink = A.slice((int) (n / 4), (int) (3 * n / 4)).size();});
+    measure("join_inner", type, n, noSetup, [&] () {sink = joinIndices(A, B).left.size();});
+    measure("set_intersection", type, n, noSetup, [&] () {sink = A.setIntersection(B).size();});
+    measure("isin", type, n, noSetup, [&] () {sink = A.isin(B).size();});
+    Array<int> Random = makeArray<int>(n, 3) % (int) n;
+    measure("take_random", type, n, noSetup, [&] () {sink = A.take(Random).size();});
+    measure("put_random", type, n, [&] () {W = A;}, [&] () {W.put(Random, B);});
+    measure("insert_erase", type, n, noSetup, [&] () {
+        A.insert((int) (n / 2), pivot);
+        A.erase((int) (n / 2));
+    });
+    if constexpr (!is_same<T, string>::value) {
+        measure("add_array", type, n, noSetup, [&] () {sink = (A + B).size();});
+        measure("mul_scalar", type, n, noSetup, [&] () {sink = (A * pivot).size();});
+        measure("add_assign_array", type, n, [&] () {W = A;}, [&] () {W += B;});
+        measure("max", type, n, noSetup, [&] () {sink = (unsigned long long) A.max();});
+        measure("mean", type, n, noSetup, [&] () {sink = (unsigned long long) A.mean();});
+        measure("chain_masked_mul_mean", type, n, noSetup, [&] () {sink = (unsigned long long) (A.masked(A < pivot) * (T) 2).mean();});
+        measure("lazy_filter_map_mean", type, n, noSetup, [&] () {
+            sink = (unsigned long long) A.lazy().filter([pivot] (const T& v) {return v < pivot;}).map([] (const T& v) {return v * (T) 2;}).mean();
+        });
+        measure("lazy_parallel_sum", type, n, noSetup, [&] () {sink = (unsigned long long) A.lazy().parallel().sum();});
+        measure("median", type, n, noSetup, [&] () {sink = (unsigned long long) A.median();});
+        measure("topk_10", type, n, noSetup, [&] () {sink = A.argtopk(10).size();});
+        measure("var", type, n, noSetup, [&] () {sink = (unsigned long long) A.var();});
+        measure("histogram", type, n, noSetup, [&] () {sink = A.histogram(64, 0.0, (double) n).size();});
+        measure("describe", type, n, noSetup, [&] () {sink = A.describe().count;});
+        measure("cumsum", type, n, noSetup, [&] () {sink = A.cumsum().size();});
+        measure("rolling_mean", type, n, noSetup, [&] () {sink = A.rolling(64).mean().size();});
+        measure("rolling_max", type, n, noSetup, [&] () {sink = A.rolling(64).max().size();});
+        measure("groupby_sum", type, n, noSetup, [&] () {sink = groupby(A, B).sum().keys.size();});
+        measure("groupby_sort_sum", type, n, noSetup, [&] () {sink = groupby(A, B, GROUP_SORT).sum().keys.size();});
+        // 0/1 taps keep integer sums in range
+        Array<T> Taps(257u);
+        for (unsigned i = 0; i < Taps.size(); i++) Taps[i] = makeValue<T>(i % 2);
+        measure("convolve_k5", type, n, noSetup, [&] () {sink = convolve(A, Taps.slice(0, 4)).size();});
+        if constexpr (is_floating_point<T>::value) measure("convolve_k257_fft", type, n, noSetup, [&] () {sink = convolve(A, Taps, CONVOLVE_FULL, CONVOLVE_FFT).size();});
+        if (n <= 10000000) {
+            // Segments of 10 to 100 values, the same reductions per Array object and over one batch
+            Array<Array<T>> Segments;
+            for (unsigned long long at = 0, len = 10; at + len <= n; at += len, len = 10 + (len * 7919 + at) % 91) Segments.append(A.slice((int) at, (int) (at + len - 1)));
+            BatchedArray<T> Batch(Segments);
+            measure("arrays_max", type, n, noSetup, [&] () {
+                for (unsigned i = 0; i < Segments.size(); i++) sink += (unsigned long long) Segments[i].max();
+            });
+            measure("batched_max", type, n, noSetup, [&] () {sink = Batch.max().size();});
+            measure("batched_mean", type, n, noSetup, [&] () {sink = Batch.mean().size();});
+            measure("batched_argmax", type, n, noSetup, [&] () {sink = Batch.argmax().size();});
+            BatchedArray<T> Sorted;
+            measure("batched_sort", type, n, [&] () {Sorted = Batch;}, [&] () {Sorted.sort();});
+            measure("batched_from_arrays", type, n, noSetup, [&] () {sink = BatchedArray<T>(Segments).size();});
+        }
+        if constexpr (is_same<T, double>::value) {
+            // Powers of ten run as radix 4, 2 and 5 stages, primes through Bluestein
+            unsigned long long prime = n + 1;
+            while (!isPrime(prime)) prime++;
+            Array<complex<double>> Signal((unsigned) n), Prime((unsigned) prime);
+            for (unsigned long long i = 0; i < n; i++) Signal.data()[i] = complex<double>(A.data()[i], B.data()[i]);
+            // Plans are built once per length, outside timed runs
+            sink = fft(Signal).size() + fft(Prime).size() + rfft(A).size();
+            measure("fft", type, n, noSetup, [&] () {sink = fft(Signal).size();});
+            measure("fft_bluestein", type, n, noSetup, [&] () {sink = fft(Prime).size();});
+            measure("rfft", type, n, noSetup, [&] () {sink = rfft(A).size();});
+            if (n <= 10000) measure("dft_naive", type, n, noSetup, [&] () {sink = naiveDFT(Signal).size();});
+        }
+        if (n <= 1000000) {
+            Table<T, T, int> Tab(A, B, Array<int>((unsigned) n));
+            measure("table_masked", type, n, noSetup, [&] () {sink = Tab.masked(Tab.template column<0>() < pivot).size();});
+            measure("table_sort_by", type, n, noSetup, [&] () {sink = Tab.template argsortBy<1>().size();});
+        }
+    }
+    if (n <= 1000000) {
+        const string file = "bench_array_" + type + ".txt";
+        measure("files_save", type, n, noSetup, [&] () {Files::saveArray(A, file);});
+        measure("files_read", type, n, noSetup, [&] () {sink = Files::readArray<T>(file).size();});
+        measure("files_save_async", type, n, noSetup, [&] () {Files::saveArrayAsync(A, file).get();});
+        measure("files_read_async", type, n, noSetup, [&] () {sink = Files::readArrayAsync<T>(file).get().size();});
+        remove(file.c_str());
+    }
+    if (n <= 10000000) {
+        const string file = "bench_array_" + type + ".baz";
+        measure("files_save_compressed", type, n, noSetup, [&] () {Files::saveCompressed(A, file);});
+        measure("files_read_compressed", type, n, noSetup, [&] () {sink = Files::readCompressed<T>(file).size();});
+        measure("files_read_compressed_slice", type, n, noSetup, [&] () {sink = Files::readCompressed<T>(file, (int) (n / 2), (int) (n / 2 + n / 100)).size();});
+        remove(file.c_str());
+    }
+}
+template <class T>
+void benchNDArray (unsigned long long n) {
+    const string type = typeName<T>();
+    // NDArray methods index every element through Idx(), so they are kept to moderate sizes
+    if (n > 1000000) return;
+    unsigned side = 1;
+    while ((unsigned long long) (side + 1) * (side + 1) <= n) side++;
+    NDArray<T> A(2, {side, side});
+    T value = makeValue<T>(7);
+    measure("nd_fill", type, n, noSetup, [&] () {A.fill(value);});
+    measure("nd_apply", type, n, noSetup, [&] () {A.apply([] (const T& v) {return v + v;});});
+    if constexpr (!is_same<T, string>::value) {
+        measure("nd_map", type, n, noSetup, [&] () {sink = A.map([] (const T& v) {return (double) v * 0.5;}).fullSize();});
+        measure("nd_generate", type, n, noSetup, [&] () {A.generate([] (const Array<int> &I) {return (T) (I[0] + I[1]);});});
+    }
+    measure("nd_fill_pattern", type, n, noSetup, [&] () {A.fill({makeValue<T>(1), makeValue<T>(2), makeValue<T>(3)}, 1);});
+    measure("nd_slice_axis0", type, n, noSetup, [&] () {sink = A.slice(0, side / 2, 0).fullSize();});
+    measure("nd_slice_axis1", type, n, noSetup, [&] () {sink = A.slice(0, side / 2, 1).fullSize();});
+    measure("nd_format", type, n, noSetup, [&] () {sink = A.format().size();});
+    NDArray<T> Row(2, {1, side}), W;
+    Row.fill(value);
+    measure("nd_append", type, n, [&] () {W = A;}, [&] () {W.append(Row, 0);});
+    if constexpr (!is_same<T, string>::value) {
+        // 1% of elements stored, product with a dense matrix of 16 columns
+        NDArray<T> Dense(2, {side, side}), Right(2, {side, 16});
+        Array<T> Values = makeArray<T>(n, 4);
+        for (unsigned i = 0; i < side; i++) {
+            for (unsigned j = 0; j < side; j++) if ((i * 7919u + j * 104729u) % 100 == 0) Dense[{(int) i, (int) j}] = Values[(int) (i * side + j)] + (T) 1;
+        }
+        Right.fill(value);
+        SparseNDArray<T> Sparse(Dense);
+        measure("sparse_from_dense", type, n, noSetup, [&] () {sink = SparseNDArray<T>(Dense).nnz();});
+        measure("sparse_sum_axis0", type, n, noSetup, [&] () {sink = Sparse.sum(0).fullSize();});
+        measure("sparse_matmul", type, n, noSetup, [&] () {sink = Sparse.matmul(Right).fullSize();});
+        const string file = "bench_ndarray_" + type + ".band";
+        Files::saveMapped(A, file);
+        measure("mapped_open", type, n, noSetup, [&] () {sink = Files::mapNDArray<T>(file).fullSize();});
+        MappedNDArray<T> Mapped = Files::mapNDArray<T>(file);
+        measure("mapped_slice_axis1", type, n, noSetup, [&] () {sink = Mapped.slice(0, side / 2, 1).fullSize();});
+        measure("mapped_sum_axis0", type, n, noSetup, [&] () {sink = Mapped.sum(0).fullSize();});
+        NDArray<T> Stencil(2, {3, 3});
+        Stencil.fill(value);
+        measure("nd_convolve_3x3", type, n, noSetup, [&] () {sink = convolve(A, Stencil, CONVOLVE_SAME).fullSize();});
+        if constexpr (is_same<T, double>::value) {
+            sink = fft2(A).fullSize();
+            measure("nd_fft2", type, n, noSetup, [&] () {sink = fft2(A).fullSize();});
+        }
+        remove(file.c_str());
+    }
+}
+template <class T>
+void benchType () {
+    for (unsigned long long n = 100; n <= settings.maxSize && n <= typeLimit<T>(); n *= 10) {
+        if (n < settings.minSize) continue;
+        benchArray<T>(n);
+        benchNDArray<T>(n);
+    }
+}
+string escape (const string &s) {
+    string e;
+    for (unsigned i = 0; i < s.size(); i++) {
+        if (s[i] == '"' || s[i] == '\\') e += '\\';
+        e += s[i];
+    }
+    return e;
+}
+void writeJSON (const string &FileName) {
+    ofstream f(FileName);
+    if (!f) throw std::invalid_argument("Cannot open benchmark output file!");
+    f<<"{\n  \"schema\": 1,\n  \"min_time\": "<<settings.minTime<<",\n  \"simd\": \""<<Simd::levelName(Simd::level())<<"\",\n  \"results\": [\n";
+    for (unsigned i = 0; i < results.size(); i++) {
+        const Result &R = results[i];
+        f<<"    {\"name\": \""<<escape(R.name)<<"\", \"type\": \""<<escape(R.type)<<"\", \"size\": "<<R.size
+         <<", \"iterations\": "<<R.iterations<<", \"ns_per_op\": "<<R.nsPerOp<<", \"ns_min\": "<<R.nsMin<<"}";
+        if (i + 1 < results.size()) f<<",";
+        f<<"\n";
+    }
+    f<<"  ]\n}\n";
+}
+int main (int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr<<"Missing value for "<<arg<<endl;
+            return 2;
+        }
+        if (arg == "--out") settings.out = argv[++i];
+        else if (arg == "--min-size") settings.minSize = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--max-size") settings.maxSize = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--min-time") settings.minTime = atof(argv[++i]);
+        else if (arg == "--filter") settings.filter = argv[++i];
+        else {
+            cerr<<"Unknown argument "<<arg<<endl;
+            return 2;
+        }
+    }
+    benchType<int>();
+    benchType<float>();
+    benchType<double>();
+    benchType<string>();
+    writeJSON(settings.out);
+    cerr<<"Results written to "<<settings.out<<endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file bench_concurrent.cpp
+ * @author DingoMC (www.dingomc.net)
+ * @brief Multi-producer scaling benchmark: ConcurrentArray vs Array guarded by a mutex
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @note Usage: bench_concurrent [--out results.json] [--count N] [--max-threads N]
+ */
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <cstdlib>
+#include "better_array.h"
+#include "concurrent_array.h"
+using namespace std;
+struct Result {
+    string name;
+    unsigned threads;
+    unsigned long long count;
+    double seconds;
+};
+template <class F>
+double timeProducers (unsigned threads, F producer) {
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (unsigned t = 0; t < threads; t++) workers.emplace_back(producer, t);
+    for (unsigned t = 0; t < threads; t++) workers[t].join();
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+int main (int argc, char** argv) {
+    string out = "bench_concurrent_results.json";
+    unsigned long long count = 10000000;
+    unsigned maxThreads = 2 * Parallel::threads();
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        if (arg == "--out") out = argv[i + 1];
+        else if (arg == "--count") count = strtoull(argv[i + 1], NULL, 10);
+        else if (arg == "--max-threads") maxThreads = (unsigned) atoi(argv[i + 1]);
+        else {
+            cerr<<"Unknown argument "<<arg<<endl;
+            return 2;
+        }
+    }
+    vector<Result> results;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        unsigned long long perThread = count / threads;
+        ConcurrentArray<long long> C;
+        double tc = timeProducers(threads, [&] (unsigned t) {
+            for (unsigned long long i = 0; i < perThread; i++) C.append((long long) (t * perThread + i));
+        });
+        if (C.size() != perThread * threads) {
+            cerr<<"ConcurrentArray lost elements!"<<endl;
+            return 1;
+        }
+        Array<long long> A;
+        mutex lock;
+        double ta = timeProducers(threads, [&] (unsigned t) {
+            for (unsigned long long i = 0; i < perThread; i++) {
+                lock_guard<mutex> guard(lock);
+                A.append((long long) (t * perThread + i));
+            }
+        });
+        results.push_back(Result{"concurrent_array_append", threads, perThread * threads, tc});
+        results.push_back(Result{"mutex_array_append", threads, perThread * threads, ta});
+        cerr<<threads<<" threads: ConcurrentArray "<<perThread * threads / tc / 1e6<<" M/s, Array + mutex "<<perThread * threads / ta / 1e6<<" M/s"<<endl;
+    }
+    ofstream f(out);
+    f<<"{\n  \"schema\": 1,\n  \"results\": [\n";
+    for (unsigned i = 0; i < results.size(); i++) {
+        f<<"    {\"name\": \""<<results[i].name<<"\", \"type\": \"long long\", \"size\": "<<results[i].count<<", \"threads\": "<<results[i].threads
+         <<", \"iterations\": 1, \"ns_per_op\": "<<results[i].seconds * 1e9<<", \"ns_min\": "<<results[i].seconds * 1e9<<"}";
+        f<<(i + 1 < results.size() ? ",\n" : "\n");
+    }
+    f<<"  ]\n}\n";
+    return 0;
+}
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""Compare Better Array benchmark results against a stored baseline.
+
+Usage: compare.py baseline.json results.json [--tolerance 0.10]
+
+Exits with status 1 when any benchmark present in both files got slower
+than the baseline by more than the tolerance (relative ns_per_op).
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return {(r["name"], r["type"], r["size"]): r for r in data["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("results")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="allowed relative slowdown (default 0.10 = 10%%)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.results)
+    regressions = 0
+    for key in sorted(baseline.keys() & current.keys()):
+        old = baseline[key]["ns_per_op"]
+        new = current[key]["ns_per_op"]
+        change = (new - old) / old if old > 0 else 0.0
+        status = "ok"
+        if change > args.tolerance:
+            status = "REGRESSION"
+            regressions += 1
+        elif change < -args.tolerance:
+            status = "improved"
+        name, type_, size = key
+        print(f"{status:10} {name:28} {type_:7} {size:>10} {old:14.1f} -> {new:14.1f} ns ({change:+.1%})")
+    missing = sorted(baseline.keys() - current.keys())
+    for name, type_, size in missing:
+        print(f"{'missing':10} {name:28} {type_:7} {size:>10}")
+    print(f"{regressions} regression(s), {len(missing)} missing benchmark(s)")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -18,15 +18,615 @@
 #include <list>
 #include <set>
 #include <map>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <string>
+#include <charconv>
+#include <sstream>
+#include <type_traits>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 #pragma GCC optimize("O3")
 #define MAX_S(a, b) a > b ? a : b
 #define ArrayBegin 0                // Min index available
 #define ArrayEnd 2147483647         // Max index available
 using namespace std;
 template <class T> class Array;     // Main Array Class
+template <class T, class Gen, bool Stoppable> class Lazy;   // Lazy Array pipeline
+template <class T> class Rolling;   // Sliding window view
 typedef Array<bool> ArrayMask;      // ArrayMask as Array<bool>
 enum Order {ASC = 1, DESC = -1};    // Sorting Order
 enum Direction {TOP = 0, BOTTOM = 1, RIGHT = 2, LEFT = 3}; // Expansion Direction
+#ifdef BETTER_ARRAY_PROFILE
+#include <chrono>
+#include <mutex>
+#include <string>
+/**
+ * @brief Profiler namespace for opt-in instrumentation (compile with -DBETTER_ARRAY_PROFILE)
+ *
+ * Scoped timers measure heavy methods, allocations, copies and index checks are attributed
+ * to the innermost active scope. Without BETTER_ARRAY_PROFILE all hooks compile to nothing.
+ */
+namespace Profiler {
+    // Aggregated statistics of one method
+    struct MethodStats {
+        unsigned long long calls = 0, totalNs = 0, maxNs = 0;
+        unsigned long long allocations = 0, allocBytes = 0, copies = 0, copyBytes = 0, indexChecks = 0;
+    };
+    // Complete event in Chrome trace format
+    struct TraceEvent {
+        string name;
+        unsigned long long startNs, durationNs, tid;
+    };
+    struct State {
+        mutex lock;
+        map<string, MethodStats> stats;
+        vector<TraceEvent> trace;
+        bool tracing = false;
+        chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+    };
+    inline State& state () {
+        static State S;
+        return S;
+    }
+    inline unsigned long long threadId () {
+        static thread_local unsigned long long id = hash<thread::id>()(this_thread::get_id());
+        return id;
+    }
+    inline void merge (MethodStats &Into, const MethodStats &From) {
+        Into.calls += From.calls;
+        Into.totalNs += From.totalNs;
+        if (From.maxNs > Into.maxNs) Into.maxNs = From.maxNs;
+        Into.allocations += From.allocations;
+        Into.allocBytes += From.allocBytes;
+        Into.copies += From.copies;
+        Into.copyBytes += From.copyBytes;
+        Into.indexChecks += From.indexChecks;
+    }
+    // Active timing scope (one method call)
+    class Scope {
+        private:
+            const char* name;
+            Scope* parent;
+            chrono::steady_clock::time_point start;
+        public:
+            MethodStats local;
+            explicit Scope (const char* Name) : name(Name), parent(active()), start(chrono::steady_clock::now()) {
+                active() = this;
+            }
+            ~Scope () {
+                chrono::steady_clock::time_point end = chrono::steady_clock::now();
+                unsigned long long ns = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                active() = parent;
+                local.calls = 1;
+                local.totalNs = local.maxNs = ns;
+                State &S = state();
+                lock_guard<mutex> guard(S.lock);
+                merge(S.stats[name], local);
+                if (S.tracing) {
+                    unsigned long long from = chrono::duration_cast<chrono::nanoseconds>(start - S.origin).count();
+                    S.trace.push_back(TraceEvent{name, from, ns, threadId()});
+                }
+            }
+            static Scope*& active () {
+                static thread_local Scope* current = NULL;
+                return current;
+            }
+            Scope (const Scope&) = delete;
+            Scope& operator= (const Scope&) = delete;
+    };
+    // Counter updates outside of any scope are recorded as "(unscoped)"
+    inline void flushUnscoped (const MethodStats &Tmp) {
+        State &S = state();
+        lock_guard<mutex> guard(S.lock);
+        merge(S.stats["(unscoped)"], Tmp);
+    }
+    inline void countAlloc (unsigned long long bytes) {
+        Scope* s = Scope::active();
+        if (s) {
+            s->local.allocations++;
+            s->local.allocBytes += bytes;
+            return;
+        }
+        MethodStats M;
+        M.allocations = 1;
+        M.allocBytes = bytes;
+        flushUnscoped(M);
+    }
+    inline void countCopy (unsigned long long bytes) {
+        Scope* s = Scope::active();
+        if (s) {
+            s->local.copies++;
+            s->local.copyBytes += bytes;
+            return;
+        }
+        MethodStats M;
+        M.copies = 1;
+        M.copyBytes = bytes;
+        flushUnscoped(M);
+    }
+    inline void countIndex () {
+        Scope* s = Scope::active();
+        if (s) s->local.indexChecks++;
+    }
+    /**
+     * @brief Enable or disable recording of Chrome trace events
+     * @param enabled Trace events are recorded if true
+     */
+    inline void setTracing (bool enabled) {
+        State &S = state();
+        lock_guard<mutex> guard(S.lock);
+        S.tracing = enabled;
+    }
+    /**
+     * @brief Clear all collected statistics and trace events
+     */
+    inline void reset () {
+        State &S = state();
+        lock_guard<mutex> guard(S.lock);
+        S.stats.clear();
+        S.trace.clear();
+        S.origin = chrono::steady_clock::now();
+    }
+    /**
+     * @brief Get collected statistics of one method
+     * @param Method Method name (e.g. "Array::sort")
+     * @return MethodStats
+     */
+    inline MethodStats get (const string &Method) {
+        State &S = state();
+        lock_guard<mutex> guard(S.lock);
+        map<string, MethodStats>::const_iterator it = S.stats.find(Method);
+        return it == S.stats.end() ? MethodStats() : it->second;
+    }
+    /**
+     * @brief Print per-method report
+     * @param out Output stream (default = cout)
+     */
+    inline void report (ostream &out = cout) {
+        State &S = state();
+        lock_guard<mutex> guard(S.lock);
+        out<<"method\tcalls\ttotal_ms\tavg_us\tmax_us\tallocs\talloc_bytes\tcopies\tcopy_bytes\tindex_checks"<<endl;
+        for (map<string, MethodStats>::const_iterator it = S.stats.begin(); it != S.stats.end(); ++it) {
+            const MethodStats &M = it->second;
+            out<<it->first<<"\t"<<M.calls<<"\t"<<M.totalNs / 1e6<<"\t"<<(M.calls ? M.totalNs / 1e3 / M.calls : 0.0)<<"\t"<<M.maxNs / 1e3
+               <<"\t"<<M.allocations<<"\t"<<M.allocBytes<<"\t"<<M.copies<<"\t"<<M.copyBytes<<"\t"<<M.indexChecks<<endl;
+        }
+    }
+    /**
+     * @brief Save recorded trace events as Chrome trace JSON (chrome://tracing, Perfetto)
+     * @param FileName File Name
+     */
+    inline void saveChromeTrace (const string &FileName) {
+        State &S = state();
+        lock_guard<mutex> guard(S.lock);
+        fstream f;
+        f.open(FileName, ios::out);
+        f<<"{\"traceEvents\":[";
+        for (unsigned i = 0; i < S.trace.size(); i++) {
+            if (i > 0) f<<",";
+            f<<"\n{\"name\":\""<<S.trace[i].name<<"\",\"ph\":\"X\",\"pid\":1,\"tid\":"<<S.trace[i].tid
+             <<",\"ts\":"<<S.trace[i].startNs / 1e3<<",\"dur\":"<<S.trace[i].durationNs / 1e3<<"}";
+        }
+        f<<"\n]}"<<endl;
+        f.close();
+    }
+}
+#define BA_PROFILE_CONCAT_(a, b) a##b
+#define BA_PROFILE_CONCAT(a, b) BA_PROFILE_CONCAT_(a, b)
+#define BA_PROFILE_SCOPE(name) Profiler::Scope BA_PROFILE_CONCAT(baProfileScope, __LINE__)(name)
+#define BA_COUNT_ALLOC(bytes) Profiler::countAlloc(bytes)
+#define BA_COUNT_COPY(bytes) Profiler::countCopy(bytes)
+#define BA_COUNT_INDEX() Profiler::countIndex()
+#define BA_TRACK_GROWTH(vec, elemSize, stmt) do { size_t baCap = (vec).capacity(); stmt; if ((vec).capacity() != baCap) Profiler::countAlloc((vec).capacity() * (elemSize)); } while (0)
+#else
+#define BA_PROFILE_SCOPE(name)
+#define BA_COUNT_ALLOC(bytes)
+#define BA_COUNT_COPY(bytes)
+#define BA_COUNT_INDEX()
+#define BA_TRACK_GROWTH(vec, elemSize, stmt) stmt
+#endif // BETTER_ARRAY_PROFILE
+/**
+ * @brief Parallel namespace for splitting work between threads
+ */
+namespace Parallel {
+    /**
+     * @brief Get or set number of worker threads used by parallel methods
+     * @param newCount If greater than 0, sets new thread count
+     * @return unsigned Current thread count (at least 1)
+     */
+    inline unsigned threads (unsigned newCount = 0) {
+        static unsigned count = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+        if (newCount > 0) count = newCount;
+        return count;
+    }
+    /**
+     * @brief Get number of chunks work should be split into
+     * @param count Number of work items
+     * @param minChunk Minimal number of items handled by one thread
+     * @return unsigned Chunk count (at least 1)
+     */
+    inline unsigned chunks (unsigned long long count, unsigned long long minChunk) {
+        if (minChunk == 0) minChunk = 1;
+        unsigned long long c = count / minChunk;
+        if (c > threads()) c = threads();
+        return c < 1 ? 1 : (unsigned) c;
+    }
+    /**
+     * @brief Run function on equal chunks of range [0, count) in parallel
+     * @tparam F Callable as fn(unsigned chunk, unsigned long long begin, unsigned long long end)
+     * @param count Number of work items
+     * @param chunkCount Number of chunks (see chunks())
+     * @param fn Chunk function
+     */
+    template <class F>
+    void forChunks (unsigned long long count, unsigned chunkCount, F fn) {
+        if (chunkCount <= 1) {
+            fn(0u, 0ull, count);
+            return;
+        }
+        vector<thread> workers;
+        vector<exception_ptr> errors(chunkCount);
+        for (unsigned c = 1; c < chunkCount; c++) {
+            workers.emplace_back([&, c] () {
+                try { fn(c, count * c / chunkCount, count * (c + 1) / chunkCount); }
+                catch (...) { errors[c] = current_exception(); }
+            });
+        }
+        try { fn(0u, 0ull, count / chunkCount); }
+        catch (...) { errors[0] = current_exception(); }
+        for (unsigned i = 0; i < workers.size(); i++) workers[i].join();
+        for (unsigned i = 0; i < chunkCount; i++) if (errors[i]) rethrow_exception(errors[i]);
+    }
+    const unsigned long long TileBytes = 1 << 18;   // Default tile size, fits in L2 cache of one core
+    /**
+     * @brief Get number of items per tile of TileBytes bytes
+     * @param itemBytes Size of one item
+     * @return unsigned long long Items per tile (at least 1)
+     */
+    inline unsigned long long tileItems (unsigned long long itemBytes) {return itemBytes >= TileBytes ? 1 : TileBytes / (itemBytes > 0 ? itemBytes : 1);}
+    /**
+     * @brief Run function on tiles of range [0, count) with work stealing
+     *
+     * Every thread starts with an equal run of tiles and takes them from the front. A thread out of work
+     * steals the back half of another thread's remaining run, so uneven tiles do not leave threads idle.
+     * @tparam F Callable as fn(unsigned long long begin, unsigned long long end)
+     * @param count Number of work items
+     * @param tile Items per tile (see tileItems())
+     * @param fn Tile function
+     */
+    template <class F>
+    void forTiles (unsigned long long count, unsigned long long tile, F fn) {
+        if (tile == 0) tile = 1;
+        unsigned long long tiles = (count + tile - 1) / tile;
+        unsigned workers = (unsigned) (tiles < threads() ? tiles : threads());
+        if (workers <= 1 || tiles > 0xFFFFFFFFull) {
+            for (unsigned long long b = 0; b < count; b += tile) fn(b, b + tile < count ? b + tile : count);
+            return;
+        }
+        // Remaining run of every worker packed as (first tile << 32 | end tile), updated with CAS
+        vector<atomic<unsigned long long>> runs(workers);
+        for (unsigned w = 0; w < workers; w++) runs[w].store((tiles * w / workers) << 32 | (tiles * (w + 1) / workers));
+        auto take = [&] (unsigned w, unsigned long long &t) {
+            unsigned long long v = runs[w].load();
+            while ((v >> 32) < (v & 0xFFFFFFFFull)) {
+                if (runs[w].compare_exchange_weak(v, v + (1ull << 32))) {
+                    t = v >> 32;
+                    return true;
+                }
+            }
+            return false;
+        };
+        auto steal = [&] (unsigned w) {
+            for (unsigned k = 1; k < workers; k++) {
+                unsigned victim = (w + k) % workers;
+                unsigned long long v = runs[victim].load();
+                while ((v >> 32) < (v & 0xFFFFFFFFull)) {
+                    unsigned long long first = v >> 32, end = v & 0xFFFFFFFFull, half = (end - first + 1) / 2;
+                    if (runs[victim].compare_exchange_weak(v, first << 32 | (end - half))) {
+                        runs[w].store((end - half) << 32 | end);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+        vector<exception_ptr> errors(workers);
+        auto work = [&] (unsigned w) {
+            try {
+                unsigned long long t;
+                do {
+                    while (take(w, t)) fn(t * tile, (t + 1) * tile < count ? (t + 1) * tile : count);
+                } while (steal(w));
+            }
+            catch (...) {
+                errors[w] = current_exception();
+                // Drop remaining tiles of this worker so others finish quickly
+                runs[w].store(0);
+            }
+        };
+        vector<thread> pool;
+        for (unsigned w = 1; w < workers; w++) pool.emplace_back(work, w);
+        work(0);
+        for (unsigned i = 0; i < pool.size(); i++) pool[i].join();
+        for (unsigned w = 0; w < workers; w++) if (errors[w]) rethrow_exception(errors[w]);
+    }
+}
+/**
+ * @brief Hashing namespace with open-addressing key index used by group-by, joins and set operations
+ */
+namespace Hashing {
+    /**
+     * @brief Scramble 64-bit value (splitmix64 finalizer). std::hash of integers is identity,
+     *        which clusters badly in power-of-two tables
+     */
+    inline unsigned long long mix (unsigned long long x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+    // True if std::hash<K> is usable
+    template <class K, class = void>
+    struct isHashable : false_type {};
+    template <class K>
+    struct isHashable<K, decltype((void) hash<K>()(declval<const K&>()))> : true_type {};
+    template <class K>
+    unsigned long long hashOf (const K& Key) {return mix((unsigned long long) hash<K>()(Key));}
+    /**
+     * @brief Open-addressing (linear probing) map from key to dense id 0, 1, 2, ... in insertion order
+     *
+     * Slots keep the upper hash bits next to the id, so most probes never touch the key storage.
+     * @tparam K Key type with std::hash and operator==
+     */
+    template <class K>
+    class KeyIndex {
+        private:
+            struct Slot {
+                unsigned tag;
+                int id;
+            };
+            vector<Slot> slots;
+            vector<K> keys;
+            unsigned long long mask;
+            void grow () {
+                vector<Slot> old;
+                old.swap(this->slots);
+                this->slots.assign(old.size() * 2, Slot{0, -1});
+                this->mask = this->slots.size() - 1;
+                for (unsigned i = 0; i < old.size(); i++) {
+                    if (old[i].id < 0) continue;
+                    unsigned long long p = hashOf<K>(this->keys[old[i].id]) & this->mask;
+                    while (this->slots[p].id >= 0) p = (p + 1) & this->mask;
+                    this->slots[p] = old[i];
+                }
+            }
+        public:
+            /**
+             * @brief Construct a new KeyIndex object
+             * @param expected Expected number of distinct keys (avoids rehashing)
+             */
+            explicit KeyIndex (unsigned expected = 0) {
+                unsigned long long cap = 16;
+                while (cap < 2ull * expected) cap <<= 1;
+                this->slots.assign(cap, Slot{0, -1});
+                this->mask = cap - 1;
+                this->keys.reserve(expected);
+            }
+            /**
+             * @brief Get id of key, adding it if not present
+             * @param Key
+             * @param h Precomputed hashOf(Key)
+             * @return int Key id
+             */
+            int insert (const K& Key, unsigned long long h) {
+                unsigned tag = (unsigned) (h >> 32);
+                unsigned long long p = h & this->mask;
+                while (this->slots[p].id >= 0) {
+                    if (this->slots[p].tag == tag && this->keys[this->slots[p].id] == Key) return this->slots[p].id;
+                    p = (p + 1) & this->mask;
+                }
+                int id = (int) this->keys.size();
+                this->slots[p] = Slot{tag, id};
+                this->keys.push_back(Key);
+                if (2 * this->keys.size() > this->slots.size()) grow();
+                return id;
+            }
+            int insert (const K& Key) {return insert(Key, hashOf(Key));}
+            /**
+             * @brief Find id of key
+             * @param Key
+             * @param h Precomputed hashOf(Key)
+             * @return int Key id or -1 if not present
+             */
+            int find (const K& Key, unsigned long long h) const {
+                unsigned tag = (unsigned) (h >> 32);
+                unsigned long long p = h & this->mask;
+                while (this->slots[p].id >= 0) {
+                    if (this->slots[p].tag == tag && this->keys[this->slots[p].id] == Key) return this->slots[p].id;
+                    p = (p + 1) & this->mask;
+                }
+                return -1;
+            }
+            int find (const K& Key) const {return find(Key, hashOf(Key));}
+            /**
+             * @brief Get number of distinct keys
+             */
+            unsigned size () const {return (unsigned) this->keys.size();}
+            /**
+             * @brief Get distinct keys, key id is the position
+             */
+            const vector<K>& keyList () const {return this->keys;}
+    };
+    /**
+     * @brief Blocked bloom filter: every key sets 2 bits inside one 64-bit word, so a lookup costs one memory access.
+     *        No false negatives, used to skip hash table probes for values that are certainly absent
+     */
+    class BloomFilter {
+        private:
+            vector<unsigned long long> words;
+            unsigned long long mask;
+        public:
+            /**
+             * @brief Construct a new BloomFilter object
+             * @param expected Expected number of keys (about 16 bits are reserved per key)
+             */
+            explicit BloomFilter (unsigned expected) {
+                unsigned long long n = 1;
+                while (n * 4 < expected) n <<= 1;
+                this->words.assign(n, 0);
+                this->mask = n - 1;
+            }
+            void add (unsigned long long h) {this->words[(h >> 12) & this->mask] |= (1ull << (h & 63)) | (1ull << ((h >> 6) & 63));}
+            bool mayContain (unsigned long long h) const {
+                unsigned long long bits = (1ull << (h & 63)) | (1ull << ((h >> 6) & 63));
+                return (this->words[(h >> 12) & this->mask] & bits) == bits;
+            }
+    };
+    /**
+     * @brief Intersect two strictly increasing int ranges. Uses SSE2 4x4 block compares where available
+     * @param a First range
+     * @param na First range length
+     * @param b Second range
+     * @param nb Second range length
+     * @param out Output, at least min(na, nb) long
+     * @return unsigned Number of common values written
+     */
+    inline unsigned intersectSorted (const int* a, unsigned na, const int* b, unsigned nb, int* out) {
+        unsigned i = 0, j = 0, k = 0;
+        #ifdef __SSE2__
+            while (i + 4 <= na && j + 4 <= nb) {
+                __m128i va = _mm_loadu_si128((const __m128i*) (a + i));
+                __m128i vb = _mm_loadu_si128((const __m128i*) (b + j));
+                __m128i m = _mm_cmpeq_epi32(va, vb);
+                m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+                m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+                m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+                int bits = _mm_movemask_ps(_mm_castsi128_ps(m));
+                for (unsigned t = 0; t < 4; t++) if (bits & (1 << t)) out[k++] = a[i + t];
+                int amax = a[i + 3], bmax = b[j + 3];
+                if (amax <= bmax) i += 4;
+                if (bmax <= amax) j += 4;
+            }
+        #endif // __SSE2__
+        while (i < na && j < nb) {
+            if (a[i] < b[j]) i++;
+            else if (b[j] < a[i]) j++;
+            else {
+                out[k++] = a[i];
+                i++;
+                j++;
+            }
+        }
+        return k;
+    }
+}
+/**
+ * @brief Formatter namespace for buffered printing of large arrays
+ *
+ * Values are written into one preallocated string with to_chars (same output as cout defaults),
+ * large ranges are formatted in parallel chunks. Optional NumPy-style summarization prints only
+ * edge items around "..." once element count exceeds the threshold.
+ */
+namespace Formatter {
+    // Printing options shared by Array, NDArray and Container
+    struct PrintOptions {
+        unsigned threshold;     // Summarize when element count exceeds threshold (0 = never)
+        unsigned edgeItems;     // Items printed at each edge of summarized dimension
+    };
+    inline PrintOptions& options () {
+        static PrintOptions Options = {0, 3};
+        return Options;
+    }
+    /**
+     * @brief Set summarization options
+     * @param threshold Summarize when element count exceeds threshold (0 = never, default)
+     * @param edgeItems Items printed at each edge of summarized dimension (default = 3)
+     */
+    inline void setPrintOptions (unsigned threshold, unsigned edgeItems = 3) {
+        options().threshold = threshold;
+        options().edgeItems = edgeItems;
+    }
+    // Types formatted directly into the buffer, other types are printed through Container::show
+    template <class T>
+    struct isDirect : integral_constant<bool, is_arithmetic<T>::value || is_same<T, string>::value> {};
+    /**
+     * @brief Append formatted value to buffer
+     * @param out Output buffer
+     * @param Value Arithmetic value, string or any type printable with operator<<
+     */
+    template <class T>
+    void append (string &out, const T& Value) {
+        if constexpr (is_same<T, bool>::value) out += Value ? '1' : '0';
+        else if constexpr (is_same<T, char>::value || is_same<T, signed char>::value || is_same<T, unsigned char>::value) out += (char) Value;
+        else if constexpr (is_integral<T>::value) {
+            char buf[32];
+            to_chars_result r = to_chars(buf, buf + sizeof(buf), Value);
+            out.append(buf, r.ptr - buf);
+        }
+        else if constexpr (is_floating_point<T>::value) {
+            char buf[64];
+            to_chars_result r = to_chars(buf, buf + sizeof(buf), Value, chars_format::general, 6);
+            out.append(buf, r.ptr - buf);
+        }
+        else if constexpr (is_convertible<T, string>::value) out += Value;
+        else {
+            ostringstream os;
+            os<<Value;
+            out += os.str();
+        }
+    }
+    /**
+     * @brief Append "v0<sep>v1<sep>..." for values get(0) ... get(n - 1), summarized if options require it
+     * @param out Output buffer
+     * @param n Value count
+     * @param get Callable returning i-th value
+     * @param sep Separator
+     */
+    template <class Get>
+    void appendRange (string &out, size_t n, Get get, const string &sep) {
+        const PrintOptions &P = options();
+        if (P.threshold > 0 && n > P.threshold && n > 2 * (size_t) P.edgeItems) {
+            for (size_t i = 0; i < P.edgeItems; i++) {
+                append(out, get(i));
+                out += sep;
+            }
+            out += "...";
+            for (size_t i = n - P.edgeItems; i < n; i++) {
+                out += sep;
+                append(out, get(i));
+            }
+            return;
+        }
+        unsigned chunkCount = Parallel::chunks(n, 1u << 16);
+        vector<string> parts(chunkCount);
+        Parallel::forChunks(n, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+            string &part = (c == 0 ? out : parts[c]);
+            part.reserve(part.size() + (e - b) * (8 + sep.size()));
+            for (unsigned long long i = b; i < e; i++) {
+                append(part, get(i));
+                if (i + 1 < n) part += sep;
+            }
+        });
+        size_t total = out.size();
+        for (unsigned c = 1; c < chunkCount; c++) total += parts[c].size();
+        out.reserve(total);
+        for (unsigned c = 1; c < chunkCount; c++) out += parts[c];
+    }
+}
 /**
  * @brief Container namespace for printing functions
  */
@@ -43,6 +643,14 @@ namespace Container {
     template <class T> void show (T Elem, bool showType, bool fromRecursion) {cout<<Elem;}
     template <class T> void show (T* Array, int arraySize, bool showType, bool fromRecursion) {
         if (arraySize < 0) throw std::invalid_argument("arraySize must be a positive integer!");
+        if constexpr (Formatter::isDirect<typename remove_cv<T>::type>::value) {
+            string out = showType ? "`DynArray` [" : "[";
+            Formatter::appendRange(out, arraySize, [Array] (size_t i) {return Array[i];}, ", ");
+            out += "]";
+            cout<<out;
+            if (!fromRecursion) cout<<endl;
+            return;
+        }
         if (showType) cout<<"`DynArray` ";
         cout<<"[";
         for (unsigned i = 0; i < arraySize; i++) {
@@ -65,6 +673,18 @@ namespace Container {
     }
     template<class T> void show (const Array < T > &Arr, bool showType, bool fromRecursion) {
         unsigned A_size = Arr.size();
+        if constexpr (Formatter::isDirect<T>::value) {
+            string out = showType ? "`Array` [" : "[";
+            if constexpr (is_same<T, bool>::value) Formatter::appendRange(out, A_size, [&Arr] (size_t i) {return Arr[(int) i];}, ", ");
+            else {
+                const T* D = Arr.data();
+                Formatter::appendRange(out, A_size, [D] (size_t i) {return D[i];}, ", ");
+            }
+            out += "]";
+            cout<<out;
+            if (!fromRecursion) cout<<endl;
+            return;
+        }
         if (showType) cout<<"`Array` ";
         cout<<"[";
         for (unsigned i = 0; i < A_size; i++) {
@@ -76,6 +696,14 @@ namespace Container {
     }
     template<class T> void show (const vector < T > &STL_Vec, bool showType, bool fromRecursion) {
         unsigned V_size = STL_Vec.size();
+        if constexpr (Formatter::isDirect<T>::value) {
+            string out = showType ? "`Vector` [" : "[";
+            Formatter::appendRange(out, V_size, [&STL_Vec] (size_t i) {return (T) STL_Vec[i];}, ", ");
+            out += "]";
+            cout<<out;
+            if (!fromRecursion) cout<<endl;
+            return;
+        }
         if (showType) cout<<"`Vector` ";
         cout<<"[";
         for (unsigned i = 0; i < V_size; i++) {
@@ -102,38 +730,1067 @@ namespace Container {
             if (it != STL_Set.cbegin()) cout<<", ";
             show(*it, showType, true);
         }
-        cout<<"}";
-        if (!fromRecursion) cout<<endl;
+        cout<<"}";
+        if (!fromRecursion) cout<<endl;
+    }
+    template<class T, class U> void show(const map<T, U> &Map, bool showType, bool fromRecursion) {
+        if (showType) cout<<"`Map` ";
+        cout<<"{";
+        for (typename map<T, U>::const_iterator it = Map.begin(); it != Map.end(); ++it) {
+            if (it != Map.cbegin()) cout<<", ";
+            show(it->first, showType, true);
+            cout<<": ";
+            show(it->second, showType, true);
+        }
+        cout<<"}";
+        if (!fromRecursion) cout<<endl;
+    }
+}
+/**
+ * @brief Stats namespace with mergeable statistics states
+ */
+namespace Stats {
+    // Values per block of the blocked Welford kernel (block fits in L1, both loops vectorize)
+    const unsigned MomentsBlock = 1024;
+    /**
+     * @brief Count, mean, sum of squared deviations, min and max of a value stream.
+     *        Partial states of chunks, threads or files merge exactly (Chan et al.)
+     */
+    struct Moments {
+        unsigned long long count = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        /**
+         * @brief Add single value (Welford update)
+         */
+        void add (double x) {
+            if (this->count == 0) this->min = this->max = x;
+            else {
+                if (x < this->min) this->min = x;
+                if (x > this->max) this->max = x;
+            }
+            this->count++;
+            double d = x - this->mean;
+            this->mean += d / (double) this->count;
+            this->m2 += d * (x - this->mean);
+        }
+        /**
+         * @brief Merge another state into this one
+         */
+        void merge (const Moments &Other) {
+            if (Other.count == 0) return;
+            if (this->count == 0) {
+                *this = Other;
+                return;
+            }
+            double n = (double) this->count + (double) Other.count, d = Other.mean - this->mean;
+            this->m2 += Other.m2 + d * d * (double) this->count * (double) Other.count / n;
+            this->mean += d * (double) Other.count / n;
+            if (Other.min < this->min) this->min = Other.min;
+            if (Other.max > this->max) this->max = Other.max;
+            this->count += Other.count;
+        }
+        /**
+         * @brief Add n values. Every block gets its mean and squared deviations in two vectorizable loops,
+         *        then is merged into the state
+         */
+        template <class T>
+        void add (const T* Data, unsigned long long n) {
+            for (unsigned long long b = 0; b < n; b += MomentsBlock) {
+                unsigned long long len = n - b < MomentsBlock ? n - b : MomentsBlock;
+                const T* x = Data + b;
+                double sum = 0.0, lo = (double) x[0], hi = (double) x[0];
+                for (unsigned long long i = 0; i < len; i++) {
+                    double v = (double) x[i];
+                    sum += v;
+                    lo = v < lo ? v : lo;
+                    hi = v > hi ? v : hi;
+                }
+                Moments Block;
+                Block.count = len;
+                Block.mean = sum / (double) len;
+                double m2 = 0.0;
+                for (unsigned long long i = 0; i < len; i++) {
+                    double d = (double) x[i] - Block.mean;
+                    m2 += d * d;
+                }
+                Block.m2 = m2;
+                Block.min = lo;
+                Block.max = hi;
+                merge(Block);
+            }
+        }
+        /**
+         * @brief Get variance
+         * @param ddof Delta degrees of freedom (0 = population, 1 = sample)
+         */
+        double var (unsigned ddof = 0) const {
+            if (this->count <= ddof) throw std::invalid_argument("Not enough values for variance!");
+            return this->m2 / (double) (this->count - ddof);
+        }
+        /**
+         * @brief Get standard deviation
+         * @param ddof Delta degrees of freedom (0 = population, 1 = sample)
+         */
+        double std (unsigned ddof = 0) const {return sqrt(var(ddof));}
+    };
+    // Summary of Array values returned by Array::describe()
+    struct Description {
+        unsigned long long count;
+        double mean, std, min, q25, median, q75, max;
+    };
+}
+/**
+ * @brief Memory namespace with the storage policy of Array (and NDArray, which stores its values in an Array)
+ *
+ * Every buffer starts on a 64-byte boundary (cache line, widest SIMD register) and its byte size is rounded up
+ * to a multiple of 64, so vector loops may load whole registers up to paddedSize() without a scalar remainder.
+ * Large buffers may additionally be backed by transparent huge pages (Linux only, off by default).
+ */
+namespace Memory {
+    const size_t Alignment = 64;                // Alignment of every Array buffer in bytes
+    const size_t HugePageSize = 1u << 21;       // Transparent huge page size (x86-64, AArch64 with 4 KiB pages)
+    // Storage options shared by all Arrays
+    struct StorageOptions {
+        size_t hugePageMin;     // Buffers of at least hugePageMin bytes use huge pages (0 = never)
+    };
+    inline StorageOptions& options () {
+        static StorageOptions Options = {0};
+        return Options;
+    }
+    /**
+     * @brief Back large buffers allocated from now on with huge pages (madvise(MADV_HUGEPAGE), no effect outside Linux)
+     * @param minBytes Smallest buffer using huge pages (0 = never, default). Buffers are rounded up to whole huge pages
+     */
+    inline void setHugePages (size_t minBytes) {options().hugePageMin = minBytes;}
+    /**
+     * @brief Get element count that may be read from a buffer holding n elements (n rounded up to whole 64-byte blocks)
+     */
+    template <class T>
+    constexpr size_t paddedSize (size_t n) {return (n * sizeof(T) + Alignment - 1) / Alignment * Alignment / sizeof(T);}
+    /**
+     * @brief Check if pointer is aligned to Alignment bytes
+     */
+    inline bool isAligned (const void* p) {return ((size_t) p & (Alignment - 1)) == 0;}
+    /**
+     * @brief Allocator returning 64-byte aligned, 64-byte padded (optionally huge page backed) memory
+     * @tparam T Any
+     */
+    template <class T>
+    struct AlignedAllocator {
+        typedef T value_type;
+        AlignedAllocator () noexcept {}
+        template <class U> AlignedAllocator (const AlignedAllocator<U>&) noexcept {}
+        T* allocate (size_t n) {
+            if (n > (size_t) -1 / sizeof(T) - Alignment) throw std::bad_alloc();
+            size_t bytes = (n * sizeof(T) + Alignment - 1) / Alignment * Alignment, align = Alignment;
+            bool huge = options().hugePageMin > 0 && bytes >= options().hugePageMin;
+            if (huge) {
+                align = HugePageSize;
+                bytes = (bytes + HugePageSize - 1) / HugePageSize * HugePageSize;
+            }
+            #ifdef _WIN32
+                void* p = _aligned_malloc(bytes, align);
+            #else
+                void* p = aligned_alloc(align, bytes);
+            #endif // _WIN32
+            if (p == NULL) throw std::bad_alloc();
+            #if defined(__linux__) && defined(MADV_HUGEPAGE)
+                if (huge) madvise(p, bytes, MADV_HUGEPAGE);
+            #endif
+            return (T*) p;
+        }
+        void deallocate (T* p, size_t) noexcept {
+            #ifdef _WIN32
+                _aligned_free(p);
+            #else
+                free(p);
+            #endif // _WIN32
+        }
+        template <class U> bool operator== (const AlignedAllocator<U>&) const noexcept {return true;}
+        template <class U> bool operator!= (const AlignedAllocator<U>&) const noexcept {return false;}
+    };
+    // Vector with Array storage policy
+    template <class T> using Vector = vector<T, AlignedAllocator<T>>;
+}
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BA_SIMD_DISPATCH                                // Per-ISA kernels compiled with target attributes
+#define BA_SIMD_INLINE inline __attribute__((always_inline))
+#else
+#define BA_SIMD_INLINE inline
+#endif
+/**
+ * @brief Simd namespace with kernels for arithmetic, comparisons, reductions, gathers and mask compaction
+ *
+ * Every kernel exists for SSE2, AVX2 and AVX-512 (compiled with target attributes, so no -m flags are needed)
+ * and as a plain loop. The level is detected once through cpuid, the environment variable BETTER_ARRAY_SIMD
+ * (scalar, sse2, avx2, avx512) may lower it for testing and benchmarks. Kernels take 4 and 8 byte arithmetic types,
+ * masks are passed as packed 64-bit words (bit i of word i / 64 belongs to element i).
+ */
+namespace Simd {
+    enum Level {SIMD_SCALAR = 0, SIMD_SSE2 = 1, SIMD_AVX2 = 2, SIMD_AVX512 = 3};
+    enum Op {OP_ADD = 0, OP_SUB = 1, OP_MUL = 2, OP_DIV = 3};
+    enum Cmp {CMP_EQ = 0, CMP_NE = 1, CMP_LT = 2, CMP_LE = 3, CMP_GT = 4, CMP_GE = 5};
+    // Types handled by kernels
+    template <class T>
+    struct isKernelType : integral_constant<bool, is_arithmetic<T>::value && !is_same<T, bool>::value && (sizeof(T) == 4 || sizeof(T) == 8)> {};
+    inline const char* levelName (Level L) {
+        static const char* Names[] = {"scalar", "sse2", "avx2", "avx512"};
+        return Names[L];
+    }
+    /**
+     * @brief Get highest level supported by CPU and operating system
+     */
+    inline Level detect () {
+        #ifdef BA_SIMD_DISPATCH
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+            if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+            if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+        #endif // BA_SIMD_DISPATCH
+        return SIMD_SCALAR;
+    }
+    inline Level& current () {
+        static Level L = [] () {
+            Level Best = detect();
+            const char* Forced = getenv("BETTER_ARRAY_SIMD");
+            if (Forced == NULL) return Best;
+            for (int l = SIMD_SCALAR; l <= SIMD_AVX512; l++) {
+                if (string(Forced) == levelName((Level) l)) return (Level) l < Best ? (Level) l : Best;
+            }
+            return Best;
+        }();
+        return L;
+    }
+    /**
+     * @brief Get level used by kernels
+     */
+    inline Level level () {return current();}
+    /**
+     * @brief Select kernel level (capped at detect())
+     * @param L SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2 or SIMD_AVX512
+     */
+    inline void setLevel (Level L) {current() = L < detect() ? L : detect();}
+    // Portable bodies. Vector types are sized by W bytes and compiled for the ISA of the calling target function,
+    // vectors are passed by reference so no vector ABI is involved outside target functions
+    template <int O, class V>
+    BA_SIMD_INLINE void apply (V &x, const V &y) {
+        if constexpr (O == OP_ADD) x += y;
+        else if constexpr (O == OP_SUB) x -= y;
+        else if constexpr (O == OP_MUL) x *= y;
+        else x /= y;
+    }
+    template <int C, class V, class M>
+    BA_SIMD_INLINE void test (const V &x, const V &y, M &m) {
+        if constexpr (C == CMP_EQ) m = x == y;
+        else if constexpr (C == CMP_NE) m = x != y;
+        else if constexpr (C == CMP_LT) m = x < y;
+        else if constexpr (C == CMP_LE) m = x <= y;
+        else if constexpr (C == CMP_GT) m = x > y;
+        else m = x >= y;
+    }
+    template <int O, class T>
+    BA_SIMD_INLINE T applied (T x, T y) {
+        apply<O>(x, y);
+        return x;
+    }
+    template <int C, class T>
+    BA_SIMD_INLINE bool tested (T x, T y) {
+        bool m;
+        test<C>(x, y, m);
+        return m;
+    }
+    // Fill all lanes with value (through memory, so the vector itself never needs an address)
+    template <class V, class T>
+    BA_SIMD_INLINE void splat (V &v, T value) {
+        T lanes[sizeof(V) / sizeof(T)];
+        for (size_t k = 0; k < sizeof(V) / sizeof(T); k++) lanes[k] = value;
+        memcpy(&v, lanes, sizeof(V));
+    }
+    template <class T, unsigned W, int O, bool Broadcast>
+    BA_SIMD_INLINE void binaryLoop (const T* a, const T* b, T* out, size_t n) {
+        typedef T V __attribute__((vector_size(W)));
+        const size_t L = W / sizeof(T);
+        size_t i = 0;
+        V y;
+        if (Broadcast) splat(y, b[0]);
+        for (; i + L <= n; i += L) {
+            V x;
+            memcpy(&x, a + i, W);
+            if (!Broadcast) memcpy(&y, b + i, W);
+            apply<O>(x, y);
+            memcpy(out + i, &x, W);
+        }
+        for (; i < n; i++) out[i] = applied<O>(a[i], Broadcast ? b[0] : b[i]);
+    }
+    template <class T, unsigned W>
+    BA_SIMD_INLINE void axpyLoop (const T* x, T a, T* y, size_t n) {
+        typedef T V __attribute__((vector_size(W)));
+        const size_t L = W / sizeof(T);
+        size_t i = 0;
+        V s;
+        splat(s, a);
+        for (; i + L <= n; i += L) {
+            V u, v;
+            memcpy(&u, x + i, W);
+            memcpy(&v, y + i, W);
+            v += s * u;
+            memcpy(y + i, &v, W);
+        }
+        for (; i < n; i++) y[i] += a * x[i];
+    }
+    template <class T, unsigned W, bool Largest>
+    BA_SIMD_INLINE T extremeLoop (const T* a, size_t n) {
+        typedef T V __attribute__((vector_size(W)));
+        const size_t L = W / sizeof(T);
+        size_t i = 0;
+        // Four independent accumulators hide the latency of vector min / max
+        V m[4];
+        for (unsigned u = 0; u < 4; u++) splat(m[u], a[0]);
+        for (; i + 4 * L <= n; i += 4 * L) {
+            for (unsigned u = 0; u < 4; u++) {
+                V x;
+                memcpy(&x, a + i + u * L, W);
+                m[u] = (Largest ? x > m[u] : x < m[u]) ? x : m[u];
+            }
+        }
+        for (; i + L <= n; i += L) {
+            V x;
+            memcpy(&x, a + i, W);
+            m[0] = (Largest ? x > m[0] : x < m[0]) ? x : m[0];
+        }
+        for (unsigned u = 1; u < 4; u++) m[0] = (Largest ? m[u] > m[0] : m[u] < m[0]) ? m[u] : m[0];
+        T lanes[L];
+        memcpy(lanes, &m[0], W);
+        T r = lanes[0];
+        for (size_t k = 1; k < L; k++) if (Largest ? lanes[k] > r : lanes[k] < r) r = lanes[k];
+        for (; i < n; i++) if (Largest ? a[i] > r : a[i] < r) r = a[i];
+        return r;
+    }
+    template <class T, unsigned W>
+    BA_SIMD_INLINE double sumLoop (const T* a, size_t n) {
+        // Every step converts W / 8 values into one register of doubles, narrower T are loaded as partial registers
+        const size_t L = W / sizeof(double);
+        typedef typename conditional<true, double, T>::type Wide;    // Dependent, so vector_size is applied per instantiation
+        typedef Wide D __attribute__((vector_size(W)));
+        typedef T V __attribute__((vector_size(L * sizeof(T))));
+        size_t i = 0;
+        D s[2];
+        splat(s[0], 0.0);
+        splat(s[1], 0.0);
+        for (; i + 2 * L <= n; i += 2 * L) {
+            V x, y;
+            memcpy(&x, a + i, sizeof(V));
+            memcpy(&y, a + i + L, sizeof(V));
+            s[0] += __builtin_convertvector(x, D);
+            s[1] += __builtin_convertvector(y, D);
+        }
+        s[0] += s[1];
+        double lanes[L], r = 0.0;
+        memcpy(lanes, &s[0], W);
+        for (size_t k = 0; k < L; k++) r += lanes[k];
+        for (; i < n; i++) r += (double) a[i];
+        return r;
+    }
+    // One accumulator per segment, the last vector overlaps values already seen (min / max are idempotent).
+    // Lanes start from the first value like extremeLoop, so a NaN only wins when it is the first value
+    template <class T, unsigned W, bool Largest>
+    BA_SIMD_INLINE void segmentExtremeLoop (const T* a, const unsigned* o, size_t segments, T* out) {
+        typedef T V __attribute__((vector_size(W)));
+        const size_t L = W / sizeof(T);
+        for (size_t s = 0; s < segments; s++) {
+            const T* p = a + o[s];
+            size_t n = o[s + 1] - o[s], i = 1;
+            T r = p[0];
+            if (n >= L) {
+                V m, x;
+                splat(m, p[0]);
+                for (i = 0; i + L <= n; i += L) {
+                    memcpy(&x, p + i, W);
+                    m = (Largest ? x > m : x < m) ? x : m;
+                }
+                memcpy(&x, p + n - L, W);
+                m = (Largest ? x > m : x < m) ? x : m;
+                T lanes[L];
+                memcpy(lanes, &m, W);
+                r = lanes[0];
+                for (size_t k = 1; k < L; k++) if (Largest ? lanes[k] > r : lanes[k] < r) r = lanes[k];
+                i = n;
+            }
+            for (; i < n; i++) if (Largest ? p[i] > r : p[i] < r) r = p[i];
+            out[s] = r;
+        }
+    }
+    template <class T, unsigned W>
+    BA_SIMD_INLINE void segmentSumLoop (const T* a, const unsigned* o, size_t segments, double* out) {
+        for (size_t s = 0; s < segments; s++) out[s] = sumLoop<T, W>(a + o[s], o[s + 1] - o[s]);
+    }
+    // Compare one block of 64 elements, lane masks are packed by the level specific movemask M
+    template <class T, unsigned W, int C, bool Broadcast, class Movemask>
+    BA_SIMD_INLINE unsigned long long compareBlock (const T* a, const T* b, Movemask M) {
+        typedef T V __attribute__((vector_size(W)));
+        typedef decltype(V() < V()) Lanes;
+        const unsigned L = W / sizeof(T);
+        unsigned long long bits = 0;
+        V y;
+        if (Broadcast) splat(y, b[0]);
+        for (unsigned j = 0; j < 64; j += L) {
+            V x;
+            memcpy(&x, a + j, W);
+            if (!Broadcast) memcpy(&y, b + j, W);
+            Lanes m;
+            test<C>(x, y, m);
+            bits |= (unsigned long long) M(m) << j;
+        }
+        return bits;
+    }
+    template <class T, int C, bool Broadcast>
+    inline void compareTail (const T* a, const T* b, unsigned long long* bits, size_t from, size_t n) {
+        if (from >= n) return;
+        unsigned long long w = 0;
+        for (size_t i = from; i < n; i++) w |= (unsigned long long) tested<C>(a[i], Broadcast ? b[0] : b[i]) << (i - from);
+        bits[from / 64] = w;
+    }
+    #ifdef BA_SIMD_DISPATCH
+        // SSE2 kernels
+        template <class T, int O, bool Broadcast>
+        __attribute__((target("sse2"))) void binarySse2 (const T* a, const T* b, T* out, size_t n) {binaryLoop<T, 16, O, Broadcast>(a, b, out, n);}
+        template <class T>
+        __attribute__((target("sse2"))) void axpySse2 (const T* x, T a, T* y, size_t n) {axpyLoop<T, 16>(x, a, y, n);}
+        template <class T, bool Largest>
+        __attribute__((target("sse2"))) T extremeSse2 (const T* a, size_t n) {return extremeLoop<T, 16, Largest>(a, n);}
+        template <class T>
+        __attribute__((target("sse2"))) double sumSse2 (const T* a, size_t n) {return sumLoop<T, 16>(a, n);}
+        template <class T, bool Largest>
+        __attribute__((target("sse2"))) void segmentExtremeSse2 (const T* a, const unsigned* o, size_t segments, T* out) {segmentExtremeLoop<T, 16, Largest>(a, o, segments, out);}
+        template <class T>
+        __attribute__((target("sse2"))) void segmentSumSse2 (const T* a, const unsigned* o, size_t segments, double* out) {segmentSumLoop<T, 16>(a, o, segments, out);}
+        template <class T, int C, bool Broadcast>
+        __attribute__((target("sse2"))) void compareSse2 (const T* a, const T* b, unsigned long long* bits, size_t n) {
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                bits[i / 64] = compareBlock<T, 16, C, Broadcast>(a + i, b + (Broadcast ? 0 : i), [] (const auto &m) {
+                    if constexpr (sizeof(T) == 4) return (unsigned) _mm_movemask_ps((__m128) m);
+                    else return (unsigned) _mm_movemask_pd((__m128d) m);
+                });
+            }
+            compareTail<T, C, Broadcast>(a, b, bits, i, n);
+        }
+        // AVX2 kernels
+        template <class T, int O, bool Broadcast>
+        __attribute__((target("avx2"))) void binaryAvx2 (const T* a, const T* b, T* out, size_t n) {binaryLoop<T, 32, O, Broadcast>(a, b, out, n);}
+        template <class T>
+        __attribute__((target("avx2"))) void axpyAvx2 (const T* x, T a, T* y, size_t n) {axpyLoop<T, 32>(x, a, y, n);}
+        template <class T, bool Largest>
+        __attribute__((target("avx2"))) T extremeAvx2 (const T* a, size_t n) {return extremeLoop<T, 32, Largest>(a, n);}
+        template <class T>
+        __attribute__((target("avx2"))) double sumAvx2 (const T* a, size_t n) {return sumLoop<T, 32>(a, n);}
+        template <class T, bool Largest>
+        __attribute__((target("avx2"))) void segmentExtremeAvx2 (const T* a, const unsigned* o, size_t segments, T* out) {segmentExtremeLoop<T, 32, Largest>(a, o, segments, out);}
+        template <class T>
+        __attribute__((target("avx2"))) void segmentSumAvx2 (const T* a, const unsigned* o, size_t segments, double* out) {segmentSumLoop<T, 32>(a, o, segments, out);}
+        template <class T, int C, bool Broadcast>
+        __attribute__((target("avx2"))) void compareAvx2 (const T* a, const T* b, unsigned long long* bits, size_t n) {
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                bits[i / 64] = compareBlock<T, 32, C, Broadcast>(a + i, b + (Broadcast ? 0 : i), [] (const auto &m) __attribute__((target("avx2"))) {
+                    if constexpr (sizeof(T) == 4) return (unsigned) _mm256_movemask_ps((__m256) m);
+                    else return (unsigned) _mm256_movemask_pd((__m256d) m);
+                });
+            }
+            compareTail<T, C, Broadcast>(a, b, bits, i, n);
+        }
+        // Permutations moving selected 32-bit lanes to the front, one per 8-bit mask
+        inline const unsigned char* compactTable () {
+            static unsigned char Table[256][8];
+            static bool built = [] () {
+                for (unsigned m = 0; m < 256; m++) {
+                    unsigned k = 0;
+                    for (unsigned j = 0; j < 8; j++) if (m >> j & 1) Table[m][k++] = (unsigned char) j;
+                    while (k < 8) Table[m][k++] = 0;
+                }
+                return true;
+            }();
+            (void) built;
+            return Table[0];
+        }
+        template <class T>
+        __attribute__((target("avx2"))) size_t compactAvx2 (const T* a, const unsigned long long* bits, T* out, size_t n) {
+            const unsigned char* Table = compactTable();
+            size_t k = 0, i = 0;
+            for (; i + 64 <= n; i += 64) {
+                unsigned long long w = bits[i / 64];
+                if (w == 0) continue;
+                // 64-bit lanes are moved as pairs of 32-bit lanes, 4 elements per 8 lanes
+                const unsigned step = sizeof(T) == 4 ? 8 : 4;
+                for (unsigned j = 0; j < 64; j += step, w >>= step) {
+                    unsigned m = (unsigned) (w & ((1u << step) - 1));
+                    if (m == 0) continue;
+                    __m256i v = _mm256_loadu_si256((const __m256i*) (a + i + j));
+                    __m256i p;
+                    if constexpr (sizeof(T) == 4) p = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) (Table + m * 8)));
+                    else {
+                        // Expand 4-bit element mask to 8-bit lane mask (each element covers two lanes)
+                        unsigned lanes = 0;
+                        for (unsigned e = 0; e < 4; e++) if (m >> e & 1) lanes |= 3u << (2 * e);
+                        p = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) (Table + lanes * 8)));
+                    }
+                    _mm256_storeu_si256((__m256i*) (out + k), _mm256_permutevar8x32_epi32(v, p));
+                    k += __builtin_popcount(m);
+                }
+            }
+            for (; i < n; i++) {
+                out[k] = a[i];
+                k += bits[i / 64] >> (i % 64) & 1;
+            }
+            return k;
+        }
+        // AVX-512 kernels
+        template <class T, int O, bool Broadcast>
+        __attribute__((target("avx512f"))) void binaryAvx512 (const T* a, const T* b, T* out, size_t n) {binaryLoop<T, 64, O, Broadcast>(a, b, out, n);}
+        template <class T>
+        __attribute__((target("avx512f"))) void axpyAvx512 (const T* x, T a, T* y, size_t n) {axpyLoop<T, 64>(x, a, y, n);}
+        template <class T, bool Largest>
+        __attribute__((target("avx512f"))) T extremeAvx512 (const T* a, size_t n) {return extremeLoop<T, 64, Largest>(a, n);}
+        template <class T>
+        __attribute__((target("avx512f"))) double sumAvx512 (const T* a, size_t n) {return sumLoop<T, 64>(a, n);}
+        template <class T, int C, bool Broadcast>
+        __attribute__((target("avx512f"))) void compareAvx512 (const T* a, const T* b, unsigned long long* bits, size_t n) {
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                bits[i / 64] = compareBlock<T, 64, C, Broadcast>(a + i, b + (Broadcast ? 0 : i), [] (const auto &m) __attribute__((target("avx512f"))) {
+                    if constexpr (sizeof(T) == 4) return (unsigned) _mm512_test_epi32_mask((__m512i) m, (__m512i) m);
+                    else return (unsigned) _mm512_test_epi64_mask((__m512i) m, (__m512i) m);
+                });
+            }
+            compareTail<T, C, Broadcast>(a, b, bits, i, n);
+        }
+        template <class T>
+        __attribute__((target("avx512f"))) size_t compactAvx512 (const T* a, const unsigned long long* bits, T* out, size_t n) {
+            size_t k = 0, i = 0;
+            for (; i + 64 <= n; i += 64) {
+                unsigned long long w = bits[i / 64];
+                if (w == 0) continue;
+                const unsigned step = 64 / sizeof(T);
+                for (unsigned j = 0; j < 64; j += step, w >>= step) {
+                    __m512i v = _mm512_loadu_si512((const void*) (a + i + j));
+                    if constexpr (sizeof(T) == 4) {
+                        __mmask16 m = (__mmask16) w;
+                        _mm512_storeu_si512((void*) (out + k), _mm512_maskz_compress_epi32(m, v));
+                        k += __builtin_popcount(m);
+                    }
+                    else {
+                        __mmask8 m = (__mmask8) w;
+                        _mm512_storeu_si512((void*) (out + k), _mm512_maskz_compress_epi64(m, v));
+                        k += __builtin_popcount(m);
+                    }
+                }
+            }
+            for (; i < n; i++) {
+                out[k] = a[i];
+                k += bits[i / 64] >> (i % 64) & 1;
+            }
+            return k;
+        }
+        // Gathers of 4 and 8 byte values with 32-bit indices
+        template <class T>
+        __attribute__((target("avx2"))) void gatherAvx2 (T* out, const T* src, const int* idx, size_t n) {
+            size_t i = 0;
+            if constexpr (sizeof(T) == 4) {
+                for (; i + 8 <= n; i += 8) {
+                    __m256i v = _mm256_loadu_si256((const __m256i*) (idx + i));
+                    _mm256_storeu_si256((__m256i*) (out + i), _mm256_i32gather_epi32((const int*) src, v, 4));
+                }
+            }
+            else {
+                for (; i + 4 <= n; i += 4) {
+                    __m128i v = _mm_loadu_si128((const __m128i*) (idx + i));
+                    _mm256_storeu_si256((__m256i*) (out + i), _mm256_i32gather_epi64((const long long*) src, v, 8));
+                }
+            }
+            for (; i < n; i++) out[i] = src[idx[i]];
+        }
+        template <class T>
+        __attribute__((target("avx512f"))) void gatherAvx512 (T* out, const T* src, const int* idx, size_t n) {
+            size_t i = 0;
+            if constexpr (sizeof(T) == 4) {
+                for (; i + 16 <= n; i += 16) {
+                    __m512i v = _mm512_loadu_si512((const void*) (idx + i));
+                    _mm512_storeu_si512((void*) (out + i), _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), (__mmask16) 0xFFFF, v, (const void*) src, 4));
+                }
+            }
+            else {
+                for (; i + 8 <= n; i += 8) {
+                    __m256i v = _mm256_loadu_si256((const __m256i*) (idx + i));
+                    _mm512_storeu_si512((void*) (out + i), _mm512_mask_i32gather_epi64(_mm512_setzero_si512(), (__mmask8) 0xFF, v, (const void*) src, 8));
+                }
+            }
+            for (; i < n; i++) out[i] = src[idx[i]];
+        }
+    #endif // BA_SIMD_DISPATCH
+    /**
+     * @brief out[i] = a[i] (op) b[i], or a[i] (op) b[0] when Broadcast. out may alias a
+     */
+    template <int O, bool Broadcast, class T>
+    void binary (const T* a, const T* b, T* out, size_t n) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (level()) {
+                case SIMD_AVX512: binaryAvx512<T, O, Broadcast>(a, b, out, n); return;
+                case SIMD_AVX2: binaryAvx2<T, O, Broadcast>(a, b, out, n); return;
+                case SIMD_SSE2: binarySse2<T, O, Broadcast>(a, b, out, n); return;
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        for (size_t i = 0; i < n; i++) out[i] = applied<O>(a[i], Broadcast ? b[0] : b[i]);
+    }
+    /**
+     * @brief y[i] += a * x[i]. x and y must not overlap
+     */
+    template <class T>
+    void axpy (const T* x, T a, T* y, size_t n) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (level()) {
+                case SIMD_AVX512: axpyAvx512<T>(x, a, y, n); return;
+                case SIMD_AVX2: axpyAvx2<T>(x, a, y, n); return;
+                case SIMD_SSE2: axpySse2<T>(x, a, y, n); return;
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        for (size_t i = 0; i < n; i++) y[i] += a * x[i];
+    }
+    /**
+     * @brief Get largest (Largest = true) or smallest value of n > 0 values. Comparisons follow operator<, so NaN is kept only at a[0]
+     */
+    template <bool Largest, class T>
+    T extreme (const T* a, size_t n) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (level()) {
+                case SIMD_AVX512: return extremeAvx512<T, Largest>(a, n);
+                case SIMD_AVX2: return extremeAvx2<T, Largest>(a, n);
+                case SIMD_SSE2: return extremeSse2<T, Largest>(a, n);
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        T r = a[0];
+        for (size_t i = 1; i < n; i++) if (Largest ? a[i] > r : a[i] < r) r = a[i];
+        return r;
+    }
+    /**
+     * @brief Get sum of values accumulated in double. Lanes keep separate partial sums, so for float and double
+     *        the result may differ from a sequential loop in the last bits (relative error within n * epsilon)
+     */
+    template <class T>
+    double sum (const T* a, size_t n) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (level()) {
+                case SIMD_AVX512: return sumAvx512<T>(a, n);
+                case SIMD_AVX2: return sumAvx2<T>(a, n);
+                case SIMD_SSE2: return sumSse2<T>(a, n);
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        double r = 0.0;
+        for (size_t i = 0; i < n; i++) r += (double) a[i];
+        return r;
+    }
+    /**
+     * @brief out[s] = largest (Largest = true) or smallest value of segment a[o[s]] ... a[o[s + 1] - 1]. Segments must not be empty.
+     *        Segments of tens of values gain nothing from 64 byte vectors, so AVX-512 runs the AVX2 body
+     */
+    template <bool Largest, class T>
+    void segmentExtreme (const T* a, const unsigned* o, size_t segments, T* out) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (level()) {
+                case SIMD_AVX512:
+                case SIMD_AVX2: segmentExtremeAvx2<T, Largest>(a, o, segments, out); return;
+                case SIMD_SSE2: segmentExtremeSse2<T, Largest>(a, o, segments, out); return;
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        for (size_t s = 0; s < segments; s++) {
+            T r = a[o[s]];
+            for (size_t i = o[s] + 1; i < o[s + 1]; i++) if (Largest ? a[i] > r : a[i] < r) r = a[i];
+            out[s] = r;
+        }
+    }
+    /**
+     * @brief out[s] = sum of segment a[o[s]] ... a[o[s + 1] - 1] accumulated in double
+     */
+    template <class T>
+    void segmentSum (const T* a, const unsigned* o, size_t segments, double* out) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (level()) {
+                case SIMD_AVX512:
+                case SIMD_AVX2: segmentSumAvx2<T>(a, o, segments, out); return;
+                case SIMD_SSE2: segmentSumSse2<T>(a, o, segments, out); return;
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        for (size_t s = 0; s < segments; s++) {
+            double r = 0.0;
+            for (size_t i = o[s]; i < o[s + 1]; i++) r += (double) a[i];
+            out[s] = r;
+        }
+    }
+    /**
+     * @brief Write bit i = a[i] (cmp) b[i], or a[i] (cmp) b[0] when Broadcast, into (n + 63) / 64 words. Unused bits of last word are cleared
+     */
+    template <int C, bool Broadcast, class T>
+    void compare (const T* a, const T* b, unsigned long long* bits, size_t n) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (level()) {
+                case SIMD_AVX512: compareAvx512<T, C, Broadcast>(a, b, bits, n); return;
+                case SIMD_AVX2: compareAvx2<T, C, Broadcast>(a, b, bits, n); return;
+                case SIMD_SSE2: compareSse2<T, C, Broadcast>(a, b, bits, n); return;
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        for (size_t i = 0; i < n; i += 64) compareTail<T, C, Broadcast>(a, b, bits, i, i + 64 < n ? i + 64 : n);
+    }
+    /**
+     * @brief out[i] = src[idx[i]] for valid, non-negative indices. SSE2 has no gather instruction, so it runs the plain loop
+     */
+    template <class T>
+    void gather (T* out, const T* src, const int* idx, size_t n) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (level()) {
+                case SIMD_AVX512: gatherAvx512<T>(out, src, idx, n); return;
+                case SIMD_AVX2: gatherAvx2<T>(out, src, idx, n); return;
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        for (size_t i = 0; i < n; i++) out[i] = src[idx[i]];
+    }
+    // Extra elements compact() may write past the selected count
+    const size_t CompactSlack = 16;
+    /**
+     * @brief Copy a[i] with bit i set to the front of out
+     * @return size_t Selected count. out must hold selected count + CompactSlack elements
+     */
+    template <class T>
+    size_t compact (const T* a, const unsigned long long* bits, T* out, size_t n) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (level()) {
+                case SIMD_AVX512: return compactAvx512<T>(a, bits, out, n);
+                case SIMD_AVX2: return compactAvx2<T>(a, bits, out, n);
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        // Branchless: every element is stored, the cursor only advances past selected ones
+        size_t k = 0;
+        for (size_t i = 0; i < n; i++) {
+            out[k] = a[i];
+            k += bits[i / 64] >> (i % 64) & 1;
+        }
+        return k;
+    }
+}
+/**
+ * @brief Indexing namespace with gather / scatter kernels behind Array::take() and Array::put()
+ */
+namespace Indexing {
+    // Prefetch distance in elements for random gathers over arrays larger than cache
+    const unsigned PrefetchDistance = 16;
+    const unsigned long long PrefetchMinBytes = 1ull << 22;
+    /**
+     * @brief Validate indices in one pass
+     * @param Idx Indices (negative counts from the end)
+     * @param n Index count
+     * @param size Size of indexed Array
+     * @return true if any index is negative (indices have to be normalized)
+     */
+    inline bool checkIndices (const int* Idx, unsigned n, unsigned size) {
+        long long lo = 0, hi = -1;
+        for (unsigned i = 0; i < n; i++) {
+            if (Idx[i] < lo) lo = Idx[i];
+            if (Idx[i] > hi) hi = Idx[i];
+        }
+        if (lo < -(long long) size || hi >= (long long) size) throw std::invalid_argument("Invalid Array Index!");
+        return lo < 0;
+    }
+    /**
+     * @brief Gather out[i] = src[Idx[i]] for valid, non-negative indices
+     */
+    template <class T>
+    void gather (T* out, const T* src, const int* Idx, unsigned n, unsigned size) {
+        bool prefetch = (unsigned long long) size * sizeof(T) >= PrefetchMinBytes;
+        // Hardware gathers beat scalar loads while the source fits in cache, past that the prefetching loop keeps more misses in flight
+        if constexpr (Simd::isKernelType<T>::value) {
+            if (!prefetch && Simd::level() >= Simd::SIMD_AVX2) {
+                Simd::gather(out, src, Idx, n);
+                return;
+            }
+        }
+        unsigned i = 0;
+        if (prefetch) {
+            for (; i + PrefetchDistance < n; i++) {
+                __builtin_prefetch(src + Idx[i + PrefetchDistance]);
+                out[i] = src[Idx[i]];
+            }
+        }
+        for (; i < n; i++) out[i] = src[Idx[i]];
     }
-    template<class T, class U> void show(const map<T, U> &Map, bool showType, bool fromRecursion) {
-        if (showType) cout<<"`Map` ";
-        cout<<"{";
-        for (typename map<T, U>::const_iterator it = Map.begin(); it != Map.end(); ++it) {
-            if (it != Map.cbegin()) cout<<", ";
-            show(it->first, showType, true);
-            cout<<": ";
-            show(it->second, showType, true);
+    /**
+     * @brief Scatter dst[Idx[i]] = values[i] (or values[0] when broadcast) for valid, non-negative indices
+     */
+    template <class T>
+    void scatter (T* dst, const T* values, const int* Idx, unsigned n, unsigned size, bool broadcast) {
+        unsigned i = 0;
+        if ((unsigned long long) size * sizeof(T) >= PrefetchMinBytes) {
+            for (; i + PrefetchDistance < n; i++) {
+                __builtin_prefetch(dst + Idx[i + PrefetchDistance], 1);
+                dst[Idx[i]] = values[broadcast ? 0 : i];
+            }
         }
-        cout<<"}";
-        if (!fromRecursion) cout<<endl;
+        for (; i < n; i++) dst[Idx[i]] = values[broadcast ? 0 : i];
     }
 }
+#ifdef BETTER_ARRAY_COW
+/**
+ * @brief Reference-counted vector with copy-on-write, used as Array storage with -DBETTER_ARRAY_COW
+ *
+ * Copies share one buffer, any non-const access first detaches a private copy if the buffer is shared.
+ * @warning References and iterators obtained through non-const access must not be kept across copies
+ *          of the owning Array - writing through them after the copy would affect both Arrays.
+ * @tparam T Any
+ */
+template <class T>
+class SharedBuffer {
+    private:
+        shared_ptr < Memory::Vector < T > > V;
+        Memory::Vector<T>& mut () {
+            if (this->V.use_count() > 1) this->V = make_shared<Memory::Vector<T>>(*this->V);
+            return *this->V;
+        }
+    public:
+        typedef typename Memory::Vector<T>::iterator iterator;
+        typedef typename Memory::Vector<T>::const_iterator const_iterator;
+        typedef typename Memory::Vector<T>::reference reference;
+        typedef typename Memory::Vector<T>::const_reference const_reference;
+        SharedBuffer () : V(make_shared<Memory::Vector<T>>()) {}
+        SharedBuffer (const SharedBuffer<T> &Other) = default;
+        SharedBuffer<T>& operator= (const SharedBuffer<T> &Other) = default;
+        /**
+         * @brief Check if buffer is shared with another Array
+         * @return true - Buffer is shared
+         */
+        bool shared () const {return V.use_count() > 1;}
+        // Read-only access (never copies)
+        size_t size () const {return V->size();}
+        size_t capacity () const {return V->capacity();}
+        const T* data () const {return V->data();}
+        const_reference operator[] (size_t i) const {return (*V)[i];}
+        const_reference at (size_t i) const {return V->at(i);}
+        const_iterator begin () const {return V->cbegin();}
+        const_iterator end () const {return V->cend();}
+        // Mutating access (detaches shared buffer first)
+        T* data () {return mut().data();}
+        reference operator[] (size_t i) {return mut()[i];}
+        reference at (size_t i) {return mut().at(i);}
+        iterator begin () {return mut().begin();}
+        iterator end () {return mut().end();}
+        void resize (size_t n) {mut().resize(n);}
+        void resize (size_t n, const T& Val) {mut().resize(n, Val);}
+        void reserve (size_t n) {mut().reserve(n);}
+        void shrink_to_fit () {mut().shrink_to_fit();}
+        void push_back (const T& Val) {mut().push_back(Val);}
+        void pop_back () {mut().pop_back();}
+        template <class... Args> iterator insert (const_iterator pos, Args&&... args) {
+            Memory::Vector<T> &W = mut();
+            return W.insert(W.cbegin() + (pos - W.cbegin()), forward<Args>(args)...);
+        }
+        iterator erase (const_iterator pos) {
+            Memory::Vector<T> &W = mut();
+            return W.erase(W.cbegin() + (pos - W.cbegin()));
+        }
+        iterator erase (const_iterator first, const_iterator last) {
+            Memory::Vector<T> &W = mut();
+            return W.erase(W.cbegin() + (first - W.cbegin()), W.cbegin() + (last - W.cbegin()));
+        }
+        template <class It> void assign (It first, It last) {
+            Memory::Vector<T> Fresh(first, last);
+            this->V = make_shared<Memory::Vector<T>>();
+            this->V->swap(Fresh);
+        }
+};
+#endif // BETTER_ARRAY_COW
 template <class T>
 // Main Array Class
 class Array {
+    template <class U> friend class Array;
+    template <class U, class G, bool S> friend class Lazy;
     private:
-        vector < T > A;
+        #ifdef BETTER_ARRAY_COW
+            SharedBuffer < T > A;       // Shared with copies until first mutation
+        #else
+            Memory::Vector < T > A;     // 64-byte aligned and padded (Memory namespace)
+        #endif // BETTER_ARRAY_COW
         unsigned S;
         int Idx (int index) const {
+            BA_COUNT_INDEX();
             if (index < -(int) (this->S) || index >= (int) this->S) throw std::invalid_argument("Invalid Array Index!");
             if (index >= 0) return index;
             return index + (int) this->S;
         }
-        void CheckRange (int From, int To) {
+        void putImpl (const Array<int> &Indices, const Array<T> &Values, bool broadcast) {
+            unsigned n = Indices.size();
+            const int* I = Indices.data();
+            Array<int> Normalized;
+            if (Indexing::checkIndices(I, n, this->S)) {
+                Normalized = Indices;
+                int* P = Normalized.data();
+                for (unsigned i = 0; i < n; i++) if (P[i] < 0) P[i] += (int) this->S;
+                I = P;
+            }
+            if constexpr (is_same<T, bool>::value) {
+                for (unsigned i = 0; i < n; i++) this->A[I[i]] = Values.A[broadcast ? 0 : i];
+            }
+            else Indexing::scatter(this->data(), Values.data(), I, n, this->S, broadcast);
+        }
+        // Inclusive scan. Parallel version is two-pass: blocks are scanned independently,
+        // then every block is shifted by the combined totals of preceding blocks
+        template <class Op>
+        Array<T> scan (Op op) const {
+            Array<T> X(this->S);
+            if (this->S == 0) return X;
+            T* out = X.data();
+            const T* in = this->data();
+            unsigned chunkCount = Parallel::chunks(this->S, 1u << 18);
+            vector<T> totals(chunkCount);
+            Parallel::forChunks(this->S, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                T acc = in[b];
+                out[b] = acc;
+                for (unsigned long long i = b + 1; i < e; i++) {
+                    acc = op(acc, in[i]);
+                    out[i] = acc;
+                }
+                totals[c] = acc;
+            });
+            if (chunkCount == 1) return X;
+            for (unsigned c = 1; c < chunkCount; c++) totals[c] = op(totals[c - 1], totals[c]);
+            Parallel::forChunks(this->S, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                if (c == 0) return;
+                const T offset = totals[c - 1];
+                for (unsigned long long i = b; i < e; i++) out[i] = op(offset, out[i]);
+            });
+            return X;
+        }
+        enum SetMode {SetUnion, SetIntersection, SetDifference};
+        static const unsigned BloomMinKeys = 1u << 16;
+        // Merge kernel over ascending inputs, runs of equal values are consumed at once
+        static Array<T> mergeSets (const Array<T> &L, const Array<T> &R, SetMode Mode) {
+            Array<T> X;
+            X.reserve(Mode == SetUnion ? L.S + R.S : L.S);
+            unsigned i = 0, j = 0;
+            auto run = [] (const Array<T> &Arr, unsigned &k) {
+                unsigned first = k;
+                while (k < Arr.S && !(Arr.A[first] < Arr.A[k])) k++;
+                return first;
+            };
+            while (i < L.S && j < R.S) {
+                if (L.A[i] < R.A[j]) {
+                    unsigned f = run(L, i);
+                    if (Mode != SetIntersection) X.pushBackUnchecked(L.A[f]);
+                }
+                else if (R.A[j] < L.A[i]) {
+                    unsigned f = run(R, j);
+                    if (Mode == SetUnion) X.pushBackUnchecked(R.A[f]);
+                }
+                else {
+                    unsigned f = run(L, i);
+                    run(R, j);
+                    if (Mode != SetDifference) X.pushBackUnchecked(L.A[f]);
+                }
+            }
+            while (Mode != SetIntersection && i < L.S) X.pushBackUnchecked(L.A[run(L, i)]);
+            while (Mode == SetUnion && j < R.S) X.pushBackUnchecked(R.A[run(R, j)]);
+            return X;
+        }
+        // Hash kernel keeping order of first appearance
+        static Array<T> hashSets (const Array<T> &L, const Array<T> &R, SetMode Mode) {
+            if (Mode == SetUnion) {
+                Hashing::KeyIndex<T> Index(L.S + R.S);
+                for (unsigned i = 0; i < L.S; i++) Index.insert(L.A[i]);
+                for (unsigned j = 0; j < R.S; j++) Index.insert(R.A[j]);
+                return Array<T>(Index.keyList());
+            }
+            Hashing::KeyIndex<T> Other(R.S), Seen;
+            for (unsigned j = 0; j < R.S; j++) Other.insert(R.A[j]);
+            Array<T> X;
+            for (unsigned i = 0; i < L.S; i++) {
+                unsigned long long h = Hashing::hashOf<T>(L.A[i]);
+                if ((Other.find(L.A[i], h) >= 0) != (Mode == SetIntersection)) continue;
+                unsigned before = Seen.size();
+                Seen.insert(L.A[i], h);
+                if (Seen.size() > before) X.append(L.A[i]);
+            }
+            return X;
+        }
+        Array<T> setOperation (const Array<T> &Other, SetMode Mode) const {
+            bool sorted = this->isSorted() && Other.isSorted();
+            if constexpr (is_same<T, int>::value) {
+                // Deduplicated sorted ints intersect with SIMD block compares
+                if (sorted && Mode == SetIntersection) {
+                    vector<int> L(this->A.begin(), this->A.end()), R(Other.A.begin(), Other.A.end());
+                    L.erase(std::unique(L.begin(), L.end()), L.end());
+                    R.erase(std::unique(R.begin(), R.end()), R.end());
+                    Array<int> X((unsigned) (L.size() < R.size() ? L.size() : R.size()));
+                    unsigned k = Hashing::intersectSorted(L.data(), L.size(), R.data(), R.size(), X.data());
+                    X.A.resize(k);
+                    X.S = k;
+                    return X;
+                }
+            }
+            if (sorted) return mergeSets(*this, Other, Mode);
+            if constexpr (Hashing::isHashable<T>::value) return hashSets(*this, Other, Mode);
+            else {
+                Array<T> L = *this, R = Other;
+                std::sort(L.A.begin(), L.A.end());
+                std::sort(R.A.begin(), R.A.end());
+                return mergeSets(L, R, Mode);
+            }
+        }
+        void CheckRange (int From, int To) const {
             int width = Idx(To) - Idx(From) + 1;
             if (width < 1 || width > (int) this->S) throw std::invalid_argument("Invalid From-To Range");
             return;
         }
+        #if defined(__GLIBCXX__)
+            // libstdc++ stores vector<bool> as packed words, Simd kernels read and write them in place
+            static constexpr bool packedMask = sizeof(std::_Bit_type) == sizeof(unsigned long long);
+            static unsigned long long* maskWords (ArrayMask &Mask) {return (unsigned long long*) Mask.A.begin()._M_p;}
+            static const unsigned long long* maskWords (const ArrayMask &Mask) {return (const unsigned long long*) Mask.A.begin()._M_p;}
+        #else
+            // Other standard libraries: kernels work on a word buffer, bits are copied to and from the mask with plain loops
+            static constexpr bool packedMask = false;
+            static unsigned long long* maskWords (ArrayMask &) {return NULL;}
+            static const unsigned long long* maskWords (const ArrayMask &) {return NULL;}
+        #endif // __GLIBCXX__
+        static constexpr bool kernelType = Simd::isKernelType<T>::value;
+        template <int O>
+        Array<T> kernelApply (const T* B, bool broadcast) const {
+            Array<T> X(this->S);
+            if (broadcast) Simd::binary<O, true>(this->data(), B, X.data(), this->S);
+            else Simd::binary<O, false>(this->data(), B, X.data(), this->S);
+            return X;
+        }
+        template <int C>
+        ArrayMask kernelCompare (const T* B, bool broadcast, unsigned n, unsigned size) const {
+            ArrayMask X(size);
+            if constexpr (packedMask) {
+                if (broadcast) Simd::compare<C, true>(this->data(), B, maskWords(X), n);
+                else Simd::compare<C, false>(this->data(), B, maskWords(X), n);
+            }
+            else {
+                vector<unsigned long long> W((n + 63) / 64);
+                if (broadcast) Simd::compare<C, true>(this->data(), B, W.data(), n);
+                else Simd::compare<C, false>(this->data(), B, W.data(), n);
+                for (unsigned i = 0; i < n; i++) X.A[i] = W[i / 64] >> (i % 64) & 1;
+            }
+            return X;
+        }
     public:
         // CONSTRUCTORS
         /**
@@ -149,6 +1806,7 @@ class Array {
          * @param s Size of new array
          */
         explicit Array (unsigned s) {
+            BA_COUNT_ALLOC((unsigned long long) s * sizeof(T));
             this->S = s;
             this->A.resize(this->S);
         }
@@ -158,6 +1816,7 @@ class Array {
          * @param STL_Vector Initializing Vector
          */
         explicit Array (const vector < T > &STL_Vector) {
+            BA_COUNT_COPY((unsigned long long) STL_Vector.size() * sizeof(T));
             this->S = STL_Vector.size();
             this->A.resize(this->S);
             for (unsigned i = 0; i < this->S; i++) this->A[i] = STL_Vector[i];
@@ -169,6 +1828,7 @@ class Array {
          */
         explicit Array (const list < T > &STL_List) {
             this->S = STL_List.size();
+            this->A.reserve(this->S);
             for (auto it = STL_List.cbegin(); it != STL_List.cend(); it++) this->A.push_back(*it);
         }
         /**
@@ -178,6 +1838,7 @@ class Array {
          * @param arraySize Array Size
          */
         Array (const T* dynamicArray, unsigned arraySize) {
+            BA_COUNT_COPY((unsigned long long) arraySize * sizeof(T));
             this->S = arraySize;
             this->A.resize(this->S);
             for (unsigned i = 0; i < this->S; i++) this->A[i] = dynamicArray[i];
@@ -189,6 +1850,7 @@ class Array {
          */
         explicit Array (const set < T > &STL_Set) {
             this->S = STL_Set.size();
+            this->A.reserve(this->S);
             for (auto it = STL_Set.cbegin(); it != STL_Set.cend(); it++) this->A.push_back(*it);
         }
         /**
@@ -198,12 +1860,23 @@ class Array {
          */
         explicit Array (initializer_list<T> InitValues) {
             this->S = 0;
-            this->A.resize(this->S);
+            this->A.reserve(InitValues.size());
             for (auto it = InitValues.begin(); it != InitValues.end(); ++it) {
                 this->S++;
                 this->A.push_back(*it);
             }
         }
+        #ifdef BETTER_ARRAY_PROFILE
+            Array (const Array<T> &Other) : A(Other.A), S(Other.S) { BA_COUNT_COPY((unsigned long long) S * sizeof(T)); }
+            Array (Array<T> &&Other) = default;
+            Array<T>& operator= (const Array<T> &Other) {
+                BA_COUNT_COPY((unsigned long long) Other.S * sizeof(T));
+                this->A = Other.A;
+                this->S = Other.S;
+                return *this;
+            }
+            Array<T>& operator= (Array<T> &&Other) = default;
+        #endif // BETTER_ARRAY_PROFILE
         // FUNCTIONS
         /**
          * @brief Get the size of an Array
@@ -211,12 +1884,43 @@ class Array {
          */
         unsigned size () {return this->S;}
         unsigned size () const {return S;}
+        /**
+         * @brief Get pointer to underlying contiguous storage
+         * @return T* Pointer to first element
+         */
+        T* data () {return this->A.data();}
+        const T* data () const {return A.data();}
+        /**
+         * @brief Get number of elements Array can hold without reallocation
+         * @return unsigned Capacity
+         */
+        unsigned capacity () const {return A.capacity();}
+        /**
+         * @brief Reserve storage for at least given number of elements
+         * @param n Minimal capacity
+         */
+        void reserve (unsigned n) {
+            BA_TRACK_GROWTH(this->A, sizeof(T), this->A.reserve(n));
+        }
+        /**
+         * @brief Release unused capacity
+         */
+        void shrinkToFit () {this->A.shrink_to_fit();}
+        /**
+         * @brief Add element to the end of an Array without growth bookkeeping
+         * @param Elem
+         * @warning Capacity must be reserved beforehand (capacity() > size())
+         */
+        void pushBackUnchecked (const T& Elem) {
+            this->A.push_back(Elem);
+            this->S++;
+        }
         /**
          * @brief Show Array
          * @param showType Default to false: If true - it additionally shows type
          */
-        void show (bool showType = false) {
-            Container::show(Array<T>(this->A), showType);
+        void show (bool showType = false) const {
+            Container::show(*this, showType);
         }
         /**
          * @brief Add element to the end of an Array
@@ -224,16 +1928,22 @@ class Array {
          */
         void append (const T& Elem) {
             this->S++;
-            this->A.push_back(Elem);
+            BA_TRACK_GROWTH(this->A, sizeof(T), this->A.push_back(Elem));
         }
         /**
          * @brief Add another Array to the end of an Array
          * @param arr 
          */
-        void append (Array <T> arr) {
+        void append (const Array <T> &arr) {
+            if (&arr == this) {
+                Array<T> Copy(arr);
+                append(Copy);
+                return;
+            }
+            if (this->A.capacity() < this->S + arr.S) reserve(MAX_S(this->S + arr.S, 2 * this->S));
             for (unsigned i = 0; i < arr.size(); i++) {
                 this->S++;
-                this->A.push_back(arr[i]);
+                BA_TRACK_GROWTH(this->A, sizeof(T), this->A.push_back(arr[i]));
             }
         }
         /**
@@ -242,9 +1952,10 @@ class Array {
          * @param Values Initializer list
          */
         void append (initializer_list<T> Values) {
+            if (this->A.capacity() < this->S + Values.size()) reserve(MAX_S(this->S + (unsigned) Values.size(), 2 * this->S));
             for (auto it = Values.begin(); it != Values.end(); ++it) {
                 this->S++;
-                this->A.push_back(*it);
+                BA_TRACK_GROWTH(this->A, sizeof(T), this->A.push_back(*it));
             }
         }
         /**
@@ -262,33 +1973,42 @@ class Array {
          * @param Elem
          */
         void insert (int Where, T Elem) {
+            BA_PROFILE_SCOPE("Array::insert");
             this->S++;
-            this->A.insert(this->A.begin() + Idx(Where), Elem);
+            BA_TRACK_GROWTH(this->A, sizeof(T), this->A.insert(this->A.begin() + Idx(Where), Elem));
         }
         /**
          * @brief Insert another Array begging from n-th index to Array
          * @param Where n-th index (negative index supported)
          * @param arr Array
          */
-        void insert (int Where, Array<T> arr) {
-            for (int i = 0; i < arr.size(); i++) {
-                this->S++;
-                this->A.insert(this->A.begin() + Idx(Where) + i, arr[i]);
+        void insert (int Where, const Array<T> &arr) {
+            BA_PROFILE_SCOPE("Array::insert");
+            if (arr.S == 0) return;
+            if (&arr == this) {
+                Array<T> Copy(arr);
+                insert(Where, Copy);
+                return;
             }
+            this->S++;
+            int at = Idx(Where);
+            this->S += arr.S - 1;
+            BA_TRACK_GROWTH(this->A, sizeof(T), this->A.insert(this->A.begin() + at, arr.A.begin(), arr.A.end()));
         }
         void insert (int Where, initializer_list<T> Values) {
-            int i = 0;
-            for (auto it = Values.begin(); it != Values.end(); ++it) {
-                this->S++;
-                this->A.insert(this->A.begin() + Idx(Where) + i, *it);
-                i++;
-            }
+            BA_PROFILE_SCOPE("Array::insert");
+            if (Values.size() == 0) return;
+            this->S++;
+            int at = Idx(Where);
+            this->S += Values.size() - 1;
+            BA_TRACK_GROWTH(this->A, sizeof(T), this->A.insert(this->A.begin() + at, Values.begin(), Values.end()));
         }
         /**
          * @brief Remove element at n-th index from Array
          * @param Which n-th index (negative index supported)
          */
         void erase (int Which) {
+            BA_PROFILE_SCOPE("Array::erase");
             if (this->S > 0) {
                 this->A.erase(this->A.begin() + Idx(Which));
                 this->S--;
@@ -300,12 +2020,11 @@ class Array {
          * @param To j-th index (negative index supported, j >= i)
          */
         void erase (int From, int To) {
+            BA_PROFILE_SCOPE("Array::erase");
             CheckRange(From, To);
-            int width = Idx(To) - Idx(From) + 1;
-            for (int i = 0; i < width; i++) {
-                this->A.erase(this->A.begin() + Idx(From));
-                this->S--;
-            }
+            int first = Idx(From), width = Idx(To) - first + 1;
+            this->A.erase(this->A.begin() + first, this->A.begin() + first + width);
+            this->S -= width;
         }
         /**
          * @brief Reverse elements in Array
@@ -320,14 +2039,35 @@ class Array {
          * @param Mask vector<bool> type mask
          * @return Array<T> Masked Array
          */
-        Array<T> masked (const ArrayMask &Mask) {
-            Array<T> X;
-            for (unsigned i = 0; i < this->S; i++) {
-                if (i >= Mask.size()) X.append(this->A[i]);
+        Array<T> masked (const ArrayMask &Mask) const {
+            BA_PROFILE_SCOPE("Array::masked");
+            unsigned masked_size = Mask.size() < this->S ? Mask.size() : this->S;
+            if constexpr (kernelType) {
+                const unsigned long long* W;
+                vector<unsigned long long> Packed;
+                if constexpr (packedMask) W = maskWords(Mask);
                 else {
-                    if (Mask[i]) X.append(this->A[i]);
+                    Packed.assign(masked_size / 64 + 1, 0);
+                    for (unsigned i = 0; i < masked_size; i++) Packed[i / 64] |= (unsigned long long) Mask.A[i] << (i % 64);
+                    W = Packed.data();
                 }
+                unsigned selected = this->S - masked_size;
+                for (unsigned w = 0; w < masked_size / 64; w++) selected += __builtin_popcountll(W[w]);
+                if (masked_size % 64) selected += __builtin_popcountll(W[masked_size / 64] & ((1ull << (masked_size % 64)) - 1));
+                Array<T> X;
+                X.A.resize(selected + Simd::CompactSlack);
+                unsigned k = (unsigned) Simd::compact(this->data(), W, X.data(), masked_size);
+                if (masked_size < this->S) memcpy(X.data() + k, this->data() + masked_size, (this->S - masked_size) * sizeof(T));
+                X.A.resize(selected);
+                X.S = selected;
+                return X;
             }
+            unsigned selected = this->S - masked_size;
+            for (unsigned i = 0; i < masked_size; i++) selected += Mask.A[i];
+            Array<T> X;
+            X.reserve(selected);
+            for (unsigned i = 0; i < masked_size; i++) if (Mask.A[i]) X.pushBackUnchecked(this->A[i]);
+            for (unsigned i = masked_size; i < this->S; i++) X.pushBackUnchecked(this->A[i]);
             return X;
         }
         /**
@@ -335,7 +2075,8 @@ class Array {
          * @param custom_comparator Comparator function. Must return bool, must have one argument (which is considered as array element)
          * @return Array<T> Masked Array
          */
-        Array<T> masked (bool (*custom_comparator)(T)) {
+        Array<T> masked (bool (*custom_comparator)(T)) const {
+            BA_PROFILE_SCOPE("Array::masked");
             Array<T> X;
             for (unsigned i = 0; i < this->S; i++) {
                 if (custom_comparator(this->A[i])) X.append(this->A[i]);
@@ -348,9 +2089,10 @@ class Array {
          * @param To End Index (Inclusive). Default to Array End
          * @return T MAX
          */
-        T max (int From = ArrayBegin, int To = ArrayEnd) {
+        T max (int From = ArrayBegin, int To = ArrayEnd) const {
             if (To == ArrayEnd && (int) this->S < ArrayEnd) To = this->S - 1;
             CheckRange(From, To);
+            if constexpr (kernelType) return Simd::extreme<true>(this->data() + Idx(From), Idx(To) - Idx(From) + 1);
             T M = this->A[Idx(From)];
             for (unsigned i = Idx(From) + 1; i <= Idx(To); i++) if (this->A[i] > M) M = this->A[i];
             return M;
@@ -361,9 +2103,10 @@ class Array {
          * @param To End Index (Inclusive). Default to Array End
          * @return T MIN
          */
-        T min (int From = ArrayBegin, int To = ArrayEnd) {
+        T min (int From = ArrayBegin, int To = ArrayEnd) const {
             if (To == ArrayEnd && (int) this->S < ArrayEnd) To = this->S - 1;
             CheckRange(From, To);
+            if constexpr (kernelType) return Simd::extreme<false>(this->data() + Idx(From), Idx(To) - Idx(From) + 1);
             T M = this->A[Idx(From)];
             for (unsigned i = Idx(From) + 1; i <= Idx(To); i++) if (this->A[i] < M) M = this->A[i];
             return M;
@@ -374,12 +2117,16 @@ class Array {
          * @param To End Index (Inclusive). Default to Array End
          * @return Array<int> Maximum indices Array
          */
-        Array<int> argmax (int From = ArrayBegin, int To = ArrayEnd) {
+        Array<int> argmax (int From = ArrayBegin, int To = ArrayEnd) const {
+            BA_PROFILE_SCOPE("Array::argmax");
             if (To == ArrayEnd && (int) this->S < ArrayEnd) To = this->S - 1;
             CheckRange(From, To);
             T M = this->max(From, To);
+            unsigned first = Idx(From), last = Idx(To), found = 0;
+            for (unsigned i = first; i <= last; i++) found += (this->A[i] == M);
             Array<int> X;
-            for (unsigned i = Idx(From); i <= Idx(To); i++) if (this->A[i] == M) X.append(i);
+            X.reserve(found);
+            for (unsigned i = first; i <= last; i++) if (this->A[i] == M) X.pushBackUnchecked(i);
             return X;
         }
         /**
@@ -388,25 +2135,31 @@ class Array {
          * @param To End Index (Inclusive). Default to Array End
          * @return Array<int> Minimum indices Array
          */
-        Array<int> argmin (int From = ArrayBegin, int To = ArrayEnd) {
+        Array<int> argmin (int From = ArrayBegin, int To = ArrayEnd) const {
+            BA_PROFILE_SCOPE("Array::argmin");
             if (To == ArrayEnd && (int) this->S < ArrayEnd) To = this->S - 1;
             CheckRange(From, To);
             T M = this->min(From, To);
+            unsigned first = Idx(From), last = Idx(To), found = 0;
+            for (unsigned i = first; i <= last; i++) found += (this->A[i] == M);
             Array<int> X;
-            for (unsigned i = Idx(From); i <= Idx(To); i++) if (this->A[i] == M) X.append(i);
+            X.reserve(found);
+            for (unsigned i = first; i <= last; i++) if (this->A[i] == M) X.pushBackUnchecked(i);
             return X;
         }
         /**
-         * @brief Get average of Array
+         * @brief Get average of Array. Arithmetic types are summed by Simd::sum(), so float and double averages
+         *        may differ from a sequential sum in the last bits
          * @param From Starting Index (Inclusive). Default to 0
          * @param To End Index (Inclusive). Default to Array End
          * @return double Average
          */
-        double mean (int From = ArrayBegin, int To = ArrayEnd) {
+        double mean (int From = ArrayBegin, int To = ArrayEnd) const {
             if (To == ArrayEnd && (int) this->S < ArrayEnd) To = this->S - 1;
             CheckRange(From, To);
             double M = 0.0;
             int range = Idx(To) - Idx(From) + 1;
+            if constexpr (kernelType) return Simd::sum(this->data() + Idx(From), range) / (double) (range);
             for (unsigned i = Idx(From); i <= Idx(To); i++) M += (double) this->A[i];
             return M / (double) (range);
         }
@@ -416,11 +2169,13 @@ class Array {
          * @param To End Index (Inclusive). Default to Array End
          * @return Array<T> Array Slice
          */
-        Array<T> slice (int From = ArrayBegin, int To = ArrayEnd) {
+        Array<T> slice (int From = ArrayBegin, int To = ArrayEnd) const {
+            BA_PROFILE_SCOPE("Array::slice");
             if (To == ArrayEnd && (int) this->S < ArrayEnd) To = this->S - 1;
             CheckRange(From, To);
             Array<T> X;
-            for (unsigned i = Idx(From); i <= Idx(To); i++) X.append(this->A[i]);
+            X.A.assign(this->A.begin() + Idx(From), this->A.begin() + Idx(To) + 1);
+            X.S = X.A.size();
             return X;
         }
         /**
@@ -430,6 +2185,7 @@ class Array {
          * @param To End Index (Inclusive). Default to Array End
          */
         void sort (Order SOrder = ASC, int From = ArrayBegin, int To = ArrayEnd) {
+            BA_PROFILE_SCOPE("Array::sort");
             if (To == ArrayEnd && (int) this->S < ArrayEnd) To = this->S - 1;
             unsigned i_max = Idx(To) - Idx(From);
             for (unsigned i = 0; i < i_max; i++) {
@@ -443,6 +2199,73 @@ class Array {
                 if (!swapped) break;
             }
         }
+        /**
+         * @brief Gather elements by index, e.g. A.take(A.findAll(x))
+         * @param Indices Indices (negative counts from the end), may repeat. Bounds are checked once for all indices
+         * @return Array<T> X where X[i] = A[Indices[i]]
+         */
+        Array<T> take (const Array<int> &Indices) const {
+            BA_PROFILE_SCOPE("Array::take");
+            unsigned n = Indices.size();
+            const int* I = Indices.data();
+            Array<int> Normalized;
+            if (Indexing::checkIndices(I, n, this->S)) {
+                Normalized = Indices;
+                int* P = Normalized.data();
+                for (unsigned i = 0; i < n; i++) if (P[i] < 0) P[i] += (int) this->S;
+                I = P;
+            }
+            if constexpr (is_same<T, bool>::value) {
+                Array<T> X;
+                X.reserve(n);
+                for (unsigned i = 0; i < n; i++) X.pushBackUnchecked(this->A[I[i]]);
+                return X;
+            }
+            else {
+                Array<T> X(n);
+                T* out = X.data();
+                const T* src = this->data();
+                unsigned chunkCount = Parallel::chunks(n, 1u << 16);
+                Parallel::forChunks(n, chunkCount, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                    Indexing::gather(out + b, src, I + b, (unsigned) (e - b), this->S);
+                });
+                return X;
+            }
+        }
+        /**
+         * @brief Scatter values to indices. With repeated indices the last value wins
+         * @param Indices Indices (negative counts from the end). Bounds are checked once before writing
+         * @param Values Values, same length as Indices
+         */
+        void put (const Array<int> &Indices, const Array<T> &Values) {
+            BA_PROFILE_SCOPE("Array::put");
+            if (Indices.size() != Values.size()) throw std::invalid_argument("Indices and Values length must be the same!");
+            putImpl(Indices, Values, false);
+        }
+        /**
+         * @brief Set value at every index
+         * @param Indices Indices (negative counts from the end). Bounds are checked once before writing
+         * @param Value
+         */
+        void put (const Array<int> &Indices, const T& Value) {
+            BA_PROFILE_SCOPE("Array::put");
+            putImpl(Indices, Array<T>({Value}), true);
+        }
+        /**
+         * @brief Get index permutation that sorts an Array (stable, equal values keep their order)
+         * @param SOrder ASCending = 1, DESCending = -1. Default ASC
+         * @return Array<int> Indices of elements in sorted order
+         */
+        Array<int> argsort (Order SOrder = ASC) const {
+            BA_PROFILE_SCOPE("Array::argsort");
+            Array<int> X(this->S);
+            int* P = X.data();
+            for (unsigned i = 0; i < this->S; i++) P[i] = (int) i;
+            const Array<T> &Self = *this;
+            if (SOrder == ASC) stable_sort(P, P + this->S, [&Self] (int a, int b) {return Self.A[a] < Self.A[b];});
+            else stable_sort(P, P + this->S, [&Self] (int a, int b) {return Self.A[b] < Self.A[a];});
+            return X;
+        }
         /**
          * @brief Sorts an Array using custom comparison function
          * @param sorting_comparator Comparator function. Must return bool, must have two arguments (which are first and second element in order)
@@ -450,6 +2273,7 @@ class Array {
          * @param To End Index (Inclusive). Default to Array End
          */
         void sort (bool (*sorting_comparator)(T, T), int From = ArrayBegin, int To = ArrayEnd) {
+            BA_PROFILE_SCOPE("Array::sort");
             if (To == ArrayEnd && (int) this->S < ArrayEnd) To = this->S - 1;
             unsigned i_max = Idx(To) - Idx(From);
             for (unsigned i = 0; i < i_max; i++) {
@@ -486,7 +2310,7 @@ class Array {
          * @param Count_Val Counted Value
          * @return unsigned Value Count
          */
-        unsigned count (const T& Count_Val) {
+        unsigned count (const T& Count_Val) const {
             unsigned cnt = 0;
             for (unsigned i = 0; i < this->S; i++) if (this->A[i] == Count_Val) cnt++;
             return cnt;
@@ -497,7 +2321,7 @@ class Array {
          * @return true - Value found
          * @return false - Value not found
          */
-        bool contains (const T& Val) {
+        bool contains (const T& Val) const {
             for (unsigned i = 0; i < this->S; i++) if (this->A[i] == Val) return true;
             return false;
         }
@@ -507,7 +2331,7 @@ class Array {
          * @return true - Sub-Array found
          * @return false - Sub-Array not found
          */
-        bool contains (const Array <T> &SubArray) {
+        bool contains (const Array <T> &SubArray) const {
             if (this->S < SubArray.S) return false;
             int current_search = 0;
             for (unsigned i = 0; i < this->S; i++) {
@@ -524,7 +2348,7 @@ class Array {
          * @return true
          * @return false 
          */
-        bool contains (initializer_list<T> Values) {
+        bool contains (initializer_list<T> Values) const {
             if (this->S < Values.size()) return false;
             Array<T> SubArray(Values);
             int current_search = 0;
@@ -533,112 +2357,439 @@ class Array {
                 else current_search = 0;
                 if (current_search == SubArray.S) return true;
             }
-            return false;
+            return false;
+        }
+        /**
+         * @brief Find array index of first value occurance
+         * @param Val Value to be searched for
+         * @return int - first found index, if not found it returns ArrayEnd = 2147483647
+         */
+        int find (const T& Val) const {
+            for (unsigned i = 0; i < this->S; i++) if (this->A[i] == Val) return i;
+            return ArrayEnd;
+        }
+        /**
+         * @brief Find array index of first Sub-Array occurance
+         * @param SubArray Sub-Array to be searched for
+         * @return int - first found index, if not found it returns ArrayEnd = 2147483647
+         */
+        int find (const Array <T> &SubArray) const {
+            if (this->S < SubArray.S);
+            int current_search = 0, found_index = 0;
+            for (unsigned i = 0; i < this->S; i++) {
+                if (current_search == 0) found_index = i;
+                if (this->A[i] == SubArray[current_search]) current_search++;
+                else current_search = 0;
+                if (current_search == SubArray.S) return found_index;
+            }
+            return ArrayEnd;
+        }
+        /**
+         * @brief Find array index of first values list occurance
+         * @param Values Values list to be searched for
+         * @return int - first found index, if not found it returns ArrayEnd = 2147483647
+         */
+        int find (initializer_list<T> Values) const {
+            if (this->S < Values.size()) return false;
+            Array<T> SubArray(Values);
+            int current_search = 0, found_index = 0;
+            for (unsigned i = 0; i < this->S; i++) {
+                if (current_search == 0) found_index = i;
+                if (this->A[i] == SubArray[current_search]) current_search++;
+                else current_search = 0;
+                if (current_search == SubArray.S) return found_index;
+            }
+            return ArrayEnd;
+        }
+        /**
+         * @brief Find all array indices where value occurs
+         * @param Val Value to be searched for
+         * @return Array<int> Array of indices
+         */
+        Array<int> findAll (const T& Val) const {
+            BA_PROFILE_SCOPE("Array::findAll");
+            Array<int> X;
+            X.reserve(count(Val));
+            for (unsigned i = 0; i < this->S; i++) if (this->A[i] == Val) X.pushBackUnchecked(i);
+            return X;
+        }
+        /**
+         * @brief Find all array indices where sub-array begins
+         * @param SubArray Sub-Array to be searched for
+         * @return Array<int> Array of indices
+         */
+        Array<int> findAll (const Array <T> &SubArray) const {
+            BA_PROFILE_SCOPE("Array::findAll");
+            Array<int> X;
+            if (this->S < SubArray.S) return X;
+            int current_search = 0, iter_index = 0;
+            for (unsigned i = 0; i < this->S; i++) {
+                if (current_search == 0) iter_index = i;
+                if (this->A[i] == SubArray[current_search]) current_search++;
+                else current_search = 0;
+                if (current_search == SubArray.S) {
+                    X.append(iter_index);
+                    current_search = 0;
+                }
+            }
+            return X;
+        }
+        /**
+         * @brief Find all array indices where value list begins
+         * @param Values Value list to be searched for
+         * @return Array<int> Array of indices
+         */
+        Array<int> findAll (initializer_list<T> Values) const {
+            BA_PROFILE_SCOPE("Array::findAll");
+            Array<int> X;
+            if (this->S < Values.size()) return X;
+            Array<T> SubArray(Values);
+            int current_search = 0, iter_index = 0;
+            for (unsigned i = 0; i < this->S; i++) {
+                if (current_search == 0) iter_index = i;
+                if (this->A[i] == SubArray[current_search]) current_search++;
+                else current_search = 0;
+                if (current_search == SubArray.S) {
+                    X.append(iter_index);
+                    current_search = 0;
+                }
+            }
+            return X;
+        }
+        /**
+         * @brief Return Array with removed duplicates
+         * @return Array<T> 
+         */
+        Array<T> unique () const {
+            BA_PROFILE_SCOPE("Array::unique");
+            Array<T> X;
+            X.reserve(this->S);
+            for (unsigned i = 0; i < this->S; i++) {
+                if (!X.contains(this->A[i])) X.pushBackUnchecked(this->A[i]);
+            }
+            if (X.S < X.A.capacity() / 2) X.shrinkToFit();
+            return X;
+        }
+        /**
+         * @brief Check if Array is sorted
+         * @param SOrder ASCending = 1, DESCending = -1. Default ASC
+         * @return true if every element is in order with the next one
+         */
+        bool isSorted (Order SOrder = ASC) const {
+            for (unsigned i = 1; i < this->S; i++) {
+                if (SOrder == ASC ? this->A[i] < this->A[i - 1] : this->A[i - 1] < this->A[i]) return false;
+            }
+            return true;
+        }
+        /**
+         * @brief Get distinct values present in either Array
+         * @param Other
+         * @return Array<T> Ascending if both Arrays are sorted, otherwise in order of first appearance (this, then Other)
+         */
+        Array<T> setUnion (const Array<T> &Other) const {
+            BA_PROFILE_SCOPE("Array::setUnion");
+            return setOperation(Other, SetUnion);
+        }
+        /**
+         * @brief Get distinct values present in both Arrays
+         * @param Other
+         * @return Array<T> Ascending if both Arrays are sorted, otherwise in order of first appearance
+         */
+        Array<T> setIntersection (const Array<T> &Other) const {
+            BA_PROFILE_SCOPE("Array::setIntersection");
+            return setOperation(Other, SetIntersection);
+        }
+        /**
+         * @brief Get distinct values present in this Array but not in Other
+         * @param Other
+         * @return Array<T> Ascending if both Arrays are sorted, otherwise in order of first appearance
+         */
+        Array<T> setDifference (const Array<T> &Other) const {
+            BA_PROFILE_SCOPE("Array::setDifference");
+            return setOperation(Other, SetDifference);
+        }
+        /**
+         * @brief Test membership of every element in Values
+         * @param Values Reference values. Large references are prefiltered with a bloom filter
+         * @return ArrayMask X where X[i] = Values contains A[i]
+         */
+        ArrayMask isin (const Array<T> &Values) const {
+            BA_PROFILE_SCOPE("Array::isin");
+            vector<unsigned char> found(this->S, 0);
+            if constexpr (Hashing::isHashable<T>::value) {
+                Hashing::KeyIndex<T> Index(Values.S);
+                for (unsigned j = 0; j < Values.S; j++) Index.insert(Values.A[j]);
+                // Membership misses in a table larger than cache cost a cache miss each, the filter answers most of them
+                const bool useBloom = Index.size() >= BloomMinKeys;
+                Hashing::BloomFilter Bloom(useBloom ? Index.size() : 0);
+                if (useBloom) for (unsigned k = 0; k < Index.size(); k++) Bloom.add(Hashing::hashOf<T>(Index.keyList()[k]));
+                unsigned chunkCount = Parallel::chunks(this->S, 1u << 16);
+                Parallel::forChunks(this->S, chunkCount, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                    for (unsigned long long i = b; i < e; i++) {
+                        unsigned long long h = Hashing::hashOf<T>(this->A[i]);
+                        if (useBloom && !Bloom.mayContain(h)) continue;
+                        found[i] = Index.find(this->A[i], h) >= 0;
+                    }
+                });
+            }
+            else {
+                Array<T> Sorted = Values;
+                std::sort(Sorted.A.begin(), Sorted.A.end());
+                for (unsigned i = 0; i < this->S; i++) found[i] = binary_search(Sorted.A.begin(), Sorted.A.end(), this->A[i]);
+            }
+            ArrayMask X;
+            X.reserve(this->S);
+            for (unsigned i = 0; i < this->S; i++) X.pushBackUnchecked(found[i] != 0);
+            return X;
+        }
+        /**
+         * @brief Get k-th smallest (ASC) or largest (DESC) element without sorting (introselect, O(n) on average)
+         * @param k Rank, 0-based
+         * @param SOrder ASCending = 1, DESCending = -1. Default ASC
+         * @return T Element that would be at index k after sort(SOrder)
+         */
+        T nthElement (unsigned k, Order SOrder = ASC) const {
+            BA_PROFILE_SCOPE("Array::nthElement");
+            if (k >= this->S) throw std::invalid_argument("Invalid Array Index!");
+            vector<T> V(this->A.begin(), this->A.end());
+            if (SOrder == ASC) std::nth_element(V.begin(), V.begin() + k, V.end());
+            else std::nth_element(V.begin(), V.begin() + k, V.end(), [] (const T& a, const T& b) {return b < a;});
+            return V[k];
+        }
+        /**
+         * @brief Sort only first k positions of an Array, order of remaining elements is unspecified
+         * @param k Number of leading elements to sort (clamped to Array size)
+         * @param SOrder ASCending = 1, DESCending = -1. Default ASC
+         */
+        void partialSort (unsigned k, Order SOrder = ASC) {
+            BA_PROFILE_SCOPE("Array::partialSort");
+            if (k > this->S) k = this->S;
+            if (SOrder == ASC) std::partial_sort(this->A.begin(), this->A.begin() + k, this->A.end());
+            else std::partial_sort(this->A.begin(), this->A.begin() + k, this->A.end(), [] (const T& a, const T& b) {return b < a;});
+        }
+        /**
+         * @brief Get indices of k largest (DESC) or smallest (ASC) elements
+         * @param k Number of elements (clamped to Array size)
+         * @param SOrder DESCending = -1 for largest first, ASCending = 1 for smallest first. Default DESC
+         * @return Array<int> Indices in SOrder, equal values ordered by index
+         */
+        Array<int> argtopk (unsigned k, Order SOrder = DESC) const {
+            BA_PROFILE_SCOPE("Array::argtopk");
+            if (k > this->S) k = this->S;
+            const Array<T> &Self = *this;
+            // first(a, b): element a goes before element b in the result
+            auto first = [&Self, SOrder] (int a, int b) {
+                if (Self.A[a] < Self.A[b]) return SOrder == ASC;
+                if (Self.A[b] < Self.A[a]) return SOrder == DESC;
+                return a < b;
+            };
+            Array<int> X;
+            if (k == 0) return X;
+            vector<int> P;
+            if ((unsigned long long) k * 64 <= this->S) {
+                // Small k: bounded heap whose top is the worst kept element, O(n log k)
+                P.reserve(k);
+                for (unsigned i = 0; i < this->S; i++) {
+                    if (P.size() < k) {
+                        P.push_back((int) i);
+                        push_heap(P.begin(), P.end(), first);
+                    }
+                    else if (first((int) i, P.front())) {
+                        pop_heap(P.begin(), P.end(), first);
+                        P.back() = (int) i;
+                        push_heap(P.begin(), P.end(), first);
+                    }
+                }
+            }
+            else {
+                P.resize(this->S);
+                for (unsigned i = 0; i < this->S; i++) P[i] = (int) i;
+                std::nth_element(P.begin(), P.begin() + (k - 1), P.end(), first);
+                P.resize(k);
+            }
+            std::sort(P.begin(), P.end(), first);
+            X = Array<int>(P);
+            return X;
+        }
+        /**
+         * @brief Get k largest (DESC) or smallest (ASC) elements
+         * @param k Number of elements (clamped to Array size)
+         * @param SOrder DESCending = -1 for largest first, ASCending = 1 for smallest first. Default DESC
+         * @return Array<T> Values in SOrder
+         */
+        Array<T> topk (unsigned k, Order SOrder = DESC) const {return this->take(argtopk(k, SOrder));}
+        /**
+         * @brief Get quantile with linear interpolation between closest ranks (same as NumPy default)
+         * @param q Quantile in range [0, 1]
+         * @return double
+         */
+        double quantile (double q) const {
+            BA_PROFILE_SCOPE("Array::quantile");
+            if (this->S == 0) throw std::invalid_argument("Empty Array!");
+            if (!(q >= 0.0 && q <= 1.0)) throw std::invalid_argument("Quantile must be in range [0, 1]!");
+            vector<T> V(this->A.begin(), this->A.end());
+            double pos = q * (this->S - 1);
+            unsigned lo = (unsigned) floor(pos);
+            std::nth_element(V.begin(), V.begin() + lo, V.end());
+            double a = (double) V[lo];
+            if (lo + 1 >= this->S || pos == (double) lo) return a;
+            double b = (double) *std::min_element(V.begin() + lo + 1, V.end());
+            return a + (b - a) * (pos - lo);
+        }
+        /**
+         * @brief Get median
+         * @return double Middle element or average of two middle elements
+         */
+        double median () const {return quantile(0.5);}
+        /**
+         * @brief Get count, mean, squared deviations, min and max in one pass (parallel for large Arrays)
+         * @return Stats::Moments Mergeable state, e.g. to combine chunks of Files::readChunks
+         */
+        Stats::Moments moments () const {
+            BA_PROFILE_SCOPE("Array::moments");
+            unsigned chunkCount = Parallel::chunks(this->S, 1u << 16);
+            vector<Stats::Moments> partial(chunkCount);
+            const T* D = this->data();
+            Parallel::forChunks(this->S, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                partial[c].add(D + b, e - b);
+            });
+            for (unsigned c = 1; c < chunkCount; c++) partial[0].merge(partial[c]);
+            return partial[0];
+        }
+        /**
+         * @brief Get variance (single-pass blocked Welford)
+         * @param ddof Delta degrees of freedom (0 = population, 1 = sample). Default 0
+         * @return double
+         */
+        double var (unsigned ddof = 0) const {return moments().var(ddof);}
+        /**
+         * @brief Get standard deviation (single-pass blocked Welford)
+         * @param ddof Delta degrees of freedom (0 = population, 1 = sample). Default 0
+         * @return double
+         */
+        double std (unsigned ddof = 0) const {return moments().std(ddof);}
+        /**
+         * @brief Count values in equal-width bins over [lo, hi]. Values outside the range are skipped, hi falls into the last bin
+         * @param bins Bin count
+         * @param lo Lower edge of first bin
+         * @param hi Upper edge of last bin
+         * @return Array<unsigned> Count of every bin
+         */
+        Array<unsigned> histogram (unsigned bins, double lo, double hi) const {
+            BA_PROFILE_SCOPE("Array::histogram");
+            if (bins == 0 || !(lo < hi)) throw std::invalid_argument("Invalid histogram range!");
+            unsigned chunkCount = Parallel::chunks(this->S, 1u << 16);
+            vector<vector<unsigned>> partial(chunkCount, vector<unsigned>(bins, 0));
+            const T* D = this->data();
+            const double scale = (double) bins / (hi - lo);
+            Parallel::forChunks(this->S, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                unsigned* H = partial[c].data();
+                for (unsigned long long i = b; i < e; i++) {
+                    double v = (double) D[i];
+                    if (!(v >= lo && v <= hi)) continue;
+                    unsigned k = (unsigned) ((v - lo) * scale);
+                    H[k < bins ? k : bins - 1]++;
+                }
+            });
+            Array<unsigned> X(bins);
+            unsigned* out = X.data();
+            for (unsigned c = 0; c < chunkCount; c++) {
+                for (unsigned k = 0; k < bins; k++) out[k] += partial[c][k];
+            }
+            return X;
         }
         /**
-         * @brief Find array index of first value occurance
-         * @param Val Value to be searched for
-         * @return int - first found index, if not found it returns ArrayEnd = 2147483647
+         * @brief Get bin of every value, X[i] = number of edges <= A[i] (same as NumPy digitize with increasing edges)
+         * @param Edges Increasing bin edges
+         * @return Array<int> Bin indices in range [0, Edges.size()]
          */
-        int find (const T& Val) {
-            for (unsigned i = 0; i < this->S; i++) if (this->A[i] == Val) return i;
-            return ArrayEnd;
+        Array<int> digitize (const Array<T> &Edges) const {
+            BA_PROFILE_SCOPE("Array::digitize");
+            if (!Edges.isSorted()) throw std::invalid_argument("Edges must be increasing!");
+            Array<int> X(this->S);
+            int* out = X.data();
+            const T* D = this->data();
+            const T* E = Edges.data();
+            const T* EEnd = E + Edges.size();
+            unsigned chunkCount = Parallel::chunks(this->S, 1u << 16);
+            Parallel::forChunks(this->S, chunkCount, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                for (unsigned long long i = b; i < e; i++) out[i] = (int) (std::upper_bound(E, EEnd, D[i]) - E);
+            });
+            return X;
         }
         /**
-         * @brief Find array index of first Sub-Array occurance
-         * @param SubArray Sub-Array to be searched for
-         * @return int - first found index, if not found it returns ArrayEnd = 2147483647
+         * @brief Get count, mean, std, min, quartiles and max. Moments come from one fused pass,
+         *        quartiles from selection on one shared copy
+         * @return Stats::Description
          */
-        int find (const Array <T> &SubArray) {
-            if (this->S < SubArray.S);
-            int current_search = 0, found_index = 0;
-            for (unsigned i = 0; i < this->S; i++) {
-                if (current_search == 0) found_index = i;
-                if (this->A[i] == SubArray[current_search]) current_search++;
-                else current_search = 0;
-                if (current_search == SubArray.S) return found_index;
+        Stats::Description describe () const {
+            BA_PROFILE_SCOPE("Array::describe");
+            if (this->S == 0) throw std::invalid_argument("Empty Array!");
+            Stats::Moments M = moments();
+            vector<T> V(this->A.begin(), this->A.end());
+            // Quartile ranks increase, so every selection only searches to the right of the previous one
+            double q[3] = {0.0, 0.0, 0.0}, level[3] = {0.25, 0.5, 0.75};
+            unsigned from = 0;
+            for (unsigned j = 0; j < 3; j++) {
+                double pos = level[j] * (this->S - 1);
+                unsigned lo = (unsigned) floor(pos);
+                std::nth_element(V.begin() + from, V.begin() + lo, V.end());
+                double a = (double) V[lo];
+                q[j] = a;
+                if (lo + 1 < this->S && pos > (double) lo) q[j] = a + ((double) *std::min_element(V.begin() + lo + 1, V.end()) - a) * (pos - lo);
+                from = lo;
             }
-            return ArrayEnd;
+            return Stats::Description{M.count, M.mean, M.std(), M.min, q[0], q[1], q[2], M.max};
         }
         /**
-         * @brief Find array index of first values list occurance
-         * @param Values Values list to be searched for
-         * @return int - first found index, if not found it returns ArrayEnd = 2147483647
+         * @brief Get cumulative sum, X[i] = A[0] + ... + A[i]
+         * @note Large Arrays are scanned in parallel blocks, floating point sums may differ in the last bits from a serial loop
+         * @return Array<T>
          */
-        int find (initializer_list<T> Values) {
-            if (this->S < Values.size()) return false;
-            Array<T> SubArray(Values);
-            int current_search = 0, found_index = 0;
-            for (unsigned i = 0; i < this->S; i++) {
-                if (current_search == 0) found_index = i;
-                if (this->A[i] == SubArray[current_search]) current_search++;
-                else current_search = 0;
-                if (current_search == SubArray.S) return found_index;
-            }
-            return ArrayEnd;
+        Array<T> cumsum () const {
+            BA_PROFILE_SCOPE("Array::cumsum");
+            return scan([] (const T& a, const T& b) {return a + b;});
         }
         /**
-         * @brief Find all array indices where value occurs
-         * @param Val Value to be searched for
-         * @return Array<int> Array of indices
+         * @brief Get cumulative product, X[i] = A[0] * ... * A[i]
+         * @return Array<T>
          */
-        Array<int> findAll (const T& Val) {
-            Array<int> X;
-            for (unsigned i = 0; i < this->S; i++) if (this->A[i] == Val) X.append(i);
-            return X;
+        Array<T> cumprod () const {
+            BA_PROFILE_SCOPE("Array::cumprod");
+            return scan([] (const T& a, const T& b) {return a * b;});
         }
         /**
-         * @brief Find all array indices where sub-array begins
-         * @param SubArray Sub-Array to be searched for
-         * @return Array<int> Array of indices
+         * @brief Get cumulative maximum, X[i] = max(A[0], ..., A[i])
+         * @return Array<T>
          */
-        Array<int> findAll (const Array <T> &SubArray) {
-            Array<int> X;
-            if (this->S < SubArray.S) return X;
-            int current_search = 0, iter_index = 0;
-            for (unsigned i = 0; i < this->S; i++) {
-                if (current_search == 0) iter_index = i;
-                if (this->A[i] == SubArray[current_search]) current_search++;
-                else current_search = 0;
-                if (current_search == SubArray.S) {
-                    X.append(iter_index);
-                    current_search = 0;
-                }
-            }
-            return X;
+        Array<T> cummax () const {
+            BA_PROFILE_SCOPE("Array::cummax");
+            return scan([] (const T& a, const T& b) {return a < b ? b : a;});
         }
         /**
-         * @brief Find all array indices where value list begins
-         * @param Values Value list to be searched for
-         * @return Array<int> Array of indices
+         * @brief Get differences of neighbours, X[i] = A[i + 1] - A[i]
+         * @return Array<T> Array shorter by 1 (empty for less than 2 elements)
          */
-        Array<int> findAll (initializer_list<T> Values) {
-            Array<int> X;
-            if (this->S < Values.size()) return X;
-            Array<T> SubArray(Values);
-            int current_search = 0, iter_index = 0;
-            for (unsigned i = 0; i < this->S; i++) {
-                if (current_search == 0) iter_index = i;
-                if (this->A[i] == SubArray[current_search]) current_search++;
-                else current_search = 0;
-                if (current_search == SubArray.S) {
-                    X.append(iter_index);
-                    current_search = 0;
-                }
-            }
+        Array<T> diff () const {
+            if (this->S < 2) return Array<T>();
+            Array<T> X(this->S - 1);
+            T* out = X.data();
+            const T* in = this->data();
+            for (unsigned i = 0; i + 1 < this->S; i++) out[i] = in[i + 1] - in[i];
             return X;
         }
         /**
-         * @brief Return Array with removed duplicates
-         * @return Array<T> 
+         * @brief Get sliding window view, e.g. A.rolling(5).mean()
+         * @param window Window length (at least 1)
+         * @return Rolling<T> Window aggregations return one value per full window (size - window + 1 values)
          */
-        Array<T> unique () {
-            Array<T> X;
-            for (unsigned i = 0; i < this->S; i++) {
-                if (!X.contains(this->A[i])) X.append(this->A[i]);
-            }
-            return X;
-        }
+        Rolling<T> rolling (unsigned window) const;
+        /**
+         * @brief Start lazy pipeline over Array elements. Stages are fused into one pass
+         * @return Lazy pipeline, e.g. A.lazy().filter(p).map(f).take(n).sum()
+         * @warning Array must not be modified or destroyed while the pipeline is evaluated
+         */
+        auto lazy () const;
         /*
             OPERATORS OVERLOADING
         */
@@ -648,30 +2799,39 @@ class Array {
 
         // Arithmetic operations with constants (keeping the Array)
         Array<T> operator+ (const T& Num) const {
+            BA_PROFILE_SCOPE("Array::operator+");
+            if constexpr (kernelType) return kernelApply<Simd::OP_ADD>(&Num, true);
             Array <T> X(this->S);
             for (unsigned i = 0; i < this->S; i++) X[i] = 0;
             for (unsigned i = 0; i < this->S; i++) X[i] += this->A[i] + Num;
             return X;
         }
         Array<T> operator- (const T& Num) const {
+            BA_PROFILE_SCOPE("Array::operator-");
+            if constexpr (kernelType) return kernelApply<Simd::OP_SUB>(&Num, true);
             Array <T> X(this->S);
             for (unsigned i = 0; i < this->S; i++) X[i] = 0;
             for (unsigned i = 0; i < this->S; i++) X[i] += this->A[i] - Num;
             return X;
         }
         Array<T> operator* (const T& Num) const {
+            BA_PROFILE_SCOPE("Array::operator*");
+            if constexpr (kernelType) return kernelApply<Simd::OP_MUL>(&Num, true);
             Array <T> X(this->S);
             for (unsigned i = 0; i < this->S; i++) X[i] = 0;
             for (unsigned i = 0; i < this->S; i++) X[i] += (this->A[i] * Num);
             return X;
         }
         Array<T> operator/ (const T& Num) const {
+            BA_PROFILE_SCOPE("Array::operator/");
+            if constexpr (kernelType && is_floating_point<T>::value) return kernelApply<Simd::OP_DIV>(&Num, true);
             Array <T> X(this->S);
             for (unsigned i = 0; i < this->S; i++) X[i] = 0;
             for (unsigned i = 0; i < this->S; i++) X[i] += (this->A[i] / Num);
             return X;
         }
         Array<T> operator% (const T& Num) const {
+            BA_PROFILE_SCOPE("Array::operator%");
             Array <T> X(this->S);
             for (unsigned i = 0; i < this->S; i++) X[i] = 0;
             for (unsigned i = 0; i < this->S; i++) X[i] += (this->A[i] % Num);
@@ -679,6 +2839,10 @@ class Array {
         }
         // Arithmetic operations with arrays (keeping the Arrays)
         Array<T> operator+ (const Array<T>& Arr) const {
+            BA_PROFILE_SCOPE("Array::operator+");
+            if constexpr (kernelType) {
+                if (this->S == Arr.S) return kernelApply<Simd::OP_ADD>(Arr.data(), false);
+            }
             unsigned max_size = MAX_S(this->S, Arr.S);
             Array <T> X(max_size);
             for (unsigned i = 0; i < max_size; i++) X[i] = 0;
@@ -687,6 +2851,10 @@ class Array {
             return X;
         }
         Array<T> operator- (const Array<T>& Arr) const {
+            BA_PROFILE_SCOPE("Array::operator-");
+            if constexpr (kernelType) {
+                if (this->S == Arr.S) return kernelApply<Simd::OP_SUB>(Arr.data(), false);
+            }
             unsigned max_size = MAX_S(this->S, Arr.S);
             Array <T> X(max_size);
             for (unsigned i = 0; i < max_size; i++) X[i] = 0;
@@ -695,6 +2863,10 @@ class Array {
             return X;
         }
         Array<T> operator* (const Array<T>& Arr) const {
+            BA_PROFILE_SCOPE("Array::operator*");
+            if constexpr (kernelType) {
+                if (this->S == Arr.S) return kernelApply<Simd::OP_MUL>(Arr.data(), false);
+            }
             unsigned max_size = MAX_S(this->S, Arr.S);
             Array <T> X(max_size);
             for (unsigned i = 0; i < max_size; i++) X[i] = 0;
@@ -703,6 +2875,10 @@ class Array {
             return X;
         }
         Array<T> operator/ (const Array<T>& Arr) const {
+            BA_PROFILE_SCOPE("Array::operator/");
+            if constexpr (kernelType && is_floating_point<T>::value) {
+                if (this->S == Arr.S) return kernelApply<Simd::OP_DIV>(Arr.data(), false);
+            }
             unsigned max_size = MAX_S(this->S, Arr.S);
             Array <T> X(max_size);
             for (unsigned i = 0; i < max_size; i++) X[i] = 0;
@@ -711,6 +2887,7 @@ class Array {
             return X;
         }
         Array<T> operator% (const Array<T>& Arr) const {
+            BA_PROFILE_SCOPE("Array::operator%");
             unsigned max_size = MAX_S(this->S, Arr.S);
             Array <T> X(max_size);
             for (unsigned i = 0; i < max_size; i++) X[i] = 0;
@@ -720,144 +2897,223 @@ class Array {
         }
         // Arithmetic operations with constants (modifying the Array)
         Array<T> operator+= (const T& Num) {
+            BA_PROFILE_SCOPE("Array::operator+=");
+            if constexpr (kernelType) {
+                T* D = this->data();
+                Simd::binary<Simd::OP_ADD, true>(D, &Num, D, this->S);
+                return *this;
+            }
             for (unsigned i = 0; i < this->S; i++) this->A[i] += Num;
-            return Array<T>(this->A);
+            return *this;
         }
         Array<T> operator-= (const T& Num) {
+            BA_PROFILE_SCOPE("Array::operator-=");
+            if constexpr (kernelType) {
+                T* D = this->data();
+                Simd::binary<Simd::OP_SUB, true>(D, &Num, D, this->S);
+                return *this;
+            }
             for (unsigned i = 0; i < this->S; i++) this->A[i] -= Num;
-            return Array<T>(this->A);
+            return *this;
         }
         Array<T> operator*= (const T& Num) {
+            BA_PROFILE_SCOPE("Array::operator*=");
+            if constexpr (kernelType) {
+                T* D = this->data();
+                Simd::binary<Simd::OP_MUL, true>(D, &Num, D, this->S);
+                return *this;
+            }
             for (unsigned i = 0; i < this->S; i++) this->A[i] *= Num;
-            return Array<T>(this->A);
+            return *this;
         }
         Array<T> operator/= (const T& Num) {
+            BA_PROFILE_SCOPE("Array::operator/=");
+            if constexpr (kernelType && is_floating_point<T>::value) {
+                T* D = this->data();
+                Simd::binary<Simd::OP_DIV, true>(D, &Num, D, this->S);
+                return *this;
+            }
             for (unsigned i = 0; i < this->S; i++) this->A[i] /= Num;
-            return Array<T>(this->A);
+            return *this;
         }
         Array<T> operator%= (const T& Num) {
+            BA_PROFILE_SCOPE("Array::operator%=");
             for (unsigned i = 0; i < this->S; i++) this->A[i] %= Num;
-            return Array<T>(this->A);
+            return *this;
         }
         // Arithmetic operations with other arrays (modifying the first Array)
         Array<T> operator+= (const Array<T> &Arr) {
-            for (unsigned i = this->S; i < Arr.S; i++) append(0);
-            for (unsigned i = 0; i < Arr.S; i++) this->A[i] += Arr[i];
-            return Array<T>(this->A);
+            BA_PROFILE_SCOPE("Array::operator+=");
+            if (Arr.S > this->S) {
+                this->A.resize(Arr.S, 0);
+                this->S = Arr.S;
+            }
+            if constexpr (kernelType) {
+                T* D = this->data();
+                Simd::binary<Simd::OP_ADD, false>(D, Arr.data(), D, Arr.S);
+                return *this;
+            }
+            for (unsigned i = 0; i < Arr.S; i++) this->A[i] += Arr.A[i];
+            return *this;
         }
         Array<T> operator-= (const Array<T> &Arr) {
-            for (unsigned i = this->S; i < Arr.S; i++) append(0);
-            for (unsigned i = 0; i < Arr.S; i++) this->A[i] -= Arr[i];
-            return Array<T>(this->A);
+            BA_PROFILE_SCOPE("Array::operator-=");
+            if (Arr.S > this->S) {
+                this->A.resize(Arr.S, 0);
+                this->S = Arr.S;
+            }
+            if constexpr (kernelType) {
+                T* D = this->data();
+                Simd::binary<Simd::OP_SUB, false>(D, Arr.data(), D, Arr.S);
+                return *this;
+            }
+            for (unsigned i = 0; i < Arr.S; i++) this->A[i] -= Arr.A[i];
+            return *this;
         }
         Array<T> operator*= (const Array<T> &Arr) {
-            for (unsigned i = this->S; i < Arr.S; i++) append(0);
-            for (unsigned i = 0; i < Arr.S; i++) this->A[i] *= Arr[i];
-            return Array<T>(this->A);
+            BA_PROFILE_SCOPE("Array::operator*=");
+            if (Arr.S > this->S) {
+                this->A.resize(Arr.S, 0);
+                this->S = Arr.S;
+            }
+            if constexpr (kernelType) {
+                T* D = this->data();
+                Simd::binary<Simd::OP_MUL, false>(D, Arr.data(), D, Arr.S);
+                return *this;
+            }
+            for (unsigned i = 0; i < Arr.S; i++) this->A[i] *= Arr.A[i];
+            return *this;
         }
         Array<T> operator/= (const Array<T> &Arr) {
-            for (unsigned i = this->S; i < Arr.S; i++) append(0);
-            for (unsigned i = 0; i < Arr.S; i++) this->A[i] /= Arr[i];
-            return Array<T>(this->A);
+            BA_PROFILE_SCOPE("Array::operator/=");
+            if (Arr.S > this->S) {
+                this->A.resize(Arr.S, 0);
+                this->S = Arr.S;
+            }
+            if constexpr (kernelType && is_floating_point<T>::value) {
+                T* D = this->data();
+                Simd::binary<Simd::OP_DIV, false>(D, Arr.data(), D, Arr.S);
+                return *this;
+            }
+            for (unsigned i = 0; i < Arr.S; i++) this->A[i] /= Arr.A[i];
+            return *this;
         }
         Array<T> operator%= (const Array<T> &Arr) {
-            for (unsigned i = this->S; i < Arr.S; i++) append(0);
-            for (unsigned i = 0; i < Arr.S; i++) this->A[i] %= Arr[i];
-            return Array<T>(this->A);
+            BA_PROFILE_SCOPE("Array::operator%=");
+            if (Arr.S > this->S) {
+                this->A.resize(Arr.S, 0);
+                this->S = Arr.S;
+            }
+            for (unsigned i = 0; i < Arr.S; i++) this->A[i] %= Arr.A[i];
+            return *this;
         }
         // Array Masking with comparison operators (comparing to constant)
-        ArrayMask operator== (const T& Value_1) {
-            ArrayMask X;
-            for (unsigned i = 0; i < this->S; i++) X.append(this->A[i] == Value_1);
+        ArrayMask operator== (const T& Value_1) const {
+            BA_PROFILE_SCOPE("Array::operator==");
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_EQ>(&Value_1, true, this->S, this->S);
+            ArrayMask X(this->S);
+            for (unsigned i = 0; i < this->S; i++) X.A[i] = this->A[i] == Value_1;
             return X;
         }
-        ArrayMask operator>= (const T& Value_1) {
-            ArrayMask X;
-            for (unsigned i = 0; i < this->S; i++) X.append(this->A[i] >= Value_1);
+        ArrayMask operator>= (const T& Value_1) const {
+            BA_PROFILE_SCOPE("Array::operator>=");
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_GE>(&Value_1, true, this->S, this->S);
+            ArrayMask X(this->S);
+            for (unsigned i = 0; i < this->S; i++) X.A[i] = this->A[i] >= Value_1;
             return X;
         }
-        ArrayMask operator<= (const T& Value_1) {
-            ArrayMask X;
-            for (unsigned i = 0; i < this->S; i++) X.append(this->A[i] <= Value_1);
+        ArrayMask operator<= (const T& Value_1) const {
+            BA_PROFILE_SCOPE("Array::operator<=");
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_LE>(&Value_1, true, this->S, this->S);
+            ArrayMask X(this->S);
+            for (unsigned i = 0; i < this->S; i++) X.A[i] = this->A[i] <= Value_1;
             return X;
         }
-        ArrayMask operator> (const T& Value_1) {
-            ArrayMask X;
-            for (unsigned i = 0; i < this->S; i++) X.append(this->A[i] > Value_1);
+        ArrayMask operator> (const T& Value_1) const {
+            BA_PROFILE_SCOPE("Array::operator>");
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_GT>(&Value_1, true, this->S, this->S);
+            ArrayMask X(this->S);
+            for (unsigned i = 0; i < this->S; i++) X.A[i] = this->A[i] > Value_1;
             return X;
         }
-        ArrayMask operator< (const T& Value_1) {
-            ArrayMask X;
-            for (unsigned i = 0; i < this->S; i++) X.append(this->A[i] < Value_1);
+        ArrayMask operator< (const T& Value_1) const {
+            BA_PROFILE_SCOPE("Array::operator<");
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_LT>(&Value_1, true, this->S, this->S);
+            ArrayMask X(this->S);
+            for (unsigned i = 0; i < this->S; i++) X.A[i] = this->A[i] < Value_1;
             return X;
         }
-        ArrayMask operator!= (const T& Value_1) {
-            ArrayMask X;
-            for (unsigned i = 0; i < this->S; i++) X.append(this->A[i] != Value_1);
+        ArrayMask operator!= (const T& Value_1) const {
+            BA_PROFILE_SCOPE("Array::operator!=");
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_NE>(&Value_1, true, this->S, this->S);
+            ArrayMask X(this->S);
+            for (unsigned i = 0; i < this->S; i++) X.A[i] = this->A[i] != Value_1;
             return X;
         }
         // Array Masking with comparison operators (comparing to another array)
-        ArrayMask operator== (const Array<T> &Arr) {
-            ArrayMask X;
-            unsigned max_size = MAX_S(this->S, Arr.S);
-            for (unsigned i = 0; i < max_size; i++) {
-                if (i >= this->S || i >= Arr.S) X.append(false);
-                else X.append(this->A[i] == Arr[i]);
-            }
+        ArrayMask operator== (const Array<T> &Arr) const {
+            BA_PROFILE_SCOPE("Array::operator==");
+            unsigned max_size = MAX_S(this->S, Arr.S), min_size = this->S < Arr.S ? this->S : Arr.S;
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_EQ>(Arr.data(), false, min_size, max_size);
+            ArrayMask X(max_size);
+            for (unsigned i = 0; i < min_size; i++) X.A[i] = this->A[i] == Arr.A[i];
+            for (unsigned i = min_size; i < max_size; i++) X.A[i] = false;
             return X;
         }
-        ArrayMask operator>= (const Array<T> &Arr) {
-            ArrayMask X;
-            unsigned max_size = MAX_S(this->S, Arr.S);
-            for (unsigned i = 0; i < max_size; i++) {
-                if (i >= this->S || i >= Arr.S) X.append(false);
-                else X.append(this->A[i] >= Arr[i]);
-            }
+        ArrayMask operator>= (const Array<T> &Arr) const {
+            BA_PROFILE_SCOPE("Array::operator>=");
+            unsigned max_size = MAX_S(this->S, Arr.S), min_size = this->S < Arr.S ? this->S : Arr.S;
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_GE>(Arr.data(), false, min_size, max_size);
+            ArrayMask X(max_size);
+            for (unsigned i = 0; i < min_size; i++) X.A[i] = this->A[i] >= Arr.A[i];
+            for (unsigned i = min_size; i < max_size; i++) X.A[i] = false;
             return X;
         }
-        ArrayMask operator<= (const Array<T> &Arr) {
-            ArrayMask X;
-            unsigned max_size = MAX_S(this->S, Arr.S);
-            for (unsigned i = 0; i < max_size; i++) {
-                if (i >= this->S || i >= Arr.S) X.append(false);
-                else X.append(this->A[i] <= Arr[i]);
-            }
+        ArrayMask operator<= (const Array<T> &Arr) const {
+            BA_PROFILE_SCOPE("Array::operator<=");
+            unsigned max_size = MAX_S(this->S, Arr.S), min_size = this->S < Arr.S ? this->S : Arr.S;
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_LE>(Arr.data(), false, min_size, max_size);
+            ArrayMask X(max_size);
+            for (unsigned i = 0; i < min_size; i++) X.A[i] = this->A[i] <= Arr.A[i];
+            for (unsigned i = min_size; i < max_size; i++) X.A[i] = false;
             return X;
         }
-        ArrayMask operator> (const Array<T> &Arr) {
-            ArrayMask X;
-            unsigned max_size = MAX_S(this->S, Arr.S);
-            for (unsigned i = 0; i < max_size; i++) {
-                if (i >= this->S || i >= Arr.S) X.append(false);
-                else X.append(this->A[i] > Arr[i]);
-            }
+        ArrayMask operator> (const Array<T> &Arr) const {
+            BA_PROFILE_SCOPE("Array::operator>");
+            unsigned max_size = MAX_S(this->S, Arr.S), min_size = this->S < Arr.S ? this->S : Arr.S;
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_GT>(Arr.data(), false, min_size, max_size);
+            ArrayMask X(max_size);
+            for (unsigned i = 0; i < min_size; i++) X.A[i] = this->A[i] > Arr.A[i];
+            for (unsigned i = min_size; i < max_size; i++) X.A[i] = false;
             return X;
         }
-        ArrayMask operator< (const Array<T> &Arr) {
-            ArrayMask X;
-            unsigned max_size = MAX_S(this->S, Arr.S);
-            for (unsigned i = 0; i < max_size; i++) {
-                if (i >= this->S || i >= Arr.S) X.append(false);
-                else X.append(this->A[i] < Arr[i]);
-            }
+        ArrayMask operator< (const Array<T> &Arr) const {
+            BA_PROFILE_SCOPE("Array::operator<");
+            unsigned max_size = MAX_S(this->S, Arr.S), min_size = this->S < Arr.S ? this->S : Arr.S;
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_LT>(Arr.data(), false, min_size, max_size);
+            ArrayMask X(max_size);
+            for (unsigned i = 0; i < min_size; i++) X.A[i] = this->A[i] < Arr.A[i];
+            for (unsigned i = min_size; i < max_size; i++) X.A[i] = false;
             return X;
         }
-        ArrayMask operator!= (const Array<T> &Arr) {
-            ArrayMask X;
-            unsigned max_size = MAX_S(this->S, Arr.S);
-            for (unsigned i = 0; i < max_size; i++) {
-                if (i >= this->S || i >= Arr.S) X.append(false);
-                else X.append(this->A[i] != Arr[i]);
-            }
+        ArrayMask operator!= (const Array<T> &Arr) const {
+            BA_PROFILE_SCOPE("Array::operator!=");
+            unsigned max_size = MAX_S(this->S, Arr.S), min_size = this->S < Arr.S ? this->S : Arr.S;
+            if constexpr (kernelType) return kernelCompare<Simd::CMP_NE>(Arr.data(), false, min_size, max_size);
+            ArrayMask X(max_size);
+            for (unsigned i = 0; i < min_size; i++) X.A[i] = this->A[i] != Arr.A[i];
+            for (unsigned i = min_size; i < max_size; i++) X.A[i] = false;
             return X;
         }
         // Boolean operators for Array Masks (Keeping inital ArrayMasks)
         ArrayMask operator! () const {
-            ArrayMask X;
-            for (unsigned i = 0; i < this->S; i++) X.append(!this->A[i]);
+            BA_PROFILE_SCOPE("Array::operator!");
+            ArrayMask X(this->S);
+            for (unsigned i = 0; i < this->S; i++) X.A[i] = !this->A[i];
             return X;
         }
         ArrayMask operator| (const ArrayMask &Mask) const {
+            BA_PROFILE_SCOPE("Array::operator|");
             unsigned max_size = MAX_S(this->S, Mask.S);
             ArrayMask X(max_size);
             for (unsigned i = 0; i < max_size; i++) X.A[i] = false;
@@ -866,6 +3122,7 @@ class Array {
             return X;
         }
         ArrayMask operator& (const ArrayMask &Mask) const {
+            BA_PROFILE_SCOPE("Array::operator&");
             unsigned max_size = MAX_S(this->S, Mask.S);
             ArrayMask X(max_size);
             for (unsigned i = 0; i < max_size; i++) X.A[i] = false;
@@ -874,6 +3131,7 @@ class Array {
             return X;
         }
         ArrayMask operator^ (const ArrayMask &Mask) const {
+            BA_PROFILE_SCOPE("Array::operator^");
             unsigned max_size = MAX_S(this->S, Mask.S);
             ArrayMask X(max_size);
             for (unsigned i = 0; i < max_size; i++) X.A[i] = false;
@@ -883,39 +3141,494 @@ class Array {
         }
         // Boolean operators for Array Masks (with constants, keeping initial ArrayMask) 
         ArrayMask operator| (bool Boolean) const {
+            BA_PROFILE_SCOPE("Array::operator|");
             ArrayMask X(this->S);
             for (unsigned i = 0; i < this->S; i++) X.A[i] = (bool) A[i] | Boolean;
             return X;
         }
         ArrayMask operator& (bool Boolean) const {
+            BA_PROFILE_SCOPE("Array::operator&");
             ArrayMask X(this->S);
             for (unsigned i = 0; i < this->S; i++) X.A[i] = (bool) A[i] & Boolean;
             return X;
         }
         ArrayMask operator^ (bool Boolean) const {
+            BA_PROFILE_SCOPE("Array::operator^");
             ArrayMask X(this->S);
             for (unsigned i = 0; i < this->S; i++) X.A[i] = (bool) A[i] ^ Boolean;
             return X;
         }
         // Boolean operators for Array Masks (modifying result ArrayMask)
         ArrayMask operator|= (const ArrayMask &Mask) {
+            BA_PROFILE_SCOPE("Array::operator|=");
             unsigned max_size = MAX_S(this->S, Mask.S);
-            for (unsigned i = this->S; i < max_size; i++) append(false);
+            if (max_size > this->S) {
+                this->A.resize(max_size, false);
+                this->S = max_size;
+            }
             for (unsigned i = 0; i < Mask.S; i++) this->A[i] = (bool) A[i] | (bool) Mask.A[i];
-            return ArrayMask(this->A);
+            return *this;
         }
         ArrayMask operator&= (const ArrayMask &Mask) {
+            BA_PROFILE_SCOPE("Array::operator&=");
             unsigned max_size = MAX_S(this->S, Mask.S);
-            for (unsigned i = this->S; i < max_size; i++) append(false);
+            if (max_size > this->S) {
+                this->A.resize(max_size, false);
+                this->S = max_size;
+            }
             for (unsigned i = 0; i < Mask.S; i++) this->A[i] = (bool) A[i] & (bool) Mask.A[i];
-            return ArrayMask(this->A);
+            return *this;
         }
         ArrayMask operator^= (const ArrayMask &Mask) {
+            BA_PROFILE_SCOPE("Array::operator^=");
             unsigned max_size = MAX_S(this->S, Mask.S);
-            for (unsigned i = this->S; i < max_size; i++) append(false);
+            if (max_size > this->S) {
+                this->A.resize(max_size, false);
+                this->S = max_size;
+            }
             for (unsigned i = 0; i < Mask.S; i++) this->A[i] = (bool) A[i] ^ (bool) Mask.A[i];
-            return ArrayMask(this->A);
+            return *this;
+        }
+};
+/**
+ * @brief Lazy, fused Array pipeline
+ *
+ * Every stage wraps the generator of the previous one, so the whole chain runs as one loop over
+ * the source. The source is walked in tiles of LazyTile elements: inside a tile the loop has no
+ * early-exit branch, pipelines containing take() stop after the tile that satisfied them.
+ * Stages receive the source index of every element, which is what mask() tests.
+ * @tparam T Element type produced by the pipeline
+ * @tparam Gen Generator called as gen(begin, end, sink), sink(index, value) returns false to stop
+ * @tparam Stoppable True if pipeline may stop early (contains take())
+ */
+const unsigned LazyTile = 1024;
+template <class T, class Gen, bool Stoppable>
+class Lazy {
+    template <class U, class G, bool S> friend class Lazy;
+    private:
+        Gen G;
+        unsigned N;
+        unsigned Threads;
+        template <class Sink>
+        void run (unsigned begin, unsigned end, Sink &sink) const { G(begin, end, sink); }
+        // Evaluate pipeline on chunks in parallel, part(begin, end) returns partial result, join() merges in order
+        template <class R, class Part, class Join>
+        R execute (R init, Part part, Join join) const {
+            unsigned chunkCount = Stoppable ? 1 : Parallel::chunks(this->N, 65536);
+            if (this->Threads == 1 || chunkCount <= 1) return join(init, part(0, this->N));
+            if (this->Threads > 1 && chunkCount > this->Threads) chunkCount = this->Threads;
+            vector<R> partial(chunkCount, init);
+            Parallel::forChunks(this->N, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                partial[c] = part((unsigned) b, (unsigned) e);
+            });
+            R result = init;
+            for (unsigned c = 0; c < chunkCount; c++) result = join(result, partial[c]);
+            return result;
+        }
+        template <class U, class NewGen, bool NewStoppable>
+        Lazy<U, NewGen, NewStoppable> chain (NewGen gen) const {
+            return Lazy<U, NewGen, NewStoppable>(gen, this->N, this->Threads);
+        }
+    public:
+        Lazy (Gen gen, unsigned n, unsigned threads = 1) : G(gen), N(n), Threads(threads) {}
+        // STAGES
+        /**
+         * @brief Keep elements matching predicate
+         * @param pred Callable as bool pred(const T&)
+         */
+        template <class P>
+        auto filter (P pred) const {
+            Gen g = this->G;
+            auto gen = [g, pred] (unsigned b, unsigned e, auto &sink) {
+                auto next = [&] (unsigned i, const T& v) { return pred(v) ? sink(i, v) : true; };
+                return g(b, e, next);
+            };
+            return chain<T, decltype(gen), Stoppable>(gen);
+        }
+        /**
+         * @brief Transform elements
+         * @param f Callable as U f(const T&)
+         */
+        template <class F>
+        auto map (F f) const {
+            typedef typename decay<decltype(f(declval<const T&>()))>::type U;
+            Gen g = this->G;
+            auto gen = [g, f] (unsigned b, unsigned e, auto &sink) {
+                auto next = [&] (unsigned i, const T& v) { return sink(i, (U) f(v)); };
+                return g(b, e, next);
+            };
+            return chain<U, decltype(gen), Stoppable>(gen);
+        }
+        /**
+         * @brief Keep elements whose source index is true in Mask. Elements past Mask end are kept (as in masked())
+         * @param Mask ArrayMask, e.g. A > 5
+         */
+        auto mask (const ArrayMask &Mask) const {
+            Gen g = this->G;
+            // Bits are copied once into shared packed words, the stage then tests one bit per element without index checks
+            unsigned ms = Mask.size();
+            shared_ptr<vector<unsigned long long>> Words = make_shared<vector<unsigned long long>>(ms / 64 + 1, 0);
+            if constexpr (ArrayMask::packedMask) {
+                if (ms > 0) memcpy(Words->data(), ArrayMask::maskWords(Mask), (ms + 63) / 64 * sizeof(unsigned long long));
+            }
+            else for (unsigned i = 0; i < ms; i++) (*Words)[i / 64] |= (unsigned long long) Mask.A[i] << (i % 64);
+            auto gen = [g, Words, ms] (unsigned b, unsigned e, auto &sink) {
+                const unsigned long long* W = Words->data();
+                auto next = [&] (unsigned i, const T& v) { return (i >= ms || (W[i / 64] >> (i % 64) & 1)) ? sink(i, v) : true; };
+                return g(b, e, next);
+            };
+            return chain<T, decltype(gen), Stoppable>(gen);
+        }
+        /**
+         * @brief Stop after first n elements reaching this stage. Pipelines with take() run serially
+         * @param n Element count
+         */
+        auto take (unsigned n) const {
+            Gen g = this->G;
+            auto gen = [g, n] (unsigned b, unsigned e, auto &sink) {
+                unsigned left = n;
+                if (left == 0) return false;
+                auto next = [&] (unsigned i, const T& v) {
+                    if (left == 0) return false;
+                    left--;
+                    return sink(i, v) && left > 0;
+                };
+                return g(b, e, next);
+            };
+            return chain<T, decltype(gen), true>(gen);
+        }
+        /**
+         * @brief Evaluate terminal operations with parallel executor
+         * @param threads Thread count (default = Parallel::threads())
+         */
+        Lazy<T, Gen, Stoppable> parallel (unsigned threads = 0) const {
+            return Lazy<T, Gen, Stoppable>(this->G, this->N, threads == 0 ? Parallel::threads() : threads);
+        }
+        // TERMINAL OPERATIONS
+        /**
+         * @brief Fold pipeline values. op must be associative for parallel execution
+         * @param init Initial value (identity of op)
+         * @param op Callable as R op(R, const T&)
+         * @return R Reduced value
+         */
+        template <class R, class Op>
+        R reduce (R init, Op op) const {
+            return execute<R>(init, [&] (unsigned b, unsigned e) {
+                R acc = init;
+                auto sink = [&] (unsigned, const T& v) { acc = op(acc, v); return true; };
+                run(b, e, sink);
+                return acc;
+            }, [&] (R x, R y) { return op(x, y); });
+        }
+        /**
+         * @brief Sum pipeline values
+         * @return T Sum (0 for empty pipeline)
+         */
+        T sum () const {
+            return execute<T>((T) 0, [&] (unsigned b, unsigned e) {
+                T acc = (T) 0;
+                auto sink = [&] (unsigned, const T& v) { acc += v; return true; };
+                run(b, e, sink);
+                return acc;
+            }, [] (T x, T y) { return x + y; });
+        }
+        /**
+         * @brief Count pipeline values
+         * @return unsigned Count
+         */
+        unsigned count () const {
+            return execute<unsigned>(0, [&] (unsigned b, unsigned e) {
+                unsigned cnt = 0;
+                auto sink = [&] (unsigned, const T&) { cnt++; return true; };
+                run(b, e, sink);
+                return cnt;
+            }, [] (unsigned x, unsigned y) { return x + y; });
+        }
+        /**
+         * @brief Average of pipeline values
+         * @return double Average
+         */
+        double mean () const {
+            pair<double, unsigned> r = execute<pair<double, unsigned>>(make_pair(0.0, 0u), [&] (unsigned b, unsigned e) {
+                pair<double, unsigned> acc(0.0, 0u);
+                auto sink = [&] (unsigned, const T& v) { acc.first += (double) v; acc.second++; return true; };
+                run(b, e, sink);
+                return acc;
+            }, [] (pair<double, unsigned> x, pair<double, unsigned> y) { return make_pair(x.first + y.first, x.second + y.second); });
+            if (r.second == 0) throw std::invalid_argument("Empty pipeline!");
+            return r.first / (double) r.second;
+        }
+        /**
+         * @brief Maximum of pipeline values
+         * @return T MAX
+         */
+        T max () const {return extreme(false);}
+        /**
+         * @brief Minimum of pipeline values
+         * @return T MIN
+         */
+        T min () const {return extreme(true);}
+        /**
+         * @brief Materialize pipeline values
+         * @return Array<T>
+         */
+        Array<T> toArray () const {
+            return execute<Array<T>>(Array<T>(), [&] (unsigned b, unsigned e) {
+                Array<T> X;
+                auto sink = [&] (unsigned, const T& v) { X.append(v); return true; };
+                run(b, e, sink);
+                return X;
+            }, [] (Array<T> x, const Array<T> &y) { x.append(y); return x; });
+        }
+    private:
+        T extreme (bool smallest) const {
+            pair<T, bool> r = execute<pair<T, bool>>(make_pair(T(), false), [&] (unsigned b, unsigned e) {
+                pair<T, bool> acc(T(), false);
+                auto sink = [&] (unsigned, const T& v) {
+                    if (!acc.second || (smallest ? v < acc.first : v > acc.first)) acc = make_pair(v, true);
+                    return true;
+                };
+                run(b, e, sink);
+                return acc;
+            }, [smallest] (pair<T, bool> x, pair<T, bool> y) {
+                if (!y.second) return x;
+                if (!x.second || (smallest ? y.first < x.first : y.first > x.first)) return y;
+                return x;
+            });
+            if (!r.second) throw std::invalid_argument("Empty pipeline!");
+            return r.first;
+        }
+};
+template <class T>
+auto Array<T>::lazy () const {
+    // ArrayMask storage is bit-packed, so it is read through the vector instead of a raw pointer
+    typedef typename conditional<is_same<T, bool>::value, const Array<T>*, const T*>::type Source;
+    Source D;
+    if constexpr (is_same<T, bool>::value) D = this;
+    else D = this->A.data();
+    auto source = [D] (unsigned b, unsigned e, auto &sink) {
+        for (unsigned tile = b; tile < e; tile += LazyTile) {
+            unsigned tileEnd = e - tile < LazyTile ? e : tile + LazyTile;
+            bool more = true;
+            for (unsigned i = tile; i < tileEnd; i++) {
+                if constexpr (is_same<T, bool>::value) more &= (bool) sink(i, (bool) D->A[i]);
+                else more &= (bool) sink(i, D[i]);
+            }
+            if (!more) return false;
+        }
+        return true;
+    };
+    return Lazy<T, decltype(source), false>(source, this->S);
+}
+/**
+ * @brief Sliding window aggregations over an Array, every method is O(n) regardless of window length
+ * @warning Array must not be modified or destroyed while the view is used
+ * @tparam T Arithmetic type
+ */
+template <class T>
+class Rolling {
+    private:
+        const T* D;
+        unsigned N, W;
+        unsigned outSize () const {return this->W > this->N ? 0 : this->N - this->W + 1;}
+        // Monotonic deque of indices: values of kept indices are ordered so the front is the window extreme
+        template <class Better>
+        Array<T> extreme (Better better) const {
+            Array<T> X(outSize());
+            if (X.size() == 0) return X;
+            T* out = X.data();
+            vector<unsigned> dq(this->N);
+            unsigned head = 0, tail = 0;
+            for (unsigned i = 0; i < this->N; i++) {
+                while (tail > head && !better(this->D[dq[tail - 1]], this->D[i])) tail--;
+                dq[tail++] = i;
+                if (dq[head] + this->W <= i) head++;
+                if (i + 1 >= this->W) out[i + 1 - this->W] = this->D[dq[head]];
+            }
+            return X;
+        }
+    public:
+        Rolling (const T* Data, unsigned Size, unsigned Window) : D(Data), N(Size), W(Window) {
+            if (Window == 0) throw std::invalid_argument("Window must be at least 1!");
+        }
+        /**
+         * @brief Get window length
+         */
+        unsigned window () const {return this->W;}
+        /**
+         * @brief Sum of every window (running sum, one add and one subtract per element)
+         * @return Array<T>
+         */
+        Array<T> sum () const {
+            BA_PROFILE_SCOPE("Rolling::sum");
+            Array<T> X(outSize());
+            if (X.size() == 0) return X;
+            T* out = X.data();
+            T acc = T();
+            for (unsigned i = 0; i < this->W; i++) acc += this->D[i];
+            out[0] = acc;
+            for (unsigned i = this->W; i < this->N; i++) {
+                acc += this->D[i] - this->D[i - this->W];
+                out[i + 1 - this->W] = acc;
+            }
+            return X;
+        }
+        /**
+         * @brief Average of every window
+         * @return Array<double>
+         */
+        Array<double> mean () const {
+            BA_PROFILE_SCOPE("Rolling::mean");
+            Array<double> X(outSize());
+            if (X.size() == 0) return X;
+            double* out = X.data();
+            double acc = 0.0;
+            for (unsigned i = 0; i < this->W; i++) acc += (double) this->D[i];
+            out[0] = acc / this->W;
+            for (unsigned i = this->W; i < this->N; i++) {
+                acc += (double) this->D[i] - (double) this->D[i - this->W];
+                out[i + 1 - this->W] = acc / this->W;
+            }
+            return X;
+        }
+        /**
+         * @brief Maximum of every window
+         * @return Array<T>
+         */
+        Array<T> max () const {
+            BA_PROFILE_SCOPE("Rolling::max");
+            return extreme([] (const T& kept, const T& next) {return next < kept;});
+        }
+        /**
+         * @brief Minimum of every window
+         * @return Array<T>
+         */
+        Array<T> min () const {
+            BA_PROFILE_SCOPE("Rolling::min");
+            return extreme([] (const T& kept, const T& next) {return kept < next;});
+        }
+};
+template <class T>
+Rolling<T> Array<T>::rolling (unsigned window) const {return Rolling<T>(this->data(), this->S, window);}
+/**
+ * @brief Streaming approximate quantiles (KLL sketch) in bounded memory
+ *
+ * Values pass through levels of compactors. A full level is sorted and every other value
+ * (random offset) is promoted to the next level with doubled weight. Sketches of separate
+ * chunks or threads can be merged. Rank error is about 1.7 / k for the default accuracy.
+ * @tparam T Arithmetic type
+ */
+template <class T>
+class QuantileSketch {
+    private:
+        unsigned K;
+        unsigned long long n;
+        unsigned long long seed;
+        vector < vector < T > > levels;
+        unsigned capacity (unsigned h) const {
+            double c = (double) this->K * pow(2.0 / 3.0, (double) (this->levels.size() - h - 1));
+            return c < 2.0 ? 2 : (unsigned) ceil(c);
+        }
+        unsigned long long stored () const {
+            unsigned long long t = 0;
+            for (unsigned h = 0; h < this->levels.size(); h++) t += this->levels[h].size();
+            return t;
+        }
+        unsigned long long maxStored () const {
+            unsigned long long t = 0;
+            for (unsigned h = 0; h < this->levels.size(); h++) t += capacity(h);
+            return t;
+        }
+        bool coin () {
+            this->seed ^= this->seed << 13;
+            this->seed ^= this->seed >> 7;
+            this->seed ^= this->seed << 17;
+            return this->seed & 1;
+        }
+        void compress () {
+            while (stored() > maxStored()) {
+                for (unsigned h = 0; h < this->levels.size(); h++) {
+                    if (this->levels[h].size() < capacity(h)) continue;
+                    if (h + 1 == this->levels.size()) this->levels.emplace_back();
+                    vector<T> &L = this->levels[h];
+                    std::sort(L.begin(), L.end());
+                    // Odd element stays on this level, the rest is halved into the next one
+                    T keep = L.back();
+                    bool odd = L.size() % 2 == 1;
+                    unsigned pairs = (unsigned) (L.size() / 2);
+                    unsigned offset = coin();
+                    for (unsigned i = 0; i < pairs; i++) this->levels[h + 1].push_back(L[2 * i + offset]);
+                    L.clear();
+                    if (odd) L.push_back(keep);
+                    break;
+                }
+            }
+        }
+    public:
+        /**
+         * @brief Construct a new QuantileSketch object
+         * @param accuracy Size of the top compactor, larger is more accurate (default = 200)
+         */
+        explicit QuantileSketch (unsigned accuracy = 200) : K(accuracy < 8 ? 8 : accuracy), n(0), seed(0x9e3779b97f4a7c15ull), levels(1) {}
+        /**
+         * @brief Add value
+         * @param Value
+         */
+        void add (const T& Value) {
+            this->levels[0].push_back(Value);
+            this->n++;
+            if (this->levels[0].size() >= capacity(0)) compress();
+        }
+        /**
+         * @brief Add all values of an Array (e.g. one chunk of Files::readChunks)
+         * @param Arr
+         */
+        void add (const Array<T> &Arr) {
+            for (unsigned i = 0; i < Arr.size(); i++) add(Arr.data()[i]);
+        }
+        /**
+         * @brief Merge another sketch into this one
+         * @param Other Sketch built with the same accuracy
+         */
+        void merge (const QuantileSketch<T> &Other) {
+            while (this->levels.size() < Other.levels.size()) this->levels.emplace_back();
+            for (unsigned h = 0; h < Other.levels.size(); h++) {
+                this->levels[h].insert(this->levels[h].end(), Other.levels[h].begin(), Other.levels[h].end());
+            }
+            this->n += Other.n;
+            compress();
         }
+        /**
+         * @brief Get number of values added
+         */
+        unsigned long long count () const {return this->n;}
+        /**
+         * @brief Get approximate quantile
+         * @param q Quantile in range [0, 1]
+         * @return T Value with approximate rank q * count()
+         */
+        T quantile (double q) const {
+            if (this->n == 0) throw std::invalid_argument("Empty sketch!");
+            if (!(q >= 0.0 && q <= 1.0)) throw std::invalid_argument("Quantile must be in range [0, 1]!");
+            vector < pair < T, unsigned long long > > W;
+            for (unsigned h = 0; h < this->levels.size(); h++) {
+                for (unsigned i = 0; i < this->levels[h].size(); i++) W.push_back(make_pair(this->levels[h][i], 1ull << h));
+            }
+            std::sort(W.begin(), W.end(), [] (const pair<T, unsigned long long> &a, const pair<T, unsigned long long> &b) {return a.first < b.first;});
+            unsigned long long total = 0;
+            for (unsigned i = 0; i < W.size(); i++) total += W[i].second;
+            double target = q * (double) total;
+            unsigned long long acc = 0;
+            for (unsigned i = 0; i < W.size(); i++) {
+                acc += W[i].second;
+                if ((double) acc >= target) return W[i].first;
+            }
+            return W.back().first;
+        }
+        /**
+         * @brief Get approximate median
+         */
+        T median () const {return quantile(0.5);}
 };
 /**
  * @brief Converter namespace for Array conversions and more
@@ -944,6 +3657,7 @@ namespace Converter {
     template <class T>
     vector<T> toVector (const Array<T> &Arr) {
         vector<T> NewContainer;
+        NewContainer.reserve(Arr.size());
         for (unsigned i = 0; i < Arr.size(); i++) NewContainer.push_back(Arr[i]);
         return NewContainer;
     }
@@ -992,9 +3706,7 @@ namespace Converter {
      * @return string 
      */
     string toString (const Array<char> &Char_Array) {
-        string s = "";
-        for (int i = 0; i < Char_Array.size(); i++) s += Char_Array[i];
-        return s;
+        return string(Char_Array.data(), Char_Array.size());
     }
     /**
      * @brief Convert STD string to Char Array
@@ -1002,8 +3714,7 @@ namespace Converter {
      * @return Array<char> 
      */
     Array<char> toCharArray (const string &STD_String) {
-        Array<char> A;
-        for (unsigned i = 0; i < STD_String.length(); i++) A.append(STD_String.at(i));
+        Array<char> A(STD_String.data(), STD_String.length());
         return A;
     }
 }
@@ -1016,6 +3727,7 @@ namespace Files {
      */
     template <class T>
     void saveArray (const Array<T> &Arr, const string &FileName) {
+        BA_PROFILE_SCOPE("Files::saveArray");
         fstream f;
         f.open(FileName, ios::out);
         for (unsigned i = 0; i < Arr.size(); i++) f<<Arr[i]<<endl;
@@ -1029,6 +3741,7 @@ namespace Files {
      */
     template <class T>
     void appendArray (const Array<T> &Arr, const string &FileName) {
+        BA_PROFILE_SCOPE("Files::appendArray");
         fstream f;
         f.open(FileName, ios::app);
         for (unsigned i = 0; i < Arr.size(); i++) f<<Arr[i]<<endl;
@@ -1042,6 +3755,7 @@ namespace Files {
      */
     template <class T>
     Array<T> readArray (const string &FileName) {
+        BA_PROFILE_SCOPE("Files::readArray");
         Array<T> X;
         fstream f;
         f.open(FileName, ios::in);
@@ -1054,5 +3768,35 @@ namespace Files {
         f.close();
         return X;
     }
+    /**
+     * @brief Read file written by saveArray() in chunks without loading it whole, e.g. to feed QuantileSketch
+     * @tparam T Array Type
+     * @param FileName File Name
+     * @param chunkSize Maximum number of values per chunk
+     * @param fn Callable fn(const Array<T>& Chunk), called for every chunk in file order
+     * @return unsigned long long Number of values read
+     */
+    template <class T, class F>
+    unsigned long long readChunks (const string &FileName, unsigned chunkSize, F fn) {
+        BA_PROFILE_SCOPE("Files::readChunks");
+        if (chunkSize == 0) throw std::invalid_argument("Chunk size must be at least 1!");
+        ifstream f(FileName);
+        if (!f) throw std::invalid_argument("Cannot open file!");
+        unsigned long long total = 0;
+        Array<T> Chunk;
+        Chunk.reserve(chunkSize);
+        T val;
+        while (f>>val) {
+            Chunk.pushBackUnchecked(val);
+            total++;
+            if (Chunk.size() == chunkSize) {
+                fn((const Array<T>&) Chunk);
+                Chunk = Array<T>();
+                Chunk.reserve(chunkSize);
+            }
+        }
+        if (Chunk.size() > 0) fn((const Array<T>&) Chunk);
+        return total;
+    }
 }
 #endif // !BETTER_ARRAY_H
\ No newline at end of file
@@ -0,0 +1,246 @@
+/**
+ * @file concurrent_array.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Concurrent append-only Array for Better Array. Multi-producer ingestion without external locking.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef CONCURRENT_ARRAY_H
+#define CONCURRENT_ARRAY_H
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include "better_array.h"
+using namespace std;
+/**
+ * @brief Lock-free, segmented, append-only Array
+ *
+ * Elements live in segments of doubling size which are never moved, so element addresses stay
+ * valid for the lifetime of the container. append() may be called from many threads at once.
+ * size() only counts the published prefix: every slot below size() is settled. A slot whose copy constructor
+ * threw is left as a tombstone, so publication moves past it; reading it throws and snapshots skip it.
+ * @tparam T Any copy-constructible type
+ */
+template <class T>
+class ConcurrentArray {
+    private:
+        static const unsigned FirstSegment = 64;        // Length of segment 0, segment k holds FirstSegment << k
+        static const unsigned MaxSegments = 32;
+        enum SlotState : unsigned char {PENDING = 0, READY = 1, FAILED = 2};
+        struct Segment {
+            T* items;
+            atomic<unsigned char>* state;
+        };
+        atomic<Segment*> segments[MaxSegments];
+        atomic<unsigned long long> reserved;         // Slots handed out to producers
+        atomic<unsigned long long> published;        // Length of settled prefix
+        static unsigned segmentOf (unsigned long long index, unsigned long long &offset) {
+            unsigned long long j = index / FirstSegment + 1;
+            unsigned k = 63 - __builtin_clzll(j);
+            offset = index - (unsigned long long) FirstSegment * ((1ull << k) - 1);
+            return k;
+        }
+        static unsigned long long segmentLength (unsigned k) {return (unsigned long long) FirstSegment << k;}
+        Segment* segment (unsigned k) {
+            if (k >= MaxSegments) throw std::length_error("ConcurrentArray capacity exceeded!");
+            Segment* seg = this->segments[k].load(memory_order_acquire);
+            if (seg != NULL) return seg;
+            unsigned long long len = segmentLength(k);
+            Segment* fresh = new Segment;
+            fresh->items = static_cast<T*>(::operator new(len * sizeof(T), align_val_t(alignof(T) > 64 ? alignof(T) : 64)));
+            fresh->state = new atomic<unsigned char>[len];
+            for (unsigned long long i = 0; i < len; i++) fresh->state[i].store(PENDING, memory_order_relaxed);
+            if (this->segments[k].compare_exchange_strong(seg, fresh, memory_order_acq_rel)) return fresh;
+            freeSegment(fresh);
+            return seg;
+        }
+        static void freeSegment (Segment* seg) {
+            ::operator delete(seg->items, align_val_t(alignof(T) > 64 ? alignof(T) : 64));
+            delete[] seg->state;
+            delete seg;
+        }
+        bool isSettled (unsigned long long index) const {
+            unsigned long long offset;
+            unsigned k = segmentOf(index, offset);
+            if (k >= MaxSegments) return false;
+            Segment* seg = this->segments[k].load(memory_order_acquire);
+            return seg != NULL && seg->state[offset].load() != PENDING;
+        }
+        // Move published size forward over every contiguous settled (constructed or failed) slot.
+        // Slot states and the published counter use sequentially consistent ordering, so the producer
+        // finishing slot p and the producer finishing slot p + 1 cannot both miss each other.
+        void publish () {
+            unsigned long long p = this->published.load();
+            while (p < this->reserved.load() && isSettled(p)) {
+                if (this->published.compare_exchange_weak(p, p + 1)) p++;
+            }
+        }
+        void construct (unsigned long long index, const T& Elem) {
+            unsigned long long offset;
+            unsigned k = segmentOf(index, offset);
+            Segment* seg = segment(k);
+            new (&seg->items[offset]) T(Elem);
+            seg->state[offset].store(READY);
+        }
+        // Tombstone reserved slots [from, to) that will never be constructed, then publish past them
+        void abandon (unsigned long long from, unsigned long long to) {
+            for (unsigned long long index = from; index < to; index++) {
+                unsigned long long offset;
+                unsigned k = segmentOf(index, offset);
+                if (k >= MaxSegments) break;
+                unsigned char pending = PENDING;
+                segment(k)->state[offset].compare_exchange_strong(pending, FAILED);
+            }
+            publish();
+        }
+        bool isReady (unsigned long long index) const {
+            unsigned long long offset;
+            unsigned k = segmentOf(index, offset);
+            return this->segments[k].load(memory_order_acquire)->state[offset].load(memory_order_acquire) == READY;
+        }
+        T& at (unsigned long long index) const {
+            if (!isReady(index)) throw std::invalid_argument("Array element construction failed!");
+            unsigned long long offset;
+            unsigned k = segmentOf(index, offset);
+            return this->segments[k].load(memory_order_acquire)->items[offset];
+        }
+        unsigned long long Idx (long long index) const {
+            long long n = (long long) size();
+            long long i = index < 0 ? index + n : index;
+            if (i < 0 || i >= n) throw std::invalid_argument("Invalid Array Index!");
+            return (unsigned long long) i;
+        }
+    public:
+        // CONSTRUCTORS
+        /**
+         * @brief Construct a new empty ConcurrentArray object
+         */
+        ConcurrentArray () : reserved(0), published(0) {
+            for (unsigned k = 0; k < MaxSegments; k++) this->segments[k].store(NULL, memory_order_relaxed);
+        }
+        /**
+         * @brief Construct a new ConcurrentArray object using Array
+         * @param Arr Initial values
+         */
+        explicit ConcurrentArray (const Array<T> &Arr) : ConcurrentArray() { append(Arr); }
+        ConcurrentArray (const ConcurrentArray<T>&) = delete;
+        ConcurrentArray<T>& operator= (const ConcurrentArray<T>&) = delete;
+        /**
+         * @brief Destroy the ConcurrentArray object. No appends may run concurrently
+         */
+        ~ConcurrentArray () {
+            unsigned long long n = this->reserved.load(memory_order_acquire);
+            for (unsigned k = 0; k < MaxSegments; k++) {
+                Segment* seg = this->segments[k].load(memory_order_acquire);
+                if (seg == NULL) continue;
+                unsigned long long first = (unsigned long long) FirstSegment * ((1ull << k) - 1);
+                for (unsigned long long i = 0; i < segmentLength(k) && first + i < n; i++) {
+                    if (seg->state[i].load(memory_order_relaxed) == READY) seg->items[i].~T();
+                }
+                freeSegment(seg);
+            }
+        }
+        // Read-only snapshot of published elements, valid while the ConcurrentArray exists
+        class View {
+            private:
+                const ConcurrentArray<T>* Parent;
+                unsigned long long S;
+            public:
+                View (const ConcurrentArray<T>* parent, unsigned long long s) : Parent(parent), S(s) {}
+                unsigned long long size () const {return S;}
+                const T& operator[] (long long index) const {
+                    long long i = index < 0 ? index + (long long) S : index;
+                    if (i < 0 || i >= (long long) S) throw std::invalid_argument("Invalid Array Index!");
+                    return Parent->at((unsigned long long) i);
+                }
+                /**
+                 * @brief Copy viewed elements into an Array, skipping slots whose construction failed
+                 * @return Array<T>
+                 */
+                Array<T> toArray () const {
+                    if (S > 0xFFFFFFFFull) throw std::invalid_argument("Array is too large!");
+                    Array<T> X;
+                    X.reserve((unsigned) S);
+                    for (unsigned long long i = 0; i < S; i++) if (Parent->isReady(i)) X.pushBackUnchecked(Parent->at(i));
+                    return X;
+                }
+        };
+        // FUNCTIONS
+        /**
+         * @brief Get number of published elements. Safe to call during concurrent appends
+         * @return unsigned long long Size
+         */
+        unsigned long long size () const {return this->published.load(memory_order_acquire);}
+        /**
+         * @brief Preallocate segments for at least n elements
+         * @param n Minimal capacity
+         */
+        void reserve (unsigned long long n) {
+            if (n == 0) return;
+            unsigned long long offset;
+            unsigned last = segmentOf(n - 1, offset);
+            for (unsigned k = 0; k <= last; k++) segment(k);
+        }
+        /**
+         * @brief Add element to the end of an Array. Thread safe
+         * @param Elem
+         * @return unsigned long long Index of the new element
+         */
+        unsigned long long append (const T& Elem) {
+            unsigned long long index = this->reserved.fetch_add(1, memory_order_acq_rel);
+            try {
+                construct(index, Elem);
+            }
+            catch (...) {
+                abandon(index, index + 1);
+                throw;
+            }
+            publish();
+            return index;
+        }
+        /**
+         * @brief Add another Array to the end of an Array as one contiguous range. Thread safe
+         * @param Arr
+         * @return unsigned long long Index of the first appended element
+         */
+        unsigned long long append (const Array<T> &Arr) {
+            unsigned long long first = this->reserved.fetch_add(Arr.size(), memory_order_acq_rel);
+            unsigned i = 0;
+            try {
+                for (; i < Arr.size(); i++) construct(first + i, Arr[i]);
+            }
+            catch (...) {
+                abandon(first + i, first + Arr.size());
+                throw;
+            }
+            publish();
+            return first;
+        }
+        /**
+         * @brief Add values to the end of an Array as one contiguous range. Thread safe
+         * @param Values Initializer list
+         * @return unsigned long long Index of the first appended element
+         */
+        unsigned long long append (initializer_list<T> Values) {return append(Array<T>(Values));}
+        /**
+         * @brief Take a read-only view of currently published elements
+         * @return View
+         */
+        View view () const {return View(this, size());}
+        /**
+         * @brief Copy currently published elements into an Array, skipping failed slots
+         * @return Array<T>
+         */
+        Array<T> snapshot () const {return view().toArray();}
+        /*
+            OPERATORS OVERLOADING
+        */
+        // Subscripts over published elements (negative index supported). References stay valid
+        T& operator[] (long long index) {return at(Idx(index));}
+        const T& operator[] (long long index) const {return at(Idx(index));}
+};
+#endif // !CONCURRENT_ARRAY_H
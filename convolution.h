@@ -0,0 +1,260 @@
+/**
+ * @file convolution.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Convolution and correlation for Better Array. 1-D Arrays and 1-D, 2-D or 3-D NDArrays.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include "better_array.h"
+#include "ndarray.h"
+#include "fft.h"
+using namespace std;
+// Output extent
+enum ConvolveMode {
+    CONVOLVE_FULL = 0,      // Every position where signal and kernel overlap, shape(d) = n + k - 1
+    CONVOLVE_SAME = 1,      // Centered part of full output with the shape of the signal
+    CONVOLVE_VALID = 2      // Positions where kernel lies completely inside the signal, shape(d) = n - k + 1
+};
+// Convolution algorithm
+enum ConvolveMethod {
+    CONVOLVE_AUTO = 0,      // Direct for small kernels, FFT when it needs fewer operations (floating point types only)
+    CONVOLVE_DIRECT = 1,    // Sum of shifted signal rows scaled by every kernel tap (SIMD)
+    CONVOLVE_FFT = 2        // Product of spectra, integral results are rounded
+};
+namespace Convolution {
+    const unsigned DirectTaps = 32;         // Kernels up to this many elements always use the direct method
+    const unsigned long long RowBlock = 2048;   // Output elements per tile row, stays in L1 cache for all taps
+    // Every operand is handled as 3-D, missing leading dimensions have length 1
+    struct Shape {
+        unsigned long long n[3];
+        unsigned long long count () const {return n[0] * n[1] * n[2];}
+    };
+    inline Shape line (unsigned long long n) {
+        Shape S = {{1, 1, n}};
+        return S;
+    }
+    inline Shape shapeOf (const Array<unsigned> &Sizes) {
+        Shape S = {{1, 1, 1}};
+        for (unsigned d = 0; d < Sizes.size(); d++) S.n[3 - Sizes.size() + d] = Sizes[d];
+        return S;
+    }
+    /**
+     * @brief Valid correlation: Out[z][y][x] = sum of In[z + i][y + j][x + k] * K[i][j][k]
+     *
+     * Output is split into tiles of RowBlock elements of one output row. A tile reads its input rows plus
+     * the kernel halo (k - 1 elements) straight from In, so tiles never copy or overlap their outputs.
+     */
+    template <class T>
+    void correlateDirect (const T* In, const Shape &I, const T* K, const Shape &KS, T* Out, const Shape &O) {
+        unsigned long long rows = O.n[0] * O.n[1], blocks = (O.n[2] + RowBlock - 1) / RowBlock;
+        if (rows == 0 || blocks == 0) return;
+        Parallel::forTiles(rows * blocks, 1, [&] (unsigned long long b, unsigned long long e) {
+            for (unsigned long long t = b; t < e; t++) {
+                unsigned long long r = t / blocks, x0 = t % blocks * RowBlock;
+                unsigned long long z = r / O.n[1], y = r % O.n[1];
+                unsigned long long len = O.n[2] - x0 < RowBlock ? O.n[2] - x0 : RowBlock;
+                T* dst = Out + r * O.n[2] + x0;
+                for (unsigned long long i = 0; i < KS.n[0]; i++) {
+                    for (unsigned long long j = 0; j < KS.n[1]; j++) {
+                        const T* src = In + ((z + i) * I.n[1] + (y + j)) * I.n[2] + x0;
+                        const T* taps = K + (i * KS.n[1] + j) * KS.n[2];
+                        for (unsigned long long k = 0; k < KS.n[2]; k++) {
+                            if (taps[k] == T()) continue;
+                            if constexpr (Simd::isKernelType<T>::value) Simd::axpy(src + k, taps[k], dst, len);
+                            else for (unsigned long long x = 0; x < len; x++) dst[x] += taps[k] * src[k + x];
+                        }
+                    }
+                }
+            }
+        });
+    }
+    /**
+     * @brief Valid correlation through spectra. Correlation equals convolution with the kernel reversed,
+     *        valid outputs never reach the circular wrap-around when transforms are at least as long as the input.
+     *        Signal and kernel are both real, so they share one transform as real and imaginary part
+     */
+    template <class T>
+    void correlateFFT (const T* In, const Shape &I, const T* K, const Shape &KS, T* Out, const Shape &O) {
+        Shape P = {{FFT::goodSize(I.n[0]), FFT::goodSize(I.n[1]), FFT::goodSize(I.n[2])}};
+        vector<double> re(P.count()), im(P.count());
+        for (unsigned long long z = 0; z < I.n[0]; z++) {
+            for (unsigned long long y = 0; y < I.n[1]; y++) {
+                for (unsigned long long x = 0; x < I.n[2]; x++) re[(z * P.n[1] + y) * P.n[2] + x] = (double) In[(z * I.n[1] + y) * I.n[2] + x];
+            }
+        }
+        for (unsigned long long z = 0; z < KS.n[0]; z++) {
+            for (unsigned long long y = 0; y < KS.n[1]; y++) {
+                for (unsigned long long x = 0; x < KS.n[2]; x++) {
+                    im[((KS.n[0] - 1 - z) * P.n[1] + (KS.n[1] - 1 - y)) * P.n[2] + (KS.n[2] - 1 - x)] = (double) K[(z * KS.n[1] + y) * KS.n[2] + x];
+                }
+            }
+        }
+        for (unsigned axis = 0; axis < 3; axis++) {
+            size_t outer = 1, inner = 1;
+            for (unsigned d = 0; d < axis; d++) outer *= P.n[d];
+            for (unsigned d = axis + 1; d < 3; d++) inner *= P.n[d];
+            FFT::transformLines(re.data(), im.data(), outer, P.n[axis], inner, false);
+        }
+        // With Z = A + iB the product of spectra is A[k] B[k] = (Z[k]^2 - conj(Z[-k])^2) / 4i, computed for k and -k together
+        auto product = [] (complex<double> a, complex<double> b) {
+            complex<double> d = a * a - conj(b) * conj(b);
+            return complex<double>(d.imag() * 0.25, -d.real() * 0.25);
+        };
+        for (unsigned long long z = 0; z < P.n[0]; z++) {
+            for (unsigned long long y = 0; y < P.n[1]; y++) {
+                for (unsigned long long x = 0; x < P.n[2]; x++) {
+                    size_t i = (z * P.n[1] + y) * P.n[2] + x;
+                    size_t j = (((P.n[0] - z) % P.n[0]) * P.n[1] + (P.n[1] - y) % P.n[1]) * P.n[2] + (P.n[2] - x) % P.n[2];
+                    if (j < i) continue;
+                    complex<double> a(re[i], im[i]), b(re[j], im[j]), c = product(a, b), d = product(b, a);
+                    re[i] = c.real();
+                    im[i] = c.imag();
+                    re[j] = d.real();
+                    im[j] = d.imag();
+                }
+            }
+        }
+        for (unsigned axis = 0; axis < 3; axis++) {
+            size_t outer = 1, inner = 1;
+            for (unsigned d = 0; d < axis; d++) outer *= P.n[d];
+            for (unsigned d = axis + 1; d < 3; d++) inner *= P.n[d];
+            FFT::transformLines(re.data(), im.data(), outer, P.n[axis], inner, true);
+        }
+        for (unsigned long long z = 0; z < O.n[0]; z++) {
+            for (unsigned long long y = 0; y < O.n[1]; y++) {
+                for (unsigned long long x = 0; x < O.n[2]; x++) {
+                    double v = re[((z + KS.n[0] - 1) * P.n[1] + (y + KS.n[1] - 1)) * P.n[2] + (x + KS.n[2] - 1)];
+                    if constexpr (is_integral<T>::value) Out[(z * O.n[1] + y) * O.n[2] + x] = (T) llround(v);
+                    else Out[(z * O.n[1] + y) * O.n[2] + x] = (T) v;
+                }
+            }
+        }
+    }
+    /**
+     * @brief Correlate flat 3-D signal with flat 3-D kernel
+     * @param Flip Reverse kernel in every dimension (convolution)
+     * @param OutShape Set to output shape
+     * @return Array<T> Flat output
+     */
+    template <class T>
+    Array<T> run (const Array<T> &Signal, const Shape &S, const Array<T> &Kernel, const Shape &KS, ConvolveMode Mode, ConvolveMethod Method, bool Flip, Shape &OutShape) {
+        if (KS.count() == 0) throw std::invalid_argument("Kernel must not be empty!");
+        if (S.count() == 0) throw std::invalid_argument("Signal must not be empty!");
+        Shape Lo, P, O;
+        for (unsigned d = 0; d < 3; d++) {
+            unsigned long long n = S.n[d], k = KS.n[d];
+            if (Mode == CONVOLVE_VALID && k > n) throw std::invalid_argument("Kernel must not be larger than signal in valid mode!");
+            // Zero padding turning every mode into a valid correlation
+            unsigned long long lo = Mode == CONVOLVE_FULL ? k - 1 : (Mode == CONVOLVE_SAME ? k - 1 - (k - 1) / 2 : 0);
+            unsigned long long hi = Mode == CONVOLVE_FULL ? k - 1 : (Mode == CONVOLVE_SAME ? (k - 1) / 2 : 0);
+            Lo.n[d] = lo;
+            P.n[d] = n + lo + hi;
+            O.n[d] = P.n[d] - k + 1;
+        }
+        if (O.count() > 0xFFFFFFFFull || P.count() > 0xFFFFFFFFull) throw std::invalid_argument("Convolution result is too large!");
+        Array<T> K = Kernel;
+        if (Flip) std::reverse(K.data(), K.data() + K.size());
+        const T* in = Signal.data();
+        Array<T> Padded;
+        if (P.count() != S.count()) {
+            Padded = Array<T>((unsigned) P.count());
+            T* dst = Padded.data();
+            for (unsigned long long z = 0; z < S.n[0]; z++) {
+                for (unsigned long long y = 0; y < S.n[1]; y++) {
+                    const T* row = in + (z * S.n[1] + y) * S.n[2];
+                    std::copy(row, row + S.n[2], dst + ((z + Lo.n[0]) * P.n[1] + (y + Lo.n[1])) * P.n[2] + Lo.n[2]);
+                }
+            }
+            in = Padded.data();
+        }
+        if (Method == CONVOLVE_AUTO) {
+            // Direct needs out * taps multiply-adds, FFT two transforms of about F log F butterflies
+            Shape F = {{FFT::goodSize(P.n[0]), FFT::goodSize(P.n[1]), FFT::goodSize(P.n[2])}};
+            double direct = (double) O.count() * (double) KS.count(), fft = 10.0 * (double) F.count() * log2((double) F.count() + 1.0);
+            Method = is_floating_point<T>::value && KS.count() > DirectTaps && fft < direct ? CONVOLVE_FFT : CONVOLVE_DIRECT;
+        }
+        Array<T> X((unsigned) O.count());
+        if (Method == CONVOLVE_FFT) {
+            if constexpr (is_arithmetic<T>::value) correlateFFT(in, P, K.data(), KS, X.data(), O);
+            else throw std::invalid_argument("FFT convolution needs arithmetic type!");
+        }
+        else correlateDirect(in, P, K.data(), KS, X.data(), O);
+        OutShape = O;
+        return X;
+    }
+    template <class T>
+    NDArray<T> runND (const NDArray<T> &Signal, const NDArray<T> &Kernel, ConvolveMode Mode, ConvolveMethod Method, bool Flip) {
+        unsigned d = Signal.dimension();
+        if (d < 1 || d > 3) throw std::invalid_argument("Convolution supports 1-D, 2-D and 3-D NDArrays!");
+        if (Kernel.dimension() != d) throw std::invalid_argument("Kernel must have the same dimension count as signal!");
+        Shape O;
+        Array<T> X = run(Signal.flatten(), shapeOf(Signal.shape()), Kernel.flatten(), shapeOf(Kernel.shape()), Mode, Method, Flip, O);
+        Array<unsigned> OutSizes;
+        for (unsigned i = 3 - d; i < 3; i++) OutSizes.append((unsigned) O.n[i]);
+        return NDArray<T>(d, OutSizes, X);
+    }
+}
+/**
+ * @brief Convolve 1-D signal with kernel
+ * @param Signal Signal
+ * @param Kernel Kernel
+ * @param Mode CONVOLVE_FULL, CONVOLVE_SAME or CONVOLVE_VALID. Default CONVOLVE_FULL
+ * @param Method Algorithm. Default CONVOLVE_AUTO
+ * @return Array<T>
+ */
+template <class T>
+Array<T> convolve (const Array<T> &Signal, const Array<T> &Kernel, ConvolveMode Mode = CONVOLVE_FULL, ConvolveMethod Method = CONVOLVE_AUTO) {
+    BA_PROFILE_SCOPE("convolve");
+    Convolution::Shape O;
+    return Convolution::run(Signal, Convolution::line(Signal.size()), Kernel, Convolution::line(Kernel.size()), Mode, Method, true, O);
+}
+/**
+ * @brief Cross-correlate 1-D signal with kernel (kernel slides without reversing)
+ * @param Signal Signal
+ * @param Kernel Kernel
+ * @param Mode CONVOLVE_FULL, CONVOLVE_SAME or CONVOLVE_VALID. Default CONVOLVE_VALID
+ * @param Method Algorithm. Default CONVOLVE_AUTO
+ * @return Array<T>
+ */
+template <class T>
+Array<T> correlate (const Array<T> &Signal, const Array<T> &Kernel, ConvolveMode Mode = CONVOLVE_VALID, ConvolveMethod Method = CONVOLVE_AUTO) {
+    BA_PROFILE_SCOPE("correlate");
+    Convolution::Shape O;
+    return Convolution::run(Signal, Convolution::line(Signal.size()), Kernel, Convolution::line(Kernel.size()), Mode, Method, false, O);
+}
+/**
+ * @brief Convolve 1-D, 2-D or 3-D NDArray with kernel of the same dimension count
+ * @param Signal Signal
+ * @param Kernel Kernel
+ * @param Mode CONVOLVE_FULL, CONVOLVE_SAME or CONVOLVE_VALID. Default CONVOLVE_FULL
+ * @param Method Algorithm. Default CONVOLVE_AUTO
+ * @return NDArray<T>
+ */
+template <class T>
+NDArray<T> convolve (const NDArray<T> &Signal, const NDArray<T> &Kernel, ConvolveMode Mode = CONVOLVE_FULL, ConvolveMethod Method = CONVOLVE_AUTO) {
+    BA_PROFILE_SCOPE("convolve");
+    return Convolution::runND(Signal, Kernel, Mode, Method, true);
+}
+/**
+ * @brief Cross-correlate 1-D, 2-D or 3-D NDArray with kernel of the same dimension count
+ * @param Signal Signal
+ * @param Kernel Kernel
+ * @param Mode CONVOLVE_FULL, CONVOLVE_SAME or CONVOLVE_VALID. Default CONVOLVE_VALID
+ * @param Method Algorithm. Default CONVOLVE_AUTO
+ * @return NDArray<T>
+ */
+template <class T>
+NDArray<T> correlate (const NDArray<T> &Signal, const NDArray<T> &Kernel, ConvolveMode Mode = CONVOLVE_VALID, ConvolveMethod Method = CONVOLVE_AUTO) {
+    BA_PROFILE_SCOPE("correlate");
+    return Convolution::runND(Signal, Kernel, Mode, Method, false);
+}
+#endif // !CONVOLUTION_H
@@ -0,0 +1,656 @@
+/**
+ * @file fft.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Fast Fourier transform for Better Array. Complex and real Arrays, NDArrays along any axis.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef FFT_H
+#define FFT_H
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <stdexcept>
+#include "better_array.h"
+#include "ndarray.h"
+using namespace std;
+/**
+ * @brief FFT namespace with transform plans and kernels
+ *
+ * Lengths with prime factors up to MaxRadix are split into radix 4, 2, 3, 5, 7, 11 and 13 Stockham stages
+ * (every stage reads one buffer and writes the other in sorted order, so no bit reversal pass is needed).
+ * Other lengths use Bluestein's algorithm: a chirp convolution computed with transforms of 2^a 3^b 5^c length.
+ * Plans hold every twiddle factor and are cached per length. Values are kept split into real and imaginary
+ * buffers, stages whose stride covers a SIMD vector run on whole vectors (Simd::level() selects the width).
+ * Transforms are not scaled, inverse transforms of public functions are scaled by 1 / n (NumPy convention).
+ */
+namespace FFT {
+    const unsigned MaxRadix = 13;               // Larger prime factors go through Bluestein's algorithm
+    const unsigned LastAxis = (unsigned) -1;    // Axis argument selecting last NDArray axis
+    const double Pi = 3.14159265358979323846;
+    // Stockham stage of length radix * m with stride s
+    struct Stage {
+        unsigned radix;
+        size_t m, s;
+        vector<double> wr, wi;      // Twiddles w^(p * k) of stage length, index p * (radix - 1) + k - 1
+        vector<double> omr, omi;    // Roots of unity of radix
+    };
+    template <class X>
+    BA_SIMD_INLINE void load (X &x, const double* p) {memcpy(&x, p, sizeof(X));}
+    template <class X>
+    BA_SIMD_INLINE void store (double* p, const X &x) {memcpy(p, &x, sizeof(X));}
+    // In-place DFT of R values
+    template <unsigned R, class X>
+    BA_SIMD_INLINE void butterfly (X* ar, X* ai, const double* omr, const double* omi) {
+        if constexpr (R == 2) {
+            X tr = ar[0] - ar[1], ti = ai[0] - ai[1];
+            ar[0] += ar[1];
+            ai[0] += ai[1];
+            ar[1] = tr;
+            ai[1] = ti;
+        }
+        else if constexpr (R == 3) {
+            const double h = 0.86602540378443864676;
+            X sr = ar[1] + ar[2], si = ai[1] + ai[2], dr = (ar[1] - ar[2]) * h, di = (ai[1] - ai[2]) * h;
+            X mr = ar[0] - sr * 0.5, mi = ai[0] - si * 0.5;
+            ar[0] += sr;
+            ai[0] += si;
+            ar[1] = mr + di;
+            ai[1] = mi - dr;
+            ar[2] = mr - di;
+            ai[2] = mi + dr;
+        }
+        else if constexpr (R == 4) {
+            X s0r = ar[0] + ar[2], s0i = ai[0] + ai[2], d0r = ar[0] - ar[2], d0i = ai[0] - ai[2];
+            X s1r = ar[1] + ar[3], s1i = ai[1] + ai[3], d1r = ar[1] - ar[3], d1i = ai[1] - ai[3];
+            ar[0] = s0r + s1r;
+            ai[0] = s0i + s1i;
+            ar[2] = s0r - s1r;
+            ai[2] = s0i - s1i;
+            ar[1] = d0r + d1i;
+            ai[1] = d0i - d1r;
+            ar[3] = d0r - d1i;
+            ai[3] = d0i + d1r;
+        }
+        else {
+            X br[R], bi[R];
+            for (unsigned k = 0; k < R; k++) {
+                br[k] = ar[0];
+                bi[k] = ai[0];
+                for (unsigned j = 1, e = k; j < R; j++, e = (e + k) % R) {
+                    br[k] += ar[j] * omr[e] - ai[j] * omi[e];
+                    bi[k] += ar[j] * omi[e] + ai[j] * omr[e];
+                }
+            }
+            for (unsigned k = 0; k < R; k++) {
+                ar[k] = br[k];
+                ai[k] = bi[k];
+            }
+        }
+    }
+    // Butterfly p of stage on elements q ... q + lanes - 1 of every stride
+    template <unsigned R, class X>
+    BA_SIMD_INLINE void stageBlock (const Stage &S, size_t p, size_t q, const double* xr, const double* xi, double* yr, double* yi) {
+        X ar[R], ai[R];
+        for (unsigned j = 0; j < R; j++) {
+            load(ar[j], xr + q + S.s * (p + j * S.m));
+            load(ai[j], xi + q + S.s * (p + j * S.m));
+        }
+        butterfly<R>(ar, ai, S.omr.data(), S.omi.data());
+        const double* wr = S.wr.data() + p * (R - 1), *wi = S.wi.data() + p * (R - 1);
+        double* outR = yr + q + S.s * R * p, *outI = yi + q + S.s * R * p;
+        store(outR, ar[0]);
+        store(outI, ai[0]);
+        for (unsigned k = 1; k < R; k++) {
+            X tr = ar[k] * wr[k - 1] - ai[k] * wi[k - 1], ti = ar[k] * wi[k - 1] + ai[k] * wr[k - 1];
+            store(outR + S.s * k, tr);
+            store(outI + S.s * k, ti);
+        }
+    }
+    template <unsigned W, unsigned R>
+    BA_SIMD_INLINE void stageLoop (const Stage &S, const double* xr, const double* xi, double* yr, double* yi) {
+        typedef double V __attribute__((vector_size(W)));
+        const size_t L = W / sizeof(double);
+        for (size_t p = 0; p < S.m; p++) {
+            size_t q = 0;
+            if constexpr (W > sizeof(double)) for (; q + L <= S.s; q += L) stageBlock<R, V>(S, p, q, xr, xi, yr, yi);
+            for (; q < S.s; q++) stageBlock<R, double>(S, p, q, xr, xi, yr, yi);
+        }
+    }
+    template <unsigned W>
+    BA_SIMD_INLINE void stageRadix (const Stage &S, const double* xr, const double* xi, double* yr, double* yi) {
+        switch (S.radix) {
+            case 2: stageLoop<W, 2>(S, xr, xi, yr, yi); return;
+            case 3: stageLoop<W, 3>(S, xr, xi, yr, yi); return;
+            case 4: stageLoop<W, 4>(S, xr, xi, yr, yi); return;
+            case 5: stageLoop<W, 5>(S, xr, xi, yr, yi); return;
+            case 7: stageLoop<W, 7>(S, xr, xi, yr, yi); return;
+            case 11: stageLoop<W, 11>(S, xr, xi, yr, yi); return;
+            default: stageLoop<W, 13>(S, xr, xi, yr, yi); return;
+        }
+    }
+    #ifdef BA_SIMD_DISPATCH
+        __attribute__((target("sse2"))) inline void stageSse2 (const Stage &S, const double* xr, const double* xi, double* yr, double* yi) {stageRadix<16>(S, xr, xi, yr, yi);}
+        __attribute__((target("avx2"))) inline void stageAvx2 (const Stage &S, const double* xr, const double* xi, double* yr, double* yi) {stageRadix<32>(S, xr, xi, yr, yi);}
+        __attribute__((target("avx512f"))) inline void stageAvx512 (const Stage &S, const double* xr, const double* xi, double* yr, double* yi) {stageRadix<64>(S, xr, xi, yr, yi);}
+    #endif // BA_SIMD_DISPATCH
+    /**
+     * @brief Run one stage from x to y. Buffers must not overlap
+     */
+    inline void stage (const Stage &S, const double* xr, const double* xi, double* yr, double* yi) {
+        #ifdef BA_SIMD_DISPATCH
+            switch (Simd::level()) {
+                case Simd::SIMD_AVX512: stageAvx512(S, xr, xi, yr, yi); return;
+                case Simd::SIMD_AVX2: stageAvx2(S, xr, xi, yr, yi); return;
+                case Simd::SIMD_SSE2: stageSse2(S, xr, xi, yr, yi); return;
+                default: break;
+            }
+        #endif // BA_SIMD_DISPATCH
+        stageRadix<sizeof(double)>(S, xr, xi, yr, yi);
+    }
+    /**
+     * @brief Get smallest length of form 2^a 3^b 5^c not less than n
+     */
+    inline size_t goodSize (size_t n) {
+        size_t best = 1;
+        while (best < n) best <<= 1;
+        for (size_t p5 = 1; p5 < best; p5 *= 5) {
+            for (size_t p35 = p5; p35 < best; p35 *= 3) {
+                size_t v = p35;
+                while (v < n) v <<= 1;
+                if (v < best) best = v;
+            }
+        }
+        return best;
+    }
+    class Plan;
+    inline shared_ptr<const Plan> plan (size_t n);
+    /**
+     * @brief Transform plan of one length: Stockham stages or Bluestein chirps with inner plan
+     */
+    class Plan {
+        private:
+            size_t n;
+            vector<Stage> stages;
+            shared_ptr<const Plan> inner;       // Bluestein convolution length plan
+            vector<double> cr, ci;              // Chirp e^(-i pi k^2 / n)
+            vector<double> br, bi;              // Spectrum of conjugate chirp, scaled by 1 / inner length
+            void Stockham (const vector<unsigned> &Radices) {
+                size_t len = this->n, s = 1;
+                for (unsigned r : Radices) {
+                    Stage S;
+                    S.radix = r;
+                    S.m = len / r;
+                    S.s = s;
+                    S.wr.resize(S.m * (r - 1));
+                    S.wi.resize(S.m * (r - 1));
+                    for (size_t p = 0; p < S.m; p++) {
+                        for (unsigned k = 1; k < r; k++) {
+                            double angle = 2.0 * Pi * (double) (p * k % len) / (double) len;
+                            S.wr[p * (r - 1) + k - 1] = cos(angle);
+                            S.wi[p * (r - 1) + k - 1] = -sin(angle);
+                        }
+                    }
+                    for (unsigned j = 0; j < r; j++) {
+                        S.omr.push_back(cos(2.0 * Pi * j / r));
+                        S.omi.push_back(-sin(2.0 * Pi * j / r));
+                    }
+                    this->stages.push_back(S);
+                    len = S.m;
+                    s *= r;
+                }
+            }
+            void Bluestein () {
+                size_t M = goodSize(2 * this->n - 1);
+                this->inner = plan(M);
+                this->cr.resize(this->n);
+                this->ci.resize(this->n);
+                // k^2 mod 2n grows by 2k + 1, keeps angles exact for any length
+                for (size_t k = 0, q = 0; k < this->n; k++) {
+                    double angle = Pi * (double) q / (double) this->n;
+                    this->cr[k] = cos(angle);
+                    this->ci[k] = -sin(angle);
+                    q = (q + 2 * k + 1) % (2 * this->n);
+                }
+                this->br.assign(M, 0.0);
+                this->bi.assign(M, 0.0);
+                for (size_t k = 0; k < this->n; k++) {
+                    this->br[k] = this->cr[k];
+                    this->bi[k] = -this->ci[k];
+                    if (k > 0) {
+                        this->br[M - k] = this->cr[k];
+                        this->bi[M - k] = -this->ci[k];
+                    }
+                }
+                vector<double> work(this->inner->workSize());
+                this->inner->run(this->br.data(), this->bi.data(), work.data(), false);
+                for (size_t i = 0; i < M; i++) {
+                    this->br[i] /= (double) M;
+                    this->bi[i] /= (double) M;
+                }
+            }
+        public:
+            /**
+             * @brief Build plan of length N
+             */
+            explicit Plan (size_t N) : n(N) {
+                if (N == 0) throw std::invalid_argument("Transform length must be at least 1!");
+                vector<unsigned> Radices;
+                size_t rest = N;
+                while (rest % 4 == 0) {
+                    Radices.push_back(4);
+                    rest /= 4;
+                }
+                for (unsigned r : {2u, 3u, 5u, 7u, 11u, 13u}) {
+                    while (rest % r == 0) {
+                        Radices.push_back(r);
+                        rest /= r;
+                    }
+                }
+                if (rest == 1) this->Stockham(Radices);
+                else this->Bluestein();
+            }
+            size_t size () const {return n;}
+            bool bluestein () const {return inner != nullptr;}
+            /**
+             * @brief Get number of doubles run() needs as work buffer
+             */
+            size_t workSize () const {return inner ? 2 * inner->size() + inner->workSize() : 2 * n;}
+            /**
+             * @brief Transform split complex values in place (inverse is not scaled)
+             * @param re Real parts (n values)
+             * @param im Imaginary parts (n values)
+             * @param work Work buffer of workSize() doubles
+             * @param inverse Inverse transform
+             */
+            void run (double* re, double* im, double* work, bool inverse) const {
+                // Inverse transform is conj(DFT(conj(x)))
+                if (inverse) for (size_t i = 0; i < this->n; i++) im[i] = -im[i];
+                if (this->inner) {
+                    size_t M = this->inner->size();
+                    double* ar = work, *ai = work + M, *iw = work + 2 * M;
+                    for (size_t k = 0; k < this->n; k++) {
+                        ar[k] = re[k] * this->cr[k] - im[k] * this->ci[k];
+                        ai[k] = re[k] * this->ci[k] + im[k] * this->cr[k];
+                    }
+                    fill(ar + this->n, ar + M, 0.0);
+                    fill(ai + this->n, ai + M, 0.0);
+                    this->inner->run(ar, ai, iw, false);
+                    for (size_t i = 0; i < M; i++) {
+                        double r = ar[i] * this->br[i] - ai[i] * this->bi[i];
+                        ai[i] = ar[i] * this->bi[i] + ai[i] * this->br[i];
+                        ar[i] = r;
+                    }
+                    this->inner->run(ar, ai, iw, true);
+                    for (size_t k = 0; k < this->n; k++) {
+                        re[k] = ar[k] * this->cr[k] - ai[k] * this->ci[k];
+                        im[k] = ar[k] * this->ci[k] + ai[k] * this->cr[k];
+                    }
+                }
+                else {
+                    double* xr = re, *xi = im, *yr = work, *yi = work + this->n;
+                    for (const Stage &S : this->stages) {
+                        stage(S, xr, xi, yr, yi);
+                        swap(xr, yr);
+                        swap(xi, yi);
+                    }
+                    if (xr != re) {
+                        copy(xr, xr + this->n, re);
+                        copy(xi, xi + this->n, im);
+                    }
+                }
+                if (inverse) for (size_t i = 0; i < this->n; i++) im[i] = -im[i];
+            }
+    };
+    /**
+     * @brief Real transform of even length n through complex transform of length n / 2
+     */
+    struct RealPlan {
+        shared_ptr<const Plan> half;
+        vector<double> wr, wi;      // e^(-2 pi i k / n), k < n / 2
+        explicit RealPlan (size_t N) : half(plan(N / 2)), wr(N / 2), wi(N / 2) {
+            for (size_t k = 0; k < N / 2; k++) {
+                this->wr[k] = cos(2.0 * Pi * (double) k / (double) N);
+                this->wi[k] = -sin(2.0 * Pi * (double) k / (double) N);
+            }
+        }
+    };
+    // Plans shared between threads, built once per length
+    template <class P>
+    struct Cache {
+        static mutex& lock () {
+            static mutex L;
+            return L;
+        }
+        static unordered_map<size_t, shared_ptr<const P>>& plans () {
+            static unordered_map<size_t, shared_ptr<const P>> M;
+            return M;
+        }
+        static shared_ptr<const P> get (size_t n) {
+            {
+                lock_guard<mutex> Guard(lock());
+                auto it = plans().find(n);
+                if (it != plans().end()) return it->second;
+            }
+            // Built without the lock, Bluestein plans request their inner plan
+            shared_ptr<const P> Built = make_shared<const P>(n);
+            lock_guard<mutex> Guard(lock());
+            return plans().emplace(n, Built).first->second;
+        }
+        static void clear () {
+            lock_guard<mutex> Guard(lock());
+            plans().clear();
+        }
+    };
+    /**
+     * @brief Get cached plan of length n
+     */
+    inline shared_ptr<const Plan> plan (size_t n) {return Cache<Plan>::get(n);}
+    inline shared_ptr<const RealPlan> realPlan (size_t n) {return Cache<RealPlan>::get(n);}
+    /**
+     * @brief Release all cached plans (plans in use stay valid)
+     */
+    inline void clearPlans () {
+        Cache<Plan>::clear();
+        Cache<RealPlan>::clear();
+    }
+    /**
+     * @brief Transform every line along one axis of split complex buffer, lines run in parallel
+     * @param outer Product of lengths before axis
+     * @param len Axis length
+     * @param inner Product of lengths after axis (distance of line elements)
+     * @param inverse Inverse transform scaled by 1 / len
+     */
+    inline void transformLines (double* re, double* im, size_t outer, size_t len, size_t inner, bool inverse) {
+        if (len < 2 || outer == 0 || inner == 0) return;
+        shared_ptr<const Plan> P = plan(len);
+        // Strided lines are gathered Block at a time, so every cache line of a column is used whole
+        const size_t Block = 8, groups = (inner + Block - 1) / Block, units = outer * groups;
+        const size_t width = inner < Block ? inner : Block;
+        const double scale = inverse ? 1.0 / (double) len : 1.0;
+        Parallel::forChunks(units, Parallel::chunks(units, (1u << 14) / (len * width) + 1), [&] (unsigned, unsigned long long b, unsigned long long e) {
+            vector<double> work(P->workSize()), lr(inner > 1 ? width * len : 0), li(lr.size());
+            for (unsigned long long u = b; u < e; u++) {
+                size_t o = u / groups, c0 = u % groups * Block, cnt = inner - c0 < Block ? inner - c0 : Block;
+                double* baseR = re + o * len * inner + c0, *baseI = im + o * len * inner + c0;
+                if (inner == 1) {
+                    P->run(baseR, baseI, work.data(), inverse);
+                    if (inverse) {
+                        for (size_t k = 0; k < len; k++) {
+                            baseR[k] *= scale;
+                            baseI[k] *= scale;
+                        }
+                    }
+                    continue;
+                }
+                for (size_t k = 0; k < len; k++) {
+                    for (size_t c = 0; c < cnt; c++) {
+                        lr[c * len + k] = baseR[k * inner + c];
+                        li[c * len + k] = baseI[k * inner + c];
+                    }
+                }
+                for (size_t c = 0; c < cnt; c++) P->run(lr.data() + c * len, li.data() + c * len, work.data(), inverse);
+                for (size_t k = 0; k < len; k++) {
+                    for (size_t c = 0; c < cnt; c++) {
+                        baseR[k * inner + c] = lr[c * len + k] * scale;
+                        baseI[k * inner + c] = li[c * len + k] * scale;
+                    }
+                }
+            }
+        });
+    }
+    inline double realPart (double v) {return v;}
+    inline double realPart (const complex<double> &v) {return v.real();}
+    inline double imagPart (double) {return 0.0;}
+    inline double imagPart (const complex<double> &v) {return v.imag();}
+    // Split values into real and imaginary buffers
+    template <class T>
+    void split (const T* X, size_t n, vector<double> &re, vector<double> &im) {
+        re.resize(n);
+        im.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            re[i] = realPart(X[i]);
+            im[i] = imagPart(X[i]);
+        }
+    }
+    inline Array<complex<double>> join (const vector<double> &re, const vector<double> &im) {
+        Array<complex<double>> X((unsigned) re.size());
+        complex<double>* d = X.data();
+        for (size_t i = 0; i < re.size(); i++) d[i] = complex<double>(re[i], im[i]);
+        return X;
+    }
+    template <class T>
+    Array<complex<double>> line (const Array<T> &X, bool inverse) {
+        if (X.size() == 0) throw std::invalid_argument("Transform length must be at least 1!");
+        vector<double> re, im;
+        split(X.data(), X.size(), re, im);
+        transformLines(re.data(), im.data(), 1, re.size(), 1, inverse);
+        return join(re, im);
+    }
+    /**
+     * @brief Transform NDArray along given axes
+     * @param Axes Axes, LastAxis selects last one
+     * @param Keep If non-zero, keep first Keep values along last transformed axis (rfft)
+     */
+    template <class T>
+    NDArray<complex<double>> alongAxes (const NDArray<T> &X, initializer_list<unsigned> Axes, bool inverse, unsigned Keep = 0) {
+        Array<unsigned> Shape = X.shape();
+        unsigned dims = X.dimension(), last = 0;
+        vector<double> re, im;
+        Array<T> Flat = X.flatten();
+        split(Flat.data(), Flat.size(), re, im);
+        for (unsigned axis : Axes) {
+            if (axis == LastAxis) axis = dims - 1;
+            if (dims == 0 || axis >= dims) throw std::invalid_argument("Axis does not exist!");
+            if (Shape[axis] == 0) throw std::invalid_argument("Transform length must be at least 1!");
+            size_t outer = 1, inner = 1;
+            for (unsigned d = 0; d < axis; d++) outer *= Shape[d];
+            for (unsigned d = axis + 1; d < dims; d++) inner *= Shape[d];
+            transformLines(re.data(), im.data(), outer, Shape[axis], inner, inverse);
+            last = axis;
+        }
+        if (Keep == 0 || Keep >= Shape[last]) return NDArray<complex<double>>(dims, Shape, join(re, im));
+        size_t outer = 1, inner = 1, len = Shape[last];
+        for (unsigned d = 0; d < last; d++) outer *= Shape[d];
+        for (unsigned d = last + 1; d < dims; d++) inner *= Shape[d];
+        Shape[last] = Keep;
+        Array<complex<double>> Values((unsigned) (outer * Keep * inner));
+        complex<double>* d = Values.data();
+        for (size_t o = 0; o < outer; o++) {
+            for (size_t k = 0; k < Keep; k++) {
+                for (size_t c = 0; c < inner; c++) {
+                    size_t at = (o * len + k) * inner + c;
+                    d[(o * Keep + k) * inner + c] = complex<double>(re[at], im[at]);
+                }
+            }
+        }
+        return NDArray<complex<double>>(dims, Shape, Values);
+    }
+}
+/**
+ * @brief Discrete Fourier transform X[k] = sum of x[j] e^(-2 pi i j k / n)
+ * @param X Values
+ * @return Array<complex<double>> Spectrum of n values
+ */
+inline Array<complex<double>> fft (const Array<complex<double>> &X) {
+    BA_PROFILE_SCOPE("fft");
+    return FFT::line(X, false);
+}
+/**
+ * @brief Discrete Fourier transform of real values
+ * @param X Values
+ * @return Array<complex<double>> Spectrum of n values
+ */
+inline Array<complex<double>> fft (const Array<double> &X) {
+    BA_PROFILE_SCOPE("fft");
+    return FFT::line(X, false);
+}
+/**
+ * @brief Inverse discrete Fourier transform x[j] = 1 / n * sum of X[k] e^(2 pi i j k / n)
+ * @param X Spectrum
+ * @return Array<complex<double>> Values
+ */
+inline Array<complex<double>> ifft (const Array<complex<double>> &X) {
+    BA_PROFILE_SCOPE("ifft");
+    return FFT::line(X, true);
+}
+/**
+ * @brief Discrete Fourier transform of real values, non-negative frequencies only.
+ *        Even lengths run as complex transform of half length
+ * @param X Values
+ * @return Array<complex<double>> Spectrum of n / 2 + 1 values
+ */
+inline Array<complex<double>> rfft (const Array<double> &X) {
+    BA_PROFILE_SCOPE("rfft");
+    size_t n = X.size(), h = n / 2;
+    if (n % 2 == 1) return FFT::line(X, false).slice(0, (int) h);
+    shared_ptr<const FFT::RealPlan> R = FFT::realPlan(n);
+    // z[k] = x[2k] + i x[2k + 1]
+    vector<double> zr(h), zi(h), work(R->half->workSize());
+    const double* x = X.data();
+    for (size_t k = 0; k < h; k++) {
+        zr[k] = x[2 * k];
+        zi[k] = x[2 * k + 1];
+    }
+    R->half->run(zr.data(), zi.data(), work.data(), false);
+    // Even part E = (Z[k] + conj(Z[h - k])) / 2, odd part O = (Z[k] - conj(Z[h - k])) / 2i, X[k] = E + w^k O
+    Array<complex<double>> Y((unsigned) (h + 1));
+    complex<double>* y = Y.data();
+    for (size_t k = 0; k < h; k++) {
+        size_t j = k == 0 ? 0 : h - k;
+        double er = (zr[k] + zr[j]) * 0.5, ei = (zi[k] - zi[j]) * 0.5;
+        double orr = (zi[k] + zi[j]) * 0.5, oi = (zr[j] - zr[k]) * 0.5;
+        y[k] = complex<double>(er + orr * R->wr[k] - oi * R->wi[k], ei + orr * R->wi[k] + oi * R->wr[k]);
+    }
+    y[h] = complex<double>(zr[0] - zi[0], 0.0);
+    return Y;
+}
+/**
+ * @brief Inverse of rfft()
+ * @param X Spectrum of non-negative frequencies
+ * @param n Output length. Default 0 means 2 * (X.size() - 1)
+ * @return Array<double> Real values
+ */
+inline Array<double> irfft (const Array<complex<double>> &X, unsigned n = 0) {
+    BA_PROFILE_SCOPE("irfft");
+    if (X.size() == 0) throw std::invalid_argument("Transform length must be at least 1!");
+    if (n == 0) n = 2 * (X.size() - 1);
+    if (n == 0) throw std::invalid_argument("Transform length must be at least 1!");
+    size_t h = n / 2;
+    const complex<double>* x = X.data();
+    // Missing frequencies are zero, extra ones are dropped
+    auto at = [&] (size_t k) {return k < X.size() ? x[k] : complex<double>();};
+    Array<double> Y(n);
+    double* y = Y.data();
+    if (n % 2 == 1) {
+        vector<double> re(n), im(n);
+        for (size_t k = 0; k <= h; k++) {
+            re[k] = at(k).real();
+            im[k] = k == 0 ? 0.0 : at(k).imag();
+            if (k > 0) {
+                re[n - k] = re[k];
+                im[n - k] = -im[k];
+            }
+        }
+        FFT::transformLines(re.data(), im.data(), 1, n, 1, true);
+        copy(re.begin(), re.end(), y);
+        return Y;
+    }
+    shared_ptr<const FFT::RealPlan> R = FFT::realPlan(n);
+    // Z[k] = E + i O with E = (X[k] + conj(X[h - k])) / 2, O = (X[k] - conj(X[h - k])) conj(w^k) / 2
+    vector<double> zr(h), zi(h), work(R->half->workSize());
+    for (size_t k = 0; k < h; k++) {
+        complex<double> a = at(k), b = conj(at(h - k));
+        if (k == 0) a = complex<double>(a.real(), 0.0);
+        if (k == 0) b = complex<double>(at(h).real(), 0.0);
+        complex<double> E = (a + b) * 0.5, O = (a - b) * complex<double>(R->wr[k], -R->wi[k]) * 0.5;
+        zr[k] = E.real() - O.imag();
+        zi[k] = E.imag() + O.real();
+    }
+    FFT::transformLines(zr.data(), zi.data(), 1, h, 1, true);
+    for (size_t k = 0; k < h; k++) {
+        y[2 * k] = zr[k];
+        y[2 * k + 1] = zi[k];
+    }
+    return Y;
+}
+/**
+ * @brief Discrete Fourier transform along axis
+ * @param X NDArray
+ * @param axis Axis. Default last axis
+ * @return NDArray<complex<double>>
+ */
+inline NDArray<complex<double>> fft (const NDArray<complex<double>> &X, unsigned axis = FFT::LastAxis) {
+    BA_PROFILE_SCOPE("fft");
+    return FFT::alongAxes(X, {axis}, false);
+}
+/**
+ * @brief Discrete Fourier transform of real values along axis
+ * @param X NDArray
+ * @param axis Axis. Default last axis
+ * @return NDArray<complex<double>>
+ */
+inline NDArray<complex<double>> fft (const NDArray<double> &X, unsigned axis = FFT::LastAxis) {
+    BA_PROFILE_SCOPE("fft");
+    return FFT::alongAxes(X, {axis}, false);
+}
+/**
+ * @brief Inverse discrete Fourier transform along axis
+ * @param X NDArray
+ * @param axis Axis. Default last axis
+ * @return NDArray<complex<double>>
+ */
+inline NDArray<complex<double>> ifft (const NDArray<complex<double>> &X, unsigned axis = FFT::LastAxis) {
+    BA_PROFILE_SCOPE("ifft");
+    return FFT::alongAxes(X, {axis}, true);
+}
+/**
+ * @brief Discrete Fourier transform of real values along axis, non-negative frequencies only
+ * @param X NDArray
+ * @param axis Axis. Default last axis
+ * @return NDArray<complex<double>> Axis length is shape(axis) / 2 + 1
+ */
+inline NDArray<complex<double>> rfft (const NDArray<double> &X, unsigned axis = FFT::LastAxis) {
+    BA_PROFILE_SCOPE("rfft");
+    unsigned a = axis == FFT::LastAxis && X.dimension() > 0 ? X.dimension() - 1 : axis;
+    if (a >= X.dimension()) throw std::invalid_argument("Axis does not exist!");
+    return FFT::alongAxes(X, {a}, false, X.shape(a) / 2 + 1);
+}
+/**
+ * @brief 2-D discrete Fourier transform over last two axes. Lines of each axis run in parallel
+ * @param X NDArray with at least 2 dimensions
+ * @return NDArray<complex<double>>
+ */
+inline NDArray<complex<double>> fft2 (const NDArray<complex<double>> &X) {
+    BA_PROFILE_SCOPE("fft2");
+    if (X.dimension() < 2) throw std::invalid_argument("Axis does not exist!");
+    return FFT::alongAxes(X, {X.dimension() - 1, X.dimension() - 2}, false);
+}
+/**
+ * @brief 2-D discrete Fourier transform of real values over last two axes
+ * @param X NDArray with at least 2 dimensions
+ * @return NDArray<complex<double>>
+ */
+inline NDArray<complex<double>> fft2 (const NDArray<double> &X) {
+    BA_PROFILE_SCOPE("fft2");
+    if (X.dimension() < 2) throw std::invalid_argument("Axis does not exist!");
+    return FFT::alongAxes(X, {X.dimension() - 1, X.dimension() - 2}, false);
+}
+/**
+ * @brief Inverse 2-D discrete Fourier transform over last two axes
+ * @param X NDArray with at least 2 dimensions
+ * @return NDArray<complex<double>>
+ */
+inline NDArray<complex<double>> ifft2 (const NDArray<complex<double>> &X) {
+    BA_PROFILE_SCOPE("ifft2");
+    if (X.dimension() < 2) throw std::invalid_argument("Axis does not exist!");
+    return FFT::alongAxes(X, {X.dimension() - 1, X.dimension() - 2}, true);
+}
+#endif // !FFT_H
@@ -0,0 +1,284 @@
+/**
+ * @file groupby.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Group-by aggregation for Better Array. Aggregate Array values by Array keys.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef GROUPBY_H
+#define GROUPBY_H
+#include <algorithm>
+#include <stdexcept>
+#include "better_array.h"
+using namespace std;
+// Key grouping strategy
+enum GroupMethod {
+    GROUP_AUTO = 0,         // Hash (partitioned for large inputs), sort if keys are not hashable
+    GROUP_HASH = 1,         // Single open-addressing hash table
+    GROUP_SORT = 2,         // Stable sort of keys, needs only operator<
+    GROUP_PARTITIONED = 3   // Hash partitions built in parallel, one table per thread
+};
+/**
+ * @brief Result of group-by aggregation. keys[i] is aggregated into values[i]
+ *
+ * Hash and partitioned methods keep keys in order of first appearance, sort method in ascending order.
+ */
+template <class K, class R>
+struct GroupResult {
+    Array<K> keys;
+    Array<R> values;
+};
+/**
+ * @brief Grouped view of values by keys. Keys are factorized once into dense group ids,
+ *        every aggregation is then a single pass over ids and values into a per-group accumulator Array
+ *
+ * Keys and Values are copied in (shared, not copied, under BETTER_ARRAY_COW), so temporaries are safe to pass.
+ */
+template <class K, class V>
+class GroupBy {
+    private:
+        Array<K> Keys;
+        Array<V> Values;
+        Array<int> codes;           // Group id of every row
+        Array<int> firstRow;        // First row of every group
+        Array<K> groupKeys;
+        static const unsigned PartitionedMin = 1u << 20;
+        // Unchecked element read (ArrayMask has no contiguous storage)
+        template <class X>
+        static typename conditional<is_same<X, bool>::value, bool, const X&>::type at (const Array<X> &Arr, unsigned long long i) {
+            if constexpr (is_same<X, bool>::value) return Arr[(int) i];
+            else return Arr.data()[i];
+        }
+        void factorizeHash () {
+            unsigned n = this->Keys.size();
+            Hashing::KeyIndex<K> Index;
+            this->codes.reserve(n);
+            for (unsigned i = 0; i < n; i++) {
+                int id = Index.insert(at(this->Keys, i));
+                if (id == (int) this->firstRow.size()) this->firstRow.append((int) i);
+                this->codes.pushBackUnchecked(id);
+            }
+            this->groupKeys = Array<K>(Index.keyList());
+        }
+        void factorizeSort () {
+            unsigned n = this->Keys.size();
+            Array<int> P = this->Keys.argsort();
+            this->codes = Array<int>(n);
+            int g = -1;
+            for (unsigned i = 0; i < n; i++) {
+                int row = P[(int) i];
+                if (g < 0 || at(this->groupKeys, g) < at(this->Keys, row)) {
+                    g++;
+                    this->groupKeys.append(at(this->Keys, row));
+                    this->firstRow.append(row);
+                }
+                this->codes[row] = g;
+            }
+        }
+        // Rows are radix-partitioned by hash, then every thread factorizes its own partitions with a private
+        // table. Local ids become global by adding partition offsets and are renumbered by first appearance
+        void factorizePartitioned () {
+            unsigned n = this->Keys.size();
+            unsigned chunkCount = Parallel::chunks(n, 1u << 16), parts = chunkCount;
+            vector<unsigned long long> hashes(n);
+            vector<unsigned> histogram((unsigned long long) chunkCount * parts, 0);
+            Parallel::forChunks(n, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                unsigned* H = &histogram[(unsigned long long) c * parts];
+                for (unsigned long long i = b; i < e; i++) {
+                    hashes[i] = Hashing::hashOf(at(this->Keys, i));
+                    H[(hashes[i] >> 40) % parts]++;
+                }
+            });
+            // Exclusive prefix over (partition, chunk) keeps rows of every partition in increasing order
+            vector<unsigned> start(parts + 1, 0), cursor((unsigned long long) chunkCount * parts);
+            unsigned total = 0;
+            for (unsigned p = 0; p < parts; p++) {
+                start[p] = total;
+                for (unsigned c = 0; c < chunkCount; c++) {
+                    cursor[(unsigned long long) c * parts + p] = total;
+                    total += histogram[(unsigned long long) c * parts + p];
+                }
+            }
+            start[parts] = total;
+            vector<unsigned> rows(n);
+            Parallel::forChunks(n, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                unsigned* Cur = &cursor[(unsigned long long) c * parts];
+                for (unsigned long long i = b; i < e; i++) rows[Cur[(hashes[i] >> 40) % parts]++] = (unsigned) i;
+            });
+            this->codes = Array<int>(n);
+            int* C = this->codes.data();
+            vector<vector<int>> firsts(parts);
+            vector<Hashing::KeyIndex<K>> indices(parts);
+            Parallel::forChunks(parts, parts, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                for (unsigned long long p = b; p < e; p++) {
+                    for (unsigned r = start[p]; r < start[p + 1]; r++) {
+                        unsigned i = rows[r];
+                        int id = indices[p].insert(at(this->Keys, i), hashes[i]);
+                        if (id == (int) firsts[p].size()) firsts[p].push_back((int) i);
+                        C[i] = id;
+                    }
+                }
+            });
+            vector<int> offset(parts + 1, 0);
+            for (unsigned p = 0; p < parts; p++) offset[p + 1] = offset[p] + (int) indices[p].size();
+            unsigned groups = (unsigned) offset[parts];
+            // Order groups by first row so the result matches the single hash table
+            Array<int> firstAll(groups);
+            for (unsigned p = 0; p < parts; p++) {
+                for (unsigned j = 0; j < firsts[p].size(); j++) firstAll[offset[p] + (int) j] = firsts[p][j];
+            }
+            Array<int> order = firstAll.argsort();
+            Array<int> rank(groups);
+            this->groupKeys.reserve(groups);
+            this->firstRow.reserve(groups);
+            for (unsigned r = 0; r < groups; r++) {
+                int g = order[(int) r];
+                rank[g] = (int) r;
+                this->firstRow.pushBackUnchecked(firstAll[g]);
+                this->groupKeys.pushBackUnchecked(at(this->Keys, firstAll[g]));
+            }
+            const int* Rank = rank.data();
+            Parallel::forChunks(n, chunkCount, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                for (unsigned long long i = b; i < e; i++) C[i] = Rank[offset[(hashes[i] >> 40) % parts] + C[i]];
+            });
+        }
+        /**
+         * @brief Fold values into per-group accumulators
+         * @param Init Initial accumulator of every group
+         * @param acc Callable acc(R& accumulator, const V& value)
+         * @param merge Callable merge(R& into, const R& from), used to join per-thread accumulators
+         */
+        template <class R, class Acc, class Merge>
+        Array<R> fold (const Array<R> &Init, Acc acc, Merge merge) const {
+            unsigned n = this->codes.size(), groups = this->groupKeys.size();
+            const int* C = this->codes.data();
+            // Per-thread accumulators only pay off while they stay small compared to the input
+            unsigned parts = (unsigned long long) groups * 8 < n ? Parallel::chunks(n, 1u << 16) : 1;
+            vector<Array<R>> partial(parts, Init);
+            Parallel::forChunks(n, parts, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                R* Acc_ = partial[c].data();
+                for (unsigned long long i = b; i < e; i++) acc(Acc_[C[i]], at(this->Values, i));
+            });
+            R* Out = partial[0].data();
+            for (unsigned c = 1; c < parts; c++) {
+                const R* From = partial[c].data();
+                for (unsigned g = 0; g < groups; g++) merge(Out[g], From[g]);
+            }
+            return partial[0];
+        }
+        // Initial accumulators taken from first value of every group (for min / max)
+        Array<V> firstValues () const {
+            Array<V> X;
+            X.reserve(this->groupKeys.size());
+            for (unsigned g = 0; g < this->groupKeys.size(); g++) X.pushBackUnchecked(at(this->Values, this->firstRow[(int) g]));
+            return X;
+        }
+    public:
+        /**
+         * @brief Construct a new GroupBy object
+         * @param keys Group keys
+         * @param values Values to aggregate, same length as keys
+         * @param Method Key grouping strategy. Default GROUP_AUTO
+         */
+        GroupBy (const Array<K> &keys, const Array<V> &values, GroupMethod Method = GROUP_AUTO) : Keys(keys), Values(values) {
+            BA_PROFILE_SCOPE("GroupBy::factorize");
+            if (keys.size() != values.size()) throw std::invalid_argument("Keys and Values length must be the same!");
+            if constexpr (!Hashing::isHashable<K>::value) {
+                if (Method == GROUP_HASH || Method == GROUP_PARTITIONED) throw std::invalid_argument("Keys are not hashable, use GROUP_SORT!");
+                factorizeSort();
+            }
+            else {
+                if (Method == GROUP_AUTO) Method = keys.size() >= PartitionedMin && Parallel::threads() > 1 ? GROUP_PARTITIONED : GROUP_HASH;
+                if (Method == GROUP_SORT) factorizeSort();
+                else if (Method == GROUP_PARTITIONED) factorizePartitioned();
+                else factorizeHash();
+            }
+        }
+        /**
+         * @brief Get number of groups
+         */
+        unsigned groups () const {return this->groupKeys.size();}
+        /**
+         * @brief Get distinct keys in result order
+         */
+        const Array<K>& keys () const {return this->groupKeys;}
+        /**
+         * @brief Get group id of every row (index into keys())
+         */
+        const Array<int>& groupIds () const {return this->codes;}
+        /**
+         * @brief Aggregate values of every group with custom function
+         * @param Init Initial accumulator
+         * @param acc Callable acc(R& accumulator, const V& value)
+         * @param merge Callable merge(R& into, const R& from)
+         * @return GroupResult<K, R>
+         */
+        template <class R, class Acc, class Merge>
+        GroupResult<K, R> aggregate (const R& Init, Acc acc, Merge merge) const {
+            Array<R> I(this->groupKeys.size());
+            I.fill(Init);
+            return GroupResult<K, R>{this->groupKeys, fold(I, acc, merge)};
+        }
+        /**
+         * @brief Sum values of every group
+         * @return GroupResult<K, V>
+         */
+        GroupResult<K, V> sum () const {
+            BA_PROFILE_SCOPE("GroupBy::sum");
+            auto add = [] (V& a, const V& v) {a += v;};
+            return aggregate(V(), add, add);
+        }
+        /**
+         * @brief Count rows of every group
+         * @return GroupResult<K, unsigned>
+         */
+        GroupResult<K, unsigned> count () const {
+            BA_PROFILE_SCOPE("GroupBy::count");
+            return aggregate(0u, [] (unsigned& a, const V&) {a++;}, [] (unsigned& a, const unsigned& b) {a += b;});
+        }
+        /**
+         * @brief Average values of every group
+         * @return GroupResult<K, double>
+         */
+        GroupResult<K, double> mean () const {
+            BA_PROFILE_SCOPE("GroupBy::mean");
+            GroupResult<K, double> Sums = aggregate(0.0, [] (double& a, const V& v) {a += (double) v;}, [] (double& a, const double& b) {a += b;});
+            GroupResult<K, unsigned> Counts = count();
+            for (unsigned g = 0; g < Sums.values.size(); g++) Sums.values[(int) g] /= (double) Counts.values[(int) g];
+            return Sums;
+        }
+        /**
+         * @brief Get maximum value of every group
+         * @return GroupResult<K, V>
+         */
+        GroupResult<K, V> max () const {
+            BA_PROFILE_SCOPE("GroupBy::max");
+            auto take = [] (V& a, const V& v) {if (a < v) a = v;};
+            return GroupResult<K, V>{this->groupKeys, fold(firstValues(), take, take)};
+        }
+        /**
+         * @brief Get minimum value of every group
+         * @return GroupResult<K, V>
+         */
+        GroupResult<K, V> min () const {
+            BA_PROFILE_SCOPE("GroupBy::min");
+            auto take = [] (V& a, const V& v) {if (v < a) a = v;};
+            return GroupResult<K, V>{this->groupKeys, fold(firstValues(), take, take)};
+        }
+};
+/**
+ * @brief Group values by keys, e.g. groupby(Keys, Values).sum()
+ * @param Keys Group keys
+ * @param Values Values to aggregate, same length as Keys
+ * @param Method Key grouping strategy. Default GROUP_AUTO
+ * @return GroupBy<K, V>
+ */
+template <class K, class V>
+GroupBy<K, V> groupby (const Array<K> &Keys, const Array<V> &Values, GroupMethod Method = GROUP_AUTO) {
+    return GroupBy<K, V>(Keys, Values, Method);
+}
+#endif // !GROUPBY_H
@@ -0,0 +1,206 @@
+/**
+ * @file join.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Joins for Better Array. Match keys between two Arrays and get index pairs.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef JOIN_H
+#define JOIN_H
+#include <stdexcept>
+#include "better_array.h"
+using namespace std;
+// Kind of join
+enum JoinType {
+    INNER_JOIN = 0,     // Every matching (left, right) pair
+    LEFT_JOIN = 1,      // Inner pairs plus unmatched left rows paired with -1
+    SEMI_JOIN = 2,      // Left rows having at least one match
+    ANTI_JOIN = 3       // Left rows without any match
+};
+// Join algorithm
+enum JoinMethod {
+    JOIN_AUTO = 0,          // Merge join if both sides are sorted, otherwise hash join, partitioned for large inputs
+    JOIN_HASH = 1,          // Hash table built on right keys, left keys probe it
+    JOIN_MERGE = 2,         // Both sides must be sorted ascending, no hashing needed
+    JOIN_PARTITIONED = 3    // Radix-partitioned hash tables built and probed in parallel
+};
+/**
+ * @brief Matching index pairs. Row i joins left[i] with right[i].
+ *
+ * Pairs follow left row order, then right row order. Semi and anti joins fill only left,
+ * left join marks unmatched left rows with right index -1.
+ * Feed indices to Array::take() or Table::take() to gather joined columns.
+ */
+struct JoinResult {
+    Array<int> left;
+    Array<int> right;
+};
+/**
+ * @brief Right side keys grouped into hash partitions. Every partition maps key id to a run of right rows
+ */
+template <class T>
+class JoinBuild {
+    private:
+        unsigned parts;
+        vector < Hashing::KeyIndex < T > > Index;
+        vector < vector < unsigned > > runStart;    // Per partition, per key id: first position in rows
+        vector < vector < int > > rows;             // Per partition: right rows grouped by key id
+        static unsigned long long partitionOf (unsigned long long h, unsigned parts) {return (h >> 40) % parts;}
+        void buildPartition (unsigned p, const T* Keys, const vector<unsigned long long> &hashes, const vector<unsigned> &members) {
+            vector<int> ids(members.size());
+            vector<unsigned> counts;
+            for (unsigned j = 0; j < members.size(); j++) {
+                unsigned r = members[j];
+                ids[j] = this->Index[p].insert(Keys[r], hashes[r]);
+                if ((unsigned) ids[j] == counts.size()) counts.push_back(0);
+                counts[ids[j]]++;
+            }
+            vector<unsigned> &S = this->runStart[p];
+            S.assign(counts.size() + 1, 0);
+            for (unsigned k = 0; k < counts.size(); k++) S[k + 1] = S[k] + counts[k];
+            vector<unsigned> cursor(S.begin(), S.end() - 1);
+            this->rows[p].resize(members.size());
+            for (unsigned j = 0; j < members.size(); j++) this->rows[p][cursor[ids[j]]++] = (int) members[j];
+        }
+    public:
+        /**
+         * @brief Build hash partitions over right keys
+         * @param Right Right side keys
+         * @param Parts Partition count (1 = single table)
+         */
+        JoinBuild (const Array<T> &Right, unsigned Parts) : parts(Parts), Index(Parts), runStart(Parts), rows(Parts) {
+            unsigned m = Right.size();
+            const T* Keys = Right.data();
+            vector<unsigned long long> hashes(m);
+            vector < vector < unsigned > > members(this->parts);
+            for (unsigned r = 0; r < m; r++) {
+                hashes[r] = Hashing::hashOf(Keys[r]);
+                members[partitionOf(hashes[r], this->parts)].push_back(r);
+            }
+            Parallel::forChunks(this->parts, this->parts, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                for (unsigned long long p = b; p < e; p++) buildPartition((unsigned) p, Keys, hashes, members[p]);
+            });
+        }
+        /**
+         * @brief Find right rows matching key
+         * @param Key
+         * @param first Set to first matching row position
+         * @param last Set to one past last matching row position
+         * @return const int* Right rows of partition (valid between first and last)
+         */
+        const int* probe (const T& Key, unsigned &first, unsigned &last) const {
+            unsigned long long h = Hashing::hashOf(Key);
+            unsigned p = (unsigned) partitionOf(h, this->parts);
+            int id = this->Index[p].find(Key, h);
+            if (id < 0) {
+                first = last = 0;
+                return NULL;
+            }
+            first = this->runStart[p][id];
+            last = this->runStart[p][id + 1];
+            return this->rows[p].data();
+        }
+};
+// Append pairs of one left row to the result. R maps run positions first..last to right rows (NULL = identity)
+inline void joinEmit (JoinResult &Out, int l, const int* R, unsigned first, unsigned last, JoinType How) {
+    bool matched = first < last;
+    if (How == SEMI_JOIN) { if (matched) Out.left.append(l); }
+    else if (How == ANTI_JOIN) { if (!matched) Out.left.append(l); }
+    else if (!matched) {
+        if (How == LEFT_JOIN) {
+            Out.left.append(l);
+            Out.right.append(-1);
+        }
+    }
+    else {
+        for (unsigned k = first; k < last; k++) {
+            Out.left.append(l);
+            Out.right.append(R ? R[k] : (int) k);
+        }
+    }
+}
+template <class T>
+JoinResult hashJoin (const Array<T> &Left, const Array<T> &Right, JoinType How, unsigned Parts) {
+    JoinBuild<T> Build(Right, Parts);
+    unsigned n = Left.size();
+    const T* L = Left.data();
+    // Probing is read-only, so left chunks run in parallel and are concatenated in order
+    unsigned chunkCount = Parts > 1 ? Parallel::chunks(n, 1u << 16) : 1;
+    vector<JoinResult> partial(chunkCount);
+    Parallel::forChunks(n, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+        JoinResult &Out = partial[c];
+        Out.left.reserve((unsigned) (e - b));
+        if (How == INNER_JOIN || How == LEFT_JOIN) Out.right.reserve((unsigned) (e - b));
+        for (unsigned long long i = b; i < e; i++) {
+            unsigned first, last;
+            const int* R = Build.probe(L[i], first, last);
+            joinEmit(Out, (int) i, R, first, last, How);
+        }
+    });
+    for (unsigned c = 1; c < chunkCount; c++) {
+        partial[0].left.append(partial[c].left);
+        partial[0].right.append(partial[c].right);
+    }
+    return partial[0];
+}
+// Keys support operator<, so sorted inputs can be merge joined
+template <class T, class = void>
+struct isJoinOrdered : false_type {};
+template <class T>
+struct isJoinOrdered<T, decltype((void) (declval<const T&>() < declval<const T&>()))> : true_type {};
+template <class T>
+JoinResult mergeJoin (const Array<T> &Left, const Array<T> &Right, JoinType How) {
+    unsigned n = Left.size(), m = Right.size();
+    const T* L = Left.data();
+    const T* R = Right.data();
+    JoinResult Out;
+    Out.left.reserve(n);
+    unsigned j = 0;
+    for (unsigned i = 0; i < n; i++) {
+        while (j < m && R[j] < L[i]) j++;
+        unsigned last = j;
+        while (last < m && !(L[i] < R[last])) last++;
+        joinEmit(Out, (int) i, NULL, j, last, How);
+    }
+    return Out;
+}
+/**
+ * @brief Match equal keys between two Arrays
+ * @param Left Left keys
+ * @param Right Right keys
+ * @param How INNER_JOIN, LEFT_JOIN, SEMI_JOIN or ANTI_JOIN. Default INNER_JOIN
+ * @param Method Join algorithm. JOIN_MERGE needs keys with operator< sorted ascending on both sides. Default JOIN_AUTO
+ * @return JoinResult Index pairs
+ */
+template <class T>
+JoinResult joinIndices (const Array<T> &Left, const Array<T> &Right, JoinType How = INNER_JOIN, JoinMethod Method = JOIN_AUTO) {
+    BA_PROFILE_SCOPE("joinIndices");
+    if constexpr (is_same<T, bool>::value) {
+        // Array<bool> has no contiguous storage, keys are joined as bytes
+        Array<unsigned char> L(Left.size()), R(Right.size());
+        for (unsigned i = 0; i < Left.size(); i++) L[(int) i] = Left[(int) i];
+        for (unsigned j = 0; j < Right.size(); j++) R[(int) j] = Right[(int) j];
+        return joinIndices(L, R, How, Method);
+    }
+    else {
+        // Merge join is compiled only for keys with operator<, hash-only keys reach the hash join
+        if constexpr (isJoinOrdered<T>::value) {
+            if (Method == JOIN_MERGE) {
+                if (!Left.isSorted()) throw std::invalid_argument("Merge join requires sorted left keys!");
+                if (!Right.isSorted()) throw std::invalid_argument("Merge join requires sorted right keys!");
+                return mergeJoin(Left, Right, How);
+            }
+            // Sortedness check stops at the first descent, so unsorted inputs pay only a few comparisons
+            if (Method == JOIN_AUTO && Left.isSorted() && Right.isSorted()) return mergeJoin(Left, Right, How);
+        }
+        else if (Method == JOIN_MERGE) throw std::invalid_argument("Merge join requires ordered keys!");
+        static const unsigned long long PartitionedMin = 1ull << 20;
+        if (Method == JOIN_AUTO) Method = (unsigned long long) Left.size() + Right.size() >= PartitionedMin && Parallel::threads() > 1 ? JOIN_PARTITIONED : JOIN_HASH;
+        return hashJoin(Left, Right, How, Method == JOIN_PARTITIONED ? Parallel::threads() : 1);
+    }
+}
+#endif // !JOIN_H
@@ -0,0 +1,511 @@
+/**
+ * @file mapped_ndarray.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Memory-mapped NDArrays for Better Array. Binary NDArray files are mapped instead of loaded.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17. Files are stored in native (little-endian) byte order.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef MAPPED_NDARRAY_H
+#define MAPPED_NDARRAY_H
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include "better_array.h"
+#include "ndarray.h"
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define BA_MMAP
+#endif
+using namespace std;
+// Access to mapped file
+enum MappedMode {
+    MAPPED_READ = 0,            // Shared read-only mapping, pages are shared by every process mapping the file
+    MAPPED_COPY_ON_WRITE = 1    // Private writable mapping, written pages are copied and never reach the file
+};
+/**
+ * File layout:
+ *   char[4] magic "BAND", uint8 kind (0 = unsigned, 1 = signed, 2 = floating point), uint8 element size,
+ *   uint16 reserved, uint32 dimension count, uint64 element count, uint32 size of every dimension,
+ *   zero padding up to Memory::Alignment, row-major element data.
+ */
+namespace Mapping {
+    const char Magic[4] = {'B', 'A', 'N', 'D'};
+    template <class T>
+    constexpr uint8_t kindOf () {return is_floating_point<T>::value ? 2 : (is_signed<T>::value ? 1 : 0);}
+    // Byte offset of element data for given dimension count
+    inline uint64_t dataStart (uint32_t dims) {
+        uint64_t header = 4 + 1 + 1 + 2 + 4 + 8 + 4ull * dims;
+        return (header + Memory::Alignment - 1) / Memory::Alignment * Memory::Alignment;
+    }
+    /**
+     * @brief Mapped (or, without mmap, loaded) file contents. Unmapped when the last MappedNDArray using it is gone
+     */
+    class Region {
+        private:
+            unsigned char* base;
+            size_t length;
+            bool mapped;
+        public:
+            Region (const string &FileName, MappedMode Mode) : base(NULL), length(0), mapped(false) {
+                #ifdef BA_MMAP
+                    int fd = open(FileName.c_str(), O_RDONLY);
+                    if (fd < 0) throw std::invalid_argument("Cannot open file for reading!");
+                    struct stat st;
+                    if (fstat(fd, &st) != 0) {
+                        close(fd);
+                        throw std::invalid_argument("Cannot open file for reading!");
+                    }
+                    this->length = (size_t) st.st_size;
+                    if (this->length > 0) {
+                        int prot = Mode == MAPPED_COPY_ON_WRITE ? PROT_READ | PROT_WRITE : PROT_READ;
+                        void* p = mmap(NULL, this->length, prot, Mode == MAPPED_COPY_ON_WRITE ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+                        if (p == MAP_FAILED) {
+                            close(fd);
+                            throw std::invalid_argument("Cannot map file!");
+                        }
+                        this->base = (unsigned char*) p;
+                        this->mapped = true;
+                    }
+                    // Mapping keeps its own reference to the file
+                    close(fd);
+                #else
+                    (void) Mode;
+                    ifstream f(FileName, ios::in | ios::binary | ios::ate);
+                    if (!f) throw std::invalid_argument("Cannot open file for reading!");
+                    this->length = (size_t) f.tellg();
+                    this->base = Memory::AlignedAllocator<unsigned char>().allocate(this->length > 0 ? this->length : 1);
+                    f.seekg(0);
+                    f.read((char*) this->base, this->length);
+                #endif // BA_MMAP
+            }
+            Region (const Region&) = delete;
+            Region& operator= (const Region&) = delete;
+            ~Region () {
+                #ifdef BA_MMAP
+                    if (this->mapped) munmap(this->base, this->length);
+                #else
+                    Memory::AlignedAllocator<unsigned char>().deallocate(this->base, this->length > 0 ? this->length : 1);
+                #endif // BA_MMAP
+            }
+            unsigned char* data () const {return this->base;}
+            size_t size () const {return this->length;}
+            /**
+             * @brief Hint kernel about upcoming access to bytes [offset, offset + bytes)
+             * @param sequential true = read ahead aggressively, false = load the range now (asynchronously)
+             */
+            void advise (size_t offset, size_t bytes, bool sequential) const {
+                #if defined(BA_MMAP) && defined(__linux__)
+                    if (!this->mapped || bytes == 0) return;
+                    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+                    size_t from = offset / page * page;
+                    madvise(this->base + from, offset + bytes - from, sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+                #else
+                    (void) offset;
+                    (void) bytes;
+                    (void) sequential;
+                #endif
+            }
+    };
+}
+/**
+ * @brief NDArray view of a binary file mapped into memory
+ *
+ * Opening only maps the file and reads its header, pages are loaded when first touched. Read-only mappings
+ * share page cache between processes. slice(), flatten() and reductions read the mapping directly, copies of
+ * MappedNDArray share the same mapping.
+ * @tparam T Arithmetic type
+ */
+template <class T>
+class MappedNDArray {
+    static_assert(is_arithmetic<T>::value && !is_same<T, bool>::value, "MappedNDArray needs arithmetic values!");
+    private:
+        unsigned dims;
+        Array < unsigned > dimSizes;
+        unsigned long long count;
+        MappedMode mode;
+        shared_ptr < Mapping::Region > R;
+        T* N;
+        void AxisError (unsigned axis) const {
+            if (axis >= this->dims) throw std::invalid_argument("Axis does not exist!");
+        }
+        void WriteError () const {
+            if (this->mode != MAPPED_COPY_ON_WRITE) throw std::invalid_argument("Mapping is read-only!");
+        }
+        unsigned long long Idx (const Array<int> &NDIndex) const {
+            if (NDIndex.size() != this->dims) throw std::invalid_argument("Index must have same amount of dimesions as NDArray it refers to!");
+            unsigned long long trueIndex = 0;
+            for (unsigned i = 0; i < this->dims; i++) {
+                int index = NDIndex[i];
+                if (index < 0) index += (int) this->dimSizes[i];
+                if (index < 0 || index >= (int) this->dimSizes[i]) throw std::invalid_argument("NDArray Index out of range!");
+                trueIndex = trueIndex * this->dimSizes[i] + index;
+            }
+            return trueIndex;
+        }
+        unsigned DimIdx (int Index, unsigned axis) const {
+            if (Index < 0) Index += (int) this->dimSizes[axis];
+            if (Index < 0 || Index >= (int) this->dimSizes[axis]) throw std::invalid_argument("Dimension Index out of range!");
+            return Index;
+        }
+        void split (unsigned axis, unsigned long long &outer, unsigned long long &inner) const {
+            outer = 1;
+            inner = 1;
+            for (unsigned i = 0; i < axis; i++) outer *= this->dimSizes[i];
+            for (unsigned i = axis + 1; i < this->dims; i++) inner *= this->dimSizes[i];
+        }
+        NDArray<T> DenseOf (const Array<unsigned> &Shape, unsigned long long n) const {
+            if (n > 0xFFFFFFFFull) throw std::invalid_argument("Result is too large for NDArray!");
+            return NDArray<T>((unsigned) Shape.size(), Shape);
+        }
+        // Reduce along axis into NDArray with shape(axis) = 1. Every output cell starts with first value of its line
+        template <class R, class F>
+        NDArray<R> reduceAxis (unsigned axis, F f) const {
+            AxisError(axis);
+            if (this->dimSizes[axis] == 0) throw std::invalid_argument("Empty NDArray!");
+            unsigned long long outer, inner, len = this->dimSizes[axis];
+            split(axis, outer, inner);
+            Array<unsigned> newShape = this->dimSizes;
+            newShape[axis] = 1;
+            NDArray<R> X((unsigned) this->dims, newShape);
+            R* out = X.N.data();
+            const T* src = this->N;
+            // Lines along axis are strided by inner, so rows of inner values are streamed in file order
+            auto run = [&] (unsigned long long o, unsigned long long j0, unsigned long long j1) {
+                R* dst = out + o * inner;
+                const T* first = src + o * len * inner;
+                for (unsigned long long j = j0; j < j1; j++) dst[j] = (R) first[j];
+                for (unsigned long long k = 1; k < len; k++) {
+                    const T* row = first + k * inner;
+                    for (unsigned long long j = j0; j < j1; j++) dst[j] = f(dst[j], row[j]);
+                }
+            };
+            if (outer >= inner) {
+                Parallel::forChunks(outer, Parallel::chunks(outer * len * inner, 1u << 16) > 1 ? Parallel::chunks(outer, 1) : 1, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                    for (unsigned long long o = b; o < e; o++) run(o, 0, inner);
+                });
+            }
+            else {
+                Parallel::forChunks(inner, Parallel::chunks(outer * len * inner, 1u << 16) > 1 ? Parallel::chunks(inner, 1024) : 1, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                    for (unsigned long long o = 0; o < outer; o++) run(o, b, e);
+                });
+            }
+            return X;
+        }
+        // Combine per-chunk results of f(begin, end) over all elements
+        template <class R, class F, class C>
+        R reduceAll (F f, C combine) const {
+            unsigned chunkCount = Parallel::chunks(this->count, 1u << 16);
+            vector<R> partial(chunkCount);
+            Parallel::forChunks(this->count, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {partial[c] = f(b, e);});
+            R r = partial[0];
+            for (unsigned c = 1; c < chunkCount; c++) r = combine(r, partial[c]);
+            return r;
+        }
+    public:
+        // CONSTRUCTORS
+        /**
+         * @brief Map NDArray file written by Files::saveMapped(). Only the header is read
+         * @param FileName File Name
+         * @param Mode MAPPED_READ or MAPPED_COPY_ON_WRITE. Default MAPPED_READ
+         */
+        explicit MappedNDArray (const string &FileName, MappedMode Mode = MAPPED_READ) : count(0), mode(Mode) {
+            BA_PROFILE_SCOPE("MappedNDArray::open");
+            this->R = make_shared<Mapping::Region>(FileName, Mode);
+            const unsigned char* p = this->R->data();
+            size_t length = this->R->size();
+            uint8_t kind, elemSize;
+            uint32_t d;
+            if (length < Mapping::dataStart(0) || memcmp(p, Mapping::Magic, 4) != 0) throw std::invalid_argument("File is not a mapped NDArray file!");
+            memcpy(&kind, p + 4, 1);
+            memcpy(&elemSize, p + 5, 1);
+            memcpy(&d, p + 8, 4);
+            memcpy(&this->count, p + 12, 8);
+            if (kind != Mapping::kindOf<T>() || elemSize != sizeof(T)) throw std::invalid_argument("Mapped NDArray file type does not match NDArray type!");
+            uint64_t start = Mapping::dataStart(d);
+            if (d == 0 || length < start) throw std::invalid_argument("Corrupted mapped NDArray file!");
+            this->dims = d;
+            unsigned long long n = 1;
+            for (uint32_t i = 0; i < d; i++) {
+                uint32_t s;
+                memcpy(&s, p + 20 + 4ull * i, 4);
+                this->dimSizes.append(s);
+                if (__builtin_mul_overflow(n, (unsigned long long) s, &n)) throw std::invalid_argument("Corrupted mapped NDArray file!");
+            }
+            // Sizes come from the file, so the data length is checked by division instead of multiplying count
+            if (n != this->count || this->count > (length - start) / sizeof(T)) throw std::invalid_argument("Corrupted mapped NDArray file!");
+            this->N = (T*) (this->R->data() + start);
+        }
+        // FUNCTIONS
+        /**
+         * @brief Write NDArray in the layout MappedNDArray maps
+         * @param NDArr NDArray
+         * @param FileName File Name
+         */
+        static void save (const NDArray<T> &NDArr, const string &FileName) {
+            BA_PROFILE_SCOPE("MappedNDArray::save");
+            ofstream f(FileName, ios::out | ios::binary);
+            if (!f) throw std::invalid_argument("Cannot open file for writing!");
+            uint8_t kind = Mapping::kindOf<T>(), elemSize = sizeof(T);
+            uint16_t reserved = 0;
+            uint32_t d = NDArr.dims;
+            uint64_t n = NDArr.N.size();
+            f.write(Mapping::Magic, 4);
+            f.write((const char*) &kind, 1);
+            f.write((const char*) &elemSize, 1);
+            f.write((const char*) &reserved, 2);
+            f.write((const char*) &d, 4);
+            f.write((const char*) &n, 8);
+            for (uint32_t i = 0; i < d; i++) {
+                uint32_t s = NDArr.dimSizes[i];
+                f.write((const char*) &s, 4);
+            }
+            char pad[Memory::Alignment] = {};
+            f.write(pad, Mapping::dataStart(d) - (20 + 4ull * d));
+            f.write((const char*) NDArr.N.data(), n * sizeof(T));
+            if (!f) throw std::invalid_argument("Cannot write mapped NDArray file!");
+            f.close();
+        }
+        /**
+         * @brief Get number of dimensions
+         * @return unsigned
+         */
+        unsigned dimension () const {return this->dims;}
+        /**
+         * @brief Get shape
+         * @return Array<unsigned> Dimensions shape (length)
+         */
+        Array<unsigned> shape () const {return this->dimSizes;}
+        /**
+         * @brief Get shape of one dimension
+         * @param dim Dimension Index
+         * @return unsigned Dimension shape (length)
+         */
+        unsigned shape (unsigned dim) const {
+            AxisError(dim);
+            return this->dimSizes[dim];
+        }
+        /**
+         * @brief Get element count
+         * @return unsigned long long
+         */
+        unsigned long long fullSize () const {return this->count;}
+        /**
+         * @brief Get access mode of the mapping
+         * @return MappedMode
+         */
+        MappedMode accessMode () const {return this->mode;}
+        /**
+         * @brief Get mapped values in row-major order
+         * @return const T*
+         */
+        const T* data () const {return this->N;}
+        /**
+         * @brief Get writable mapped values (copy-on-write mappings only)
+         * @return T*
+         */
+        T* writableData () {
+            WriteError();
+            return this->N;
+        }
+        /**
+         * @brief Get value
+         * @param NDIndex Index of every dimension (negative counts from the end)
+         * @return T
+         */
+        T at (const Array<int> &NDIndex) const {return this->N[Idx(NDIndex)];}
+        T at (initializer_list<int> NDIndex) const {return at(Array<int>(NDIndex));}
+        /**
+         * @brief Set value of private copy of the page (copy-on-write mappings only)
+         * @param NDIndex Index of every dimension (negative counts from the end)
+         * @param Value New value
+         */
+        void set (const Array<int> &NDIndex, const T& Value) {
+            WriteError();
+            this->N[Idx(NDIndex)] = Value;
+        }
+        void set (initializer_list<int> NDIndex, const T& Value) {set(Array<int>(NDIndex), Value);}
+        /**
+         * @brief Ask the kernel to page in whole file ahead of use (optional, pages are loaded lazily anyway)
+         * @param sequential true = aggressive read-ahead for one pass, false = start loading everything now. Default false
+         */
+        void prefetch (bool sequential = false) const {this->R->advise((size_t) ((const unsigned char*) this->N - this->R->data()), this->count * sizeof(T), sequential);}
+        /**
+         * @brief Copy mapped values to NDArray
+         * @return NDArray<T>
+         */
+        NDArray<T> toNDArray () const {
+            BA_PROFILE_SCOPE("MappedNDArray::toNDArray");
+            NDArray<T> X = DenseOf(this->dimSizes, this->count);
+            if (this->count > 0) memcpy(X.N.data(), this->N, this->count * sizeof(T));
+            return X;
+        }
+        /**
+         * @brief Get flat row-major values [From, To]. Only pages of the range are touched
+         * @param From Starting Index (Inclusive, negative index supported). Default 0
+         * @param To End Index (Inclusive, negative index supported). Default last element
+         * @return Array<T>
+         */
+        Array<T> flatten (long long From = 0, long long To = -1) const {
+            BA_PROFILE_SCOPE("MappedNDArray::flatten");
+            long long n = (long long) this->count;
+            if (n == 0) return Array<T>();
+            long long from = From < 0 ? From + n : From, to = To < 0 ? To + n : To;
+            if (from < 0 || from >= n || to < 0 || to >= n || from > to) throw std::invalid_argument("Invalid From-To Range");
+            if (to - from + 1 > 0xFFFFFFFFll) throw std::invalid_argument("Result is too large for Array!");
+            Array<T> X((unsigned) (to - from + 1));
+            memcpy(X.data(), this->N + from, (size_t) (to - from + 1) * sizeof(T));
+            return X;
+        }
+        /**
+         * @brief Get NDArray slice through axis. Only pages of the slice are touched
+         * @param From Starting Axis Index (Inclusive). Default to 0
+         * @param To End Axis Index (Inclusive). Default to Array End
+         * @param axis Slice Dimension (default = 0)
+         * @return NDArray<T> NDArray Slice
+         */
+        NDArray<T> slice (int From = ArrayBegin, int To = ArrayEnd, unsigned axis = 0) const {
+            BA_PROFILE_SCOPE("MappedNDArray::slice");
+            AxisError(axis);
+            if (To == ArrayEnd && (int) this->dimSizes[axis] < ArrayEnd) To = this->dimSizes[axis] - 1;
+            unsigned from = DimIdx(From, axis), to = DimIdx(To, axis);
+            if (from > to) throw std::invalid_argument("Invalid index range!");
+            unsigned long long outer, inner, len = this->dimSizes[axis], width = to - from + 1;
+            split(axis, outer, inner);
+            Array<unsigned> sliceShape = this->dimSizes;
+            sliceShape[axis] = (unsigned) width;
+            NDArray<T> X = DenseOf(sliceShape, outer * width * inner);
+            T* dst = X.N.data();
+            // Slice of every outer block is one contiguous run of the file
+            for (unsigned long long o = 0; o < outer; o++) memcpy(dst + o * width * inner, this->N + (o * len + from) * inner, width * inner * sizeof(T));
+            return X;
+        }
+        /**
+         * @brief Get sum of all values
+         * @return T
+         */
+        T sum () const {
+            BA_PROFILE_SCOPE("MappedNDArray::sum");
+            if (this->count == 0) return T();
+            const T* src = this->N;
+            return reduceAll<T>([src] (unsigned long long b, unsigned long long e) {
+                T acc = T();
+                for (unsigned long long i = b; i < e; i++) acc += src[i];
+                return acc;
+            }, [] (T x, T y) {return x + y;});
+        }
+        /**
+         * @brief Get average of all values
+         * @return double
+         */
+        double mean () const {
+            BA_PROFILE_SCOPE("MappedNDArray::mean");
+            if (this->count == 0) throw std::invalid_argument("Empty NDArray!");
+            const T* src = this->N;
+            return reduceAll<double>([src] (unsigned long long b, unsigned long long e) {
+                if constexpr (Simd::isKernelType<T>::value) return Simd::sum(src + b, e - b);
+                double acc = 0.0;
+                for (unsigned long long i = b; i < e; i++) acc += (double) src[i];
+                return acc;
+            }, [] (double x, double y) {return x + y;}) / (double) this->count;
+        }
+        /**
+         * @brief Get maximum value
+         * @return T
+         */
+        T max () const {
+            BA_PROFILE_SCOPE("MappedNDArray::max");
+            if (this->count == 0) throw std::invalid_argument("Empty NDArray!");
+            const T* src = this->N;
+            return reduceAll<T>([src] (unsigned long long b, unsigned long long e) {
+                if constexpr (Simd::isKernelType<T>::value) return Simd::extreme<true>(src + b, e - b);
+                T M = src[b];
+                for (unsigned long long i = b + 1; i < e; i++) if (src[i] > M) M = src[i];
+                return M;
+            }, [] (T x, T y) {return y > x ? y : x;});
+        }
+        /**
+         * @brief Get minimum value
+         * @return T
+         */
+        T min () const {
+            BA_PROFILE_SCOPE("MappedNDArray::min");
+            if (this->count == 0) throw std::invalid_argument("Empty NDArray!");
+            const T* src = this->N;
+            return reduceAll<T>([src] (unsigned long long b, unsigned long long e) {
+                if constexpr (Simd::isKernelType<T>::value) return Simd::extreme<false>(src + b, e - b);
+                T M = src[b];
+                for (unsigned long long i = b + 1; i < e; i++) if (src[i] < M) M = src[i];
+                return M;
+            }, [] (T x, T y) {return y < x ? y : x;});
+        }
+        /**
+         * @brief Get sum along axis
+         * @param axis Reduced Dimension
+         * @return NDArray<T> NDArray with shape(axis) = 1
+         */
+        NDArray<T> sum (unsigned axis) const {
+            BA_PROFILE_SCOPE("MappedNDArray::sum");
+            return reduceAxis<T>(axis, [] (T acc, T v) {return acc + v;});
+        }
+        /**
+         * @brief Get average along axis
+         * @param axis Reduced Dimension
+         * @return NDArray<double> NDArray with shape(axis) = 1
+         */
+        NDArray<double> mean (unsigned axis) const {
+            BA_PROFILE_SCOPE("MappedNDArray::mean");
+            NDArray<double> X = reduceAxis<double>(axis, [] (double acc, T v) {return acc + (double) v;});
+            double len = (double) this->dimSizes[axis];
+            double* out = X.N.data();
+            for (unsigned k = 0; k < X.fullSize(); k++) out[k] /= len;
+            return X;
+        }
+        /**
+         * @brief Get maximum along axis
+         * @param axis Reduced Dimension
+         * @return NDArray<T> NDArray with shape(axis) = 1
+         */
+        NDArray<T> max (unsigned axis) const {
+            BA_PROFILE_SCOPE("MappedNDArray::max");
+            return reduceAxis<T>(axis, [] (T acc, T v) {return v > acc ? v : acc;});
+        }
+        /**
+         * @brief Get minimum along axis
+         * @param axis Reduced Dimension
+         * @return NDArray<T> NDArray with shape(axis) = 1
+         */
+        NDArray<T> min (unsigned axis) const {
+            BA_PROFILE_SCOPE("MappedNDArray::min");
+            return reduceAxis<T>(axis, [] (T acc, T v) {return v < acc ? v : acc;});
+        }
+};
+namespace Files {
+    /**
+     * @brief Save NDArray to a binary file that MappedNDArray (or Files::mapNDArray()) maps without loading
+     * @tparam T Arithmetic type
+     * @param NDArr NDArray
+     * @param FileName File Name
+     */
+    template <class T>
+    void saveMapped (const NDArray<T> &NDArr, const string &FileName) {MappedNDArray<T>::save(NDArr, FileName);}
+    /**
+     * @brief Map NDArray file saved by saveMapped(). O(1): pages are loaded on first access
+     * @tparam T NDArray Type
+     * @param FileName File Name
+     * @param Mode MAPPED_READ or MAPPED_COPY_ON_WRITE. Default MAPPED_READ
+     * @return MappedNDArray<T>
+     */
+    template <class T>
+    MappedNDArray<T> mapNDArray (const string &FileName, MappedMode Mode = MAPPED_READ) {return MappedNDArray<T>(FileName, Mode);}
+}
+#endif // !MAPPED_NDARRAY_H
@@ -21,6 +21,8 @@ using namespace std;
 #ifdef COLORED_TEXT_H
     const char dimColors[12] = {'c', 'a', 'b', 'd', 'e', '9', '5', '6', '1', '4', '3', '2'};
 #endif // COLORED_TEXT_H
+template <class T> class SparseNDArray;
+template <class T> class MappedNDArray;
 // Main N-Dimensional Array Class
 template <class T>
 class NDArray {
@@ -28,17 +30,54 @@ class NDArray {
         unsigned dims;
         Array < unsigned > dimSizes;
         Array < T > N;
-        unsigned Idx (Array<int> NDIndex) const {
-            if (NDIndex.size() != dims) throw std::invalid_argument("Index must have same amount of dimesions as NDArray it refers to!");
-            for (unsigned i = 0; i < dims; i++) {
-                if (NDIndex[i] < 0) NDIndex[i] += (int) dimSizes[i];
-                if (NDIndex[i] >= (int) dimSizes[i]) throw std::invalid_argument("NDArray Index out of range!");
+        template <class U> friend class NDArray;
+        template <class U> friend class SparseNDArray;
+        template <class U> friend class MappedNDArray;
+        // Apply Array operation to every line along axis. All results must have equal length
+        template <class R, class F>
+        NDArray<R> alongAxis (unsigned axis, F f) const {
+            AxisError(axis);
+            unsigned outer = 1, inner = 1, len = this->dimSizes[axis];
+            for (unsigned i = 0; i < axis; i++) outer *= this->dimSizes[i];
+            for (unsigned i = axis + 1; i < this->dims; i++) inner *= this->dimSizes[i];
+            Array<T> Line(len);
+            T* line = Line.data();
+            const T* src = this->N.data();
+            NDArray<R> X;
+            R* dst = NULL;
+            unsigned outLen = 0;
+            for (unsigned o = 0; o < outer; o++) {
+                for (unsigned in = 0; in < inner; in++) {
+                    for (unsigned k = 0; k < len; k++) line[k] = src[(o * len + k) * inner + in];
+                    Array<R> Res = f(Line);
+                    if (dst == NULL) {
+                        outLen = Res.size();
+                        Array<unsigned> newShape = this->dimSizes;
+                        newShape[axis] = outLen;
+                        X = NDArray<R>(this->dims, newShape);
+                        dst = X.N.data();
+                    }
+                    const R* res = Res.data();
+                    for (unsigned k = 0; k < outLen; k++) dst[(o * outLen + k) * inner + in] = res[k];
+                }
             }
-            unsigned trueIndex = 0;
-            for (unsigned i = 0; i < dims; i++) {
-                unsigned mul = 1;
-                for (unsigned j = i + 1; j < dims; j++) mul *= dimSizes[j];
-                trueIndex += NDIndex[i] * mul;
+            if (dst == NULL) {
+                Array<unsigned> newShape = this->dimSizes;
+                newShape[axis] = f(Line).size();
+                X = NDArray<R>(this->dims, newShape);
+            }
+            return X;
+        }
+        unsigned Idx (const Array<int> &NDIndex) const {
+            BA_COUNT_INDEX();
+            if (NDIndex.size() != dims) throw std::invalid_argument("Index must have same amount of dimesions as NDArray it refers to!");
+            unsigned trueIndex = 0, mul = 1;
+            for (int i = (int) dims - 1; i >= 0; i--) {
+                int index = NDIndex[i];
+                if (index < 0) index += (int) dimSizes[i];
+                if (index < 0 || index >= (int) dimSizes[i]) throw std::invalid_argument("NDArray Index out of range!");
+                trueIndex += index * mul;
+                mul *= dimSizes[i];
             }
             return trueIndex;
         }
@@ -47,10 +86,10 @@ class NDArray {
             if (Index >= (int) dimSizes[axis]) throw std::invalid_argument("Dimension Index out of range!");
             return Index;
         }
-        void AxisError (unsigned axis) {
+        void AxisError (unsigned axis) const {
             if (axis >= this->dims) throw std::invalid_argument("Axis does not exist!");
         }
-        void InsertionError (NDArray<T> NDArr, unsigned axis) {
+        void InsertionError (const NDArray<T> &NDArr, unsigned axis) const {
             if (NDArr.dimension() < this->dims - 1) throw std::invalid_argument("Not enough dimensions to insert!");
             if (NDArr.dimension() > this->dims) throw std::invalid_argument("Too many dimensions to insert!");
             if (NDArr.dimension() == this->dims) {
@@ -66,25 +105,25 @@ class NDArray {
                 }
             }
         }
-        void InsertAt (unsigned dimIdx, NDArray<T> NDArr, unsigned axis) {
-            Array<T> F = NDArr.flatten();
-            unsigned sP = 1;
-            for (unsigned i = axis; i < dims; i++) sP *= this->dimSizes[i];
-            unsigned skip = sP;
-            if (axis == 0) skip = 0;
-            unsigned startPoint = dimIdx * (sP / this->dimSizes[axis]);
-            unsigned skipEvery = 1;
-            for (unsigned i = axis + 1; i < dims; i++) skipEvery *= this->dimSizes[i];
-            if (NDArr.dimension() == this->dims) skipEvery *= NDArr.shape(axis);
-            if (axis == 0) skipEvery = 0;
-            unsigned insertionIndex = startPoint;
-            for (unsigned i = 0; i < F.size(); i++) {
-                if (skipEvery > 0) {
-                    if (i > 0 && i % skipEvery == 0) insertionIndex += skip;
-                }
-                this->N.insert(insertionIndex, F[i]);
-                insertionIndex++;
+        void InsertAt (unsigned dimIdx, const NDArray<T> &NDArr, unsigned axis) {
+            const Array<T> &F = NDArr.N;
+            unsigned outer = 1, inner = 1;
+            for (unsigned i = 0; i < axis; i++) outer *= this->dimSizes[i];
+            for (unsigned i = axis + 1; i < dims; i++) inner *= this->dimSizes[i];
+            unsigned block = this->dimSizes[axis] * inner, at = dimIdx * inner;
+            unsigned chunk = outer > 0 ? F.size() / outer : 0;
+            // Rebuild storage in one pass: every outer block gets its chunk of F inserted at dimIdx
+            Array<T> M;
+            M.reserve(this->N.size() + F.size());
+            const Array<T> &Src = this->N;
+            const T* src = Src.data();
+            const T* ins = F.data();
+            for (unsigned o = 0; o < outer; o++) {
+                for (unsigned k = 0; k < at; k++) M.pushBackUnchecked(src[o * block + k]);
+                for (unsigned k = 0; k < chunk; k++) M.pushBackUnchecked(ins[o * chunk + k]);
+                for (unsigned k = at; k < block; k++) M.pushBackUnchecked(src[o * block + k]);
             }
+            this->N = M;
             if (NDArr.dimension() == this->dims) this->dimSizes[axis] += NDArr.shape(axis);
             else this->dimSizes[axis]++;
         }
@@ -92,18 +131,89 @@ class NDArray {
             unsigned trueFrom = DimIdx(From, dim), trueTo = DimIdx(To, dim);
             if (trueFrom > trueTo) throw std::invalid_argument("Invalid index range!");
         }
-        void dimCout (unsigned dim, const string &what) {
+        // Append bracket or comma of given dimension color (colored only with colored_text.h)
+        static void mark (string &out, unsigned color, char what, bool colored) {
             #ifdef COLORED_TEXT_H
-                string tf = "";
-                tf += (char) ct::Executor;
-                tf += (char) dimColors[dim % 12];
-                tf += what;
-                tf += (char) ct::Executor;
-                tf += 'f';
-                ctext::text(tf);
-            #else
-                cout<<what;
+                if (colored) {
+                    out += (char) ct::Executor;
+                    out += (char) dimColors[color % 12];
+                    out += what;
+                    out += (char) ct::Executor;
+                    out += 'f';
+                    return;
+                }
             #endif // COLORED_TEXT_H
+            (void) color;
+            (void) colored;
+            out += what;
+        }
+        // Format whole NDArray. Bracket boundaries follow from strides: after flat element i,
+        // t dimensions close where t is the count of innermost strides dividing i + 1
+        void formatFlat (string &out, bool colored) const {
+            const unsigned n = this->N.size();
+            Array<unsigned> cum(this->dims);
+            unsigned c = 1;
+            for (unsigned t = 0; t < this->dims; t++) {
+                c *= this->dimSizes[this->dims - 1 - t];
+                cum[t] = c;
+            }
+            const unsigned* Cum = cum.data();
+            const unsigned D = this->dims;
+            const Array<T> &Src = this->N;
+            for (unsigned j = D; j > 0; j--) mark(out, j - 1, '[', colored);
+            unsigned chunkCount = Parallel::chunks(n, 1u << 16);
+            vector<string> parts(chunkCount);
+            Parallel::forChunks(n, chunkCount, [&] (unsigned ch, unsigned long long b, unsigned long long e) {
+                string &part = (ch == 0 ? out : parts[ch]);
+                part.reserve(part.size() + (e - b) * 8);
+                for (unsigned long long i = b; i < e; i++) {
+                    Formatter::append(part, Src[(int) i]);
+                    if (i + 1 == n) break;
+                    unsigned t = 0;
+                    while (t < D && (i + 1) % Cum[t] == 0) t++;
+                    for (unsigned j = 0; j < t; j++) mark(part, j, ']', colored);
+                    mark(part, t, ',', colored);
+                    for (unsigned j = t; j > 0; j--) mark(part, j - 1, '[', colored);
+                }
+            });
+            for (unsigned ch = 1; ch < chunkCount; ch++) out += parts[ch];
+            for (unsigned j = 0; j < D; j++) mark(out, j, ']', colored);
+        }
+        // Format one dimension with NumPy-style summarization (edge items around "...")
+        void formatSummary (string &out, unsigned dim, unsigned offset, unsigned edge, bool colored) const {
+            unsigned color = this->dims - 1 - dim, n = this->dimSizes[dim], stride = 1;
+            for (unsigned j = dim + 1; j < this->dims; j++) stride *= this->dimSizes[j];
+            auto item = [&] (unsigned k) {
+                if (dim == this->dims - 1) Formatter::append(out, this->N[(int) (offset + k)]);
+                else formatSummary(out, dim + 1, offset + k * stride, edge, colored);
+            };
+            mark(out, color, '[', colored);
+            // Same layout as Formatter::appendRange(), edge = 0 leaves only "..."
+            if (n > 2 * edge) {
+                for (unsigned k = 0; k < edge; k++) {
+                    item(k);
+                    mark(out, color, ',', colored);
+                }
+                out += "...";
+                for (unsigned k = n - edge; k < n; k++) {
+                    mark(out, color, ',', colored);
+                    item(k);
+                }
+            }
+            else {
+                for (unsigned k = 0; k < n; k++) {
+                    item(k);
+                    if (k + 1 < n) mark(out, color, ',', colored);
+                }
+            }
+            mark(out, color, ']', colored);
+        }
+        string formatAll (bool colored) const {
+            const Formatter::PrintOptions &P = Formatter::options();
+            string out;
+            if (P.threshold > 0 && this->N.size() > P.threshold) formatSummary(out, 0, 0, P.edgeItems, colored);
+            else formatFlat(out, colored);
+            return out;
         }
     public:
         // CONSTRUCTORS
@@ -136,52 +246,40 @@ class NDArray {
             }
             this->N = Array<T>(count);
         }
+        /**
+         * @brief Construct NDArray of given shape from row-major values
+         * @param Dimensions Dimension count
+         * @param Sizes Shape
+         * @param Values Flat values, size must equal product of Sizes
+         */
+        explicit NDArray (unsigned Dimensions, Array<unsigned> Sizes, const Array<T> &Values) {
+            if (Dimensions != Sizes.size()) throw std::invalid_argument("Sizes Array must be the same as dimension count!");
+            unsigned long long count = 1;
+            for (unsigned i = 0; i < Dimensions; i++) count *= Sizes[i];
+            if (count != Values.size()) throw std::invalid_argument("Values must fill the whole shape!");
+            this->dims = Dimensions;
+            this->dimSizes = Sizes;
+            this->N = Values;
+        }
         // Built-in functions
         /**
          * @brief Display NDArray
          */
-        void show () {
-            Array<unsigned> dim_counter(this->dims);
-            dim_counter.fill(0);
-            for (int j = this->dims - 1; j >= 0; j--) dimCout(j, "[");
-            for (unsigned i = 0; i < this->N.size(); i++) {
-                cout<<this->N[i];
-                for (int j = this->dims - 1; j >= 0; j--) {
-                    if (j == this->dims - 1) { if (dim_counter[j] == this->dimSizes[j] - 1) dimCout(this->dims - j - 1, "]"); }
-                    else {
-                        int changeCnt = 0;
-                        for (int k = j; k < this->dims; k++) if (dim_counter[k] == this->dimSizes[k] - 1) changeCnt++;
-                        if (changeCnt == this->dims - j) dimCout(this->dims - j - 1, "]");
-                    }
-                }
-                if (i < this->N.size() - 1) {
-                    for (int j = 0; j < this->dims; j++) {
-                        if (dim_counter[j] < this->dimSizes[j] - 1) {
-                            if (j == this->dims - 1) dimCout(this->dims - j - 1, ",");
-                            else {
-                                int changeCnt = 0;
-                                for (int k = j + 1; k < this->dims; k++) if (dim_counter[k] == this->dimSizes[k] - 1) changeCnt++;
-                                if (changeCnt == this->dims - j - 1) dimCout(this->dims - j - 1, ",");
-                            }
-                        }
-                    }
-                    for (int j = 1; j < this->dims; j++) {
-                        int changeCnt = 0;
-                        for (int k = j; k < this->dims; k++) if (dim_counter[k] == this->dimSizes[k] - 1) changeCnt++;
-                        if (changeCnt == this->dims - j) dimCout(this->dims - j - 1, "[");
-                    }
-                }
-                // Update counters
-                dim_counter[this->dims - 1]++;
-                for (int j = this->dims - 1; j >= 0; j--) {
-                    if (dim_counter[j] >= this->dimSizes[j]) {
-                        dim_counter[j] = 0;
-                        if (j > 0) dim_counter[j-1]++;
-                    }
-                }
-            }
+        void show () const {
+            BA_PROFILE_SCOPE("NDArray::show");
+            #ifdef COLORED_TEXT_H
+                ctext::text(formatAll(true));
+            #else
+                cout<<formatAll(false);
+            #endif // COLORED_TEXT_H
             cout<<endl;
         }
+        /**
+         * @brief Format NDArray the same way show() prints it (without colors and new line)
+         * @note Summarized with Formatter::setPrintOptions() threshold
+         * @return string
+         */
+        string format () const {return formatAll(false);}
         /**
          * @brief Get number of NDArray dimensions
          * @return unsigned - dimensions count
@@ -192,13 +290,13 @@ class NDArray {
          * @brief Get NDArray shape
          * @return Array<unsigned> - Dimensions shape (length)
          */
-        Array<unsigned> shape () {return this->dimSizes;}
+        Array<unsigned> shape () const {return dimSizes;}
         /**
          * @brief Get shape of one of NDArray dimensions
          * @param dim Dimension Index
          * @return unsigned - Dimension shape (length)
          */
-        unsigned shape (unsigned dim) {
+        unsigned shape (unsigned dim) const {
             AxisError(dim);
             return this->dimSizes[dim];
         }
@@ -206,23 +304,102 @@ class NDArray {
          * @brief Get full size of NDArray
          * @return unsigned - NDArray capacity
          */
-        unsigned fullSize () {return this->N.size();}
+        unsigned fullSize () const {return N.size();}
         /**
          * @brief Return 1D representation of NDArray
          * @return Array<T> 
          */
-        Array<T> flatten () {return this->N;}
+        Array<T> flatten () const {return N;}
         /**
          * @brief Fill NDArray with same value
          * @param value Fill value
          */
-        void fill (T value) { for (unsigned i = 0; i < this->N.size(); i++) this->N[i] = value; }
+        void fill (T value) {
+            BA_PROFILE_SCOPE("NDArray::fill");
+            T* D = this->N.data();
+            Parallel::forTiles(this->N.size(), Parallel::tileItems(sizeof(T)), [D, &value] (unsigned long long b, unsigned long long e) {
+                std::fill(D + b, D + e, value);
+            });
+        }
+        /**
+         * @brief Transform every element in place, tiles of the flat buffer run in parallel
+         * @tparam F Callable as f(const T&) -> T, called concurrently
+         * @param f Element function
+         */
+        template <class F>
+        void apply (F f) {
+            BA_PROFILE_SCOPE("NDArray::apply");
+            T* D = this->N.data();
+            Parallel::forTiles(this->N.size(), Parallel::tileItems(sizeof(T)), [D, &f] (unsigned long long b, unsigned long long e) {
+                for (unsigned long long i = b; i < e; i++) D[i] = f(D[i]);
+            });
+        }
+        /**
+         * @brief Get NDArray of the same shape with function applied to every element, tiles run in parallel
+         * @tparam F Callable as f(const T&) -> U, called concurrently
+         * @param f Element function
+         * @return NDArray<U> Mapped NDArray
+         */
+        template <class F>
+        auto map (F f) const -> NDArray<typename decay<decltype(f(declval<const T&>()))>::type> {
+            BA_PROFILE_SCOPE("NDArray::map");
+            typedef typename decay<decltype(f(declval<const T&>()))>::type U;
+            NDArray<U> X(this->dims, this->dimSizes);
+            if constexpr (is_same<T, bool>::value || is_same<U, bool>::value) {
+                // Array<bool> is bit packed with no contiguous storage, so elements are mapped one by one
+                Array<U> M;
+                M.reserve(this->N.size());
+                for (unsigned i = 0; i < this->N.size(); i++) M.pushBackUnchecked(f(this->N[(int) i]));
+                X.N = M;
+            }
+            else {
+                const T* src = this->N.data();
+                U* dst = X.N.data();
+                Parallel::forTiles(this->N.size(), Parallel::tileItems(sizeof(T) > sizeof(U) ? sizeof(T) : sizeof(U)), [src, dst, &f] (unsigned long long b, unsigned long long e) {
+                    for (unsigned long long i = b; i < e; i++) dst[i] = f(src[i]);
+                });
+            }
+            return X;
+        }
+        /**
+         * @brief Set every element from its coordinates, tiles run in parallel
+         *
+         * Coordinates are advanced like an odometer along the flat buffer, so no index is recomputed per element.
+         * @tparam F Callable as f(const Array<int>& Index) -> T, called concurrently
+         * @param f Generator function
+         */
+        template <class F>
+        void generate (F f) {
+            BA_PROFILE_SCOPE("NDArray::generate");
+            T* D = this->N.data();
+            const unsigned* sizes = this->dimSizes.data();
+            unsigned d = this->dims;
+            Parallel::forTiles(this->N.size(), Parallel::tileItems(sizeof(T)), [D, sizes, d, &f] (unsigned long long b, unsigned long long e) {
+                // Coordinates of the first element of the tile, then carried increments
+                Array<int> Index(d);
+                int* id = Index.data();
+                unsigned long long rest = b;
+                for (int k = (int) d - 1; k >= 0; k--) {
+                    id[k] = (int) (rest % sizes[k]);
+                    rest /= sizes[k];
+                }
+                const Array<int> &Coords = Index;
+                for (unsigned long long i = b; i < e; i++) {
+                    D[i] = f(Coords);
+                    for (int k = (int) d - 1; k >= 0; k--) {
+                        if (++id[k] < (int) sizes[k]) break;
+                        id[k] = 0;
+                    }
+                }
+            });
+        }
         /**
          * @brief Fill NDArray with value pattern
          * @param pattern Pattern Array
          * @param axis Pattern flow axis
          */
         void fill (const Array<T> &pattern, unsigned axis = 0) {
+            BA_PROFILE_SCOPE("NDArray::fill");
             AxisError(axis);
             if (pattern.size() == 0) throw std::invalid_argument("Pattern must be at least length: 1!");
             Array<unsigned> switched = this->dimSizes;
@@ -260,6 +437,7 @@ class NDArray {
          * @param count Expansion size
          */
         void expand (unsigned axis = 0, unsigned count = 1) {
+            BA_PROFILE_SCOPE("NDArray::expand");
             AxisError(axis);
             Array<unsigned> Sizes;
             for (unsigned i = 0; i < this->dims; i++) {
@@ -276,6 +454,7 @@ class NDArray {
          * @param axis Appending axis (default = 0)
          */
         void append (const NDArray<T> &NDArr, unsigned axis = 0) {
+            BA_PROFILE_SCOPE("NDArray::append");
             AxisError(axis);
             InsertionError(NDArr, axis);
             InsertAt(this->dimSizes[axis], NDArr, axis);
@@ -287,6 +466,7 @@ class NDArray {
          * @param axis Dimension (default = 0)
          */
         void insert (int Where, const NDArray<T> &NDArr, unsigned axis = 0) {
+            BA_PROFILE_SCOPE("NDArray::insert");
             AxisError(axis);
             InsertionError(NDArr, axis);
             InsertAt(DimIdx(Where, axis), NDArr, axis);
@@ -315,6 +495,7 @@ class NDArray {
          * @return NDArray<T> NDArray Slice
          */
         NDArray<T> slice (int From = ArrayBegin, int To = ArrayEnd, unsigned axis = 0) {
+            BA_PROFILE_SCOPE("NDArray::slice");
             if (To == ArrayEnd && (int) this->dimSizes[axis] < ArrayEnd) To = this->dimSizes[axis] - 1;
             CheckRange(From, To, axis);
             Array<unsigned> sliceShape;
@@ -352,6 +533,103 @@ class NDArray {
             }
             return newSlice;
         }
+        /**
+         * @brief Gather slices along axis by index
+         * @param Indices Axis indices (negative counts from the end), may repeat. Bounds are checked once
+         * @param axis Gather Dimension (default = 0)
+         * @return NDArray<T> NDArray with shape(axis) = Indices.size()
+         */
+        NDArray<T> take (const Array<int> &Indices, unsigned axis = 0) const {
+            BA_PROFILE_SCOPE("NDArray::take");
+            AxisError(axis);
+            unsigned n = Indices.size(), len = this->dimSizes[axis];
+            Array<int> I = Indices;
+            if (Indexing::checkIndices(I.data(), n, len)) {
+                for (unsigned k = 0; k < n; k++) if (I[k] < 0) I[k] += (int) len;
+            }
+            unsigned outer = 1, inner = 1;
+            for (unsigned i = 0; i < axis; i++) outer *= this->dimSizes[i];
+            for (unsigned i = axis + 1; i < this->dims; i++) inner *= this->dimSizes[i];
+            Array<unsigned> newShape = this->dimSizes;
+            newShape[axis] = n;
+            NDArray<T> X(this->dims, newShape);
+            // Innermost axis is a plain gather, other axes copy contiguous blocks of inner elements
+            if (inner == 1 && outer == 1) X.N = this->N.take(I);
+            else if constexpr (is_same<T, bool>::value) {
+                Array<T> M;
+                M.reserve(outer * n * inner);
+                for (unsigned o = 0; o < outer; o++) {
+                    for (unsigned k = 0; k < n; k++) {
+                        unsigned from = (o * len + I[k]) * inner;
+                        for (unsigned j = 0; j < inner; j++) M.pushBackUnchecked(this->N[(int) (from + j)]);
+                    }
+                }
+                X.N = M;
+            }
+            else {
+                const T* src = this->N.data();
+                T* dst = X.N.data();
+                for (unsigned o = 0; o < outer; o++) {
+                    for (unsigned k = 0; k < n; k++) {
+                        unsigned from = (o * len + I[k]) * inner, to = (o * n + k) * inner;
+                        copy(src + from, src + from + inner, dst + to);
+                    }
+                }
+            }
+            return X;
+        }
+        /**
+         * @brief Get cumulative sum along axis
+         * @param axis Scan Dimension (default = 0)
+         * @return NDArray<T> NDArray of the same shape
+         */
+        NDArray<T> cumsum (unsigned axis = 0) const {return alongAxis<T>(axis, [] (const Array<T> &L) {return L.cumsum();});}
+        /**
+         * @brief Get cumulative product along axis
+         * @param axis Scan Dimension (default = 0)
+         * @return NDArray<T> NDArray of the same shape
+         */
+        NDArray<T> cumprod (unsigned axis = 0) const {return alongAxis<T>(axis, [] (const Array<T> &L) {return L.cumprod();});}
+        /**
+         * @brief Get cumulative maximum along axis
+         * @param axis Scan Dimension (default = 0)
+         * @return NDArray<T> NDArray of the same shape
+         */
+        NDArray<T> cummax (unsigned axis = 0) const {return alongAxis<T>(axis, [] (const Array<T> &L) {return L.cummax();});}
+        /**
+         * @brief Get differences of neighbours along axis
+         * @param axis Difference Dimension (default = 0)
+         * @return NDArray<T> NDArray with shape(axis) shorter by 1
+         */
+        NDArray<T> diff (unsigned axis = 0) const {return alongAxis<T>(axis, [] (const Array<T> &L) {return L.diff();});}
+        /**
+         * @brief Get sum of every full window along axis
+         * @param window Window length
+         * @param axis Window Dimension (default = 0)
+         * @return NDArray<T> NDArray with shape(axis) = shape(axis) - window + 1
+         */
+        NDArray<T> rollingSum (unsigned window, unsigned axis = 0) const {return alongAxis<T>(axis, [window] (const Array<T> &L) {return L.rolling(window).sum();});}
+        /**
+         * @brief Get average of every full window along axis
+         * @param window Window length
+         * @param axis Window Dimension (default = 0)
+         * @return NDArray<double> NDArray with shape(axis) = shape(axis) - window + 1
+         */
+        NDArray<double> rollingMean (unsigned window, unsigned axis = 0) const {return alongAxis<double>(axis, [window] (const Array<T> &L) {return L.rolling(window).mean();});}
+        /**
+         * @brief Get minimum of every full window along axis
+         * @param window Window length
+         * @param axis Window Dimension (default = 0)
+         * @return NDArray<T> NDArray with shape(axis) = shape(axis) - window + 1
+         */
+        NDArray<T> rollingMin (unsigned window, unsigned axis = 0) const {return alongAxis<T>(axis, [window] (const Array<T> &L) {return L.rolling(window).min();});}
+        /**
+         * @brief Get maximum of every full window along axis
+         * @param window Window length
+         * @param axis Window Dimension (default = 0)
+         * @return NDArray<T> NDArray with shape(axis) = shape(axis) - window + 1
+         */
+        NDArray<T> rollingMax (unsigned window, unsigned axis = 0) const {return alongAxis<T>(axis, [window] (const Array<T> &L) {return L.rolling(window).max();});}
         /**
          * @brief Reshape NDArray by collapsing dimensions with length = 1
          */
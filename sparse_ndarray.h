@@ -0,0 +1,700 @@
+/**
+ * @file sparse_ndarray.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Sparse NDArrays for Better Array. Only non-zero values and their positions are stored.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef SPARSE_NDARRAY_H
+#define SPARSE_NDARRAY_H
+#include <stdexcept>
+#include "better_array.h"
+#include "ndarray.h"
+using namespace std;
+// Compressed layout of 2-D sparse matrix
+enum SparseLayout {
+    SPARSE_CSR = 0,     // Compressed rows: every row is a run of (column, value) pairs
+    SPARSE_CSC = 1      // Compressed columns: every column is a run of (row, value) pairs
+};
+/**
+ * @brief Compressed 2-D sparse matrix (CSR or CSC)
+ *
+ * Major line k (row for CSR, column for CSC) holds minor indices idx[ptr[k]] .. idx[ptr[k + 1] - 1]
+ * in increasing order and their values at the same positions.
+ */
+template <class T>
+struct CompressedMatrix {
+    SparseLayout layout;
+    unsigned rows;
+    unsigned cols;
+    Array<unsigned> ptr;
+    Array<unsigned> idx;
+    Array<T> values;
+};
+/**
+ * @brief Sparse N-Dimensional Array in canonical COO form
+ *
+ * Non-zero values are kept with their row-major linear position, sorted and without duplicates.
+ * Memory grows with the number of stored values, not with the shape. Operations only visit stored values,
+ * values that become zero are dropped.
+ * @tparam T Arithmetic type
+ */
+template <class T>
+class SparseNDArray {
+    static_assert(is_arithmetic<T>::value && !is_same<T, bool>::value, "SparseNDArray needs arithmetic values!");
+    private:
+        unsigned dims;
+        Array < unsigned > dimSizes;
+        Array < unsigned long long > I;     // Linear positions, increasing
+        Array < T > V;                      // Value of every position
+        void AxisError (unsigned axis) const {
+            if (axis >= this->dims) throw std::invalid_argument("Axis does not exist!");
+        }
+        void ShapeError (const Array<unsigned> &Other) const {
+            if (Other.size() != this->dims) throw std::invalid_argument("Shapes do not match!");
+            for (unsigned i = 0; i < this->dims; i++) if (Other[i] != this->dimSizes[i]) throw std::invalid_argument("Shapes do not match!");
+        }
+        void MatrixError () const {
+            if (this->dims != 2) throw std::invalid_argument("Operation needs 2-D SparseNDArray!");
+        }
+        unsigned long long Idx (const Array<int> &NDIndex) const {
+            if (NDIndex.size() != this->dims) throw std::invalid_argument("Index must have same amount of dimesions as SparseNDArray it refers to!");
+            unsigned long long trueIndex = 0;
+            for (unsigned i = 0; i < this->dims; i++) {
+                int index = NDIndex[i];
+                if (index < 0) index += (int) this->dimSizes[i];
+                if (index < 0 || index >= (int) this->dimSizes[i]) throw std::invalid_argument("SparseNDArray Index out of range!");
+                trueIndex = trueIndex * this->dimSizes[i] + index;
+            }
+            return trueIndex;
+        }
+        // Position of linear index in I, or I.size() when not stored
+        unsigned find (unsigned long long at) const {
+            const unsigned long long* P = this->I.data();
+            const unsigned long long* hit = lower_bound(P, P + this->I.size(), at);
+            return hit != P + this->I.size() && *hit == at ? (unsigned) (hit - P) : this->I.size();
+        }
+        // Sizes of dimensions before and after axis (outer * len * inner = fullSize)
+        void split (unsigned axis, unsigned long long &outer, unsigned long long &inner) const {
+            outer = 1;
+            inner = 1;
+            for (unsigned i = 0; i < axis; i++) outer *= this->dimSizes[i];
+            for (unsigned i = axis + 1; i < this->dims; i++) inner *= this->dimSizes[i];
+        }
+        // Merge stored values of two operands. Keep selects positions stored in one operand only (union) or skips them (intersection)
+        template <class F>
+        SparseNDArray<T> merge (const SparseNDArray<T> &Other, bool unite, F f) const {
+            ShapeError(Other.dimSizes);
+            SparseNDArray<T> X(this->dims, this->dimSizes);
+            unsigned n = this->I.size(), m = Other.I.size(), i = 0, j = 0;
+            X.I.reserve(unite ? n + m : (n < m ? n : m));
+            X.V.reserve(unite ? n + m : (n < m ? n : m));
+            const unsigned long long* A = this->I.data();
+            const unsigned long long* B = Other.I.data();
+            const T* a = this->V.data();
+            const T* b = Other.V.data();
+            auto emit = [&X] (unsigned long long at, T value) {
+                if (value == T()) return;
+                X.I.pushBackUnchecked(at);
+                X.V.pushBackUnchecked(value);
+            };
+            while (i < n && j < m) {
+                if (A[i] < B[j]) {
+                    if (unite) emit(A[i], f(a[i], T()));
+                    i++;
+                }
+                else if (B[j] < A[i]) {
+                    if (unite) emit(B[j], f(T(), b[j]));
+                    j++;
+                }
+                else {
+                    emit(A[i], f(a[i], b[j]));
+                    i++;
+                    j++;
+                }
+            }
+            for (; unite && i < n; i++) emit(A[i], f(a[i], T()));
+            for (; unite && j < m; j++) emit(B[j], f(T(), b[j]));
+            return X;
+        }
+        // Reduce stored values along axis into NDArray with shape(axis) = 1. Counts of stored values per output are returned too
+        template <class R, class F>
+        NDArray<R> reduceAxis (unsigned axis, R init, F f, Array<unsigned> &Counts) const {
+            AxisError(axis);
+            unsigned long long outer, inner, len = this->dimSizes[axis];
+            split(axis, outer, inner);
+            Array<unsigned> newShape = this->dimSizes;
+            newShape[axis] = 1;
+            NDArray<R> X(this->dims, newShape);
+            R* out = X.N.data();
+            for (unsigned long long k = 0; k < outer * inner; k++) out[k] = init;
+            Counts = Array<unsigned>((unsigned) (outer * inner));
+            unsigned* count = Counts.data();
+            const unsigned long long* P = this->I.data();
+            const T* v = this->V.data();
+            for (unsigned k = 0; k < this->I.size(); k++) {
+                unsigned long long at = P[k] / (len * inner) * inner + P[k] % inner;
+                out[at] = f(out[at], v[k]);
+                count[at]++;
+            }
+            return X;
+        }
+        // Build from unsorted linear positions, duplicates are summed and zeros dropped
+        void assign (const Array<unsigned long long> &Positions, const Array<T> &Values) {
+            unsigned n = Positions.size();
+            Array<int> Order = Positions.argsort();
+            const int* o = Order.data();
+            const unsigned long long* P = Positions.data();
+            const T* v = Values.data();
+            this->I = Array<unsigned long long>();
+            this->V = Array<T>();
+            this->I.reserve(n);
+            this->V.reserve(n);
+            for (unsigned k = 0; k < n;) {
+                unsigned long long at = P[o[k]];
+                T value = T();
+                for (; k < n && P[o[k]] == at; k++) value += v[o[k]];
+                if (value == T()) continue;
+                this->I.pushBackUnchecked(at);
+                this->V.pushBackUnchecked(value);
+            }
+        }
+    public:
+        // CONSTRUCTORS
+        SparseNDArray () {
+            this->dims = 1;
+            this->dimSizes.append(0);
+        }
+        /**
+         * @brief Construct SparseNDArray of given shape without stored values (all zeros)
+         * @param Dimensions Dimension count
+         * @param Sizes Shape
+         */
+        explicit SparseNDArray (unsigned Dimensions, Array<unsigned> Sizes) {
+            if (Dimensions != Sizes.size()) throw std::invalid_argument("Sizes Array must be the same as dimension count!");
+            this->dims = Dimensions;
+            this->dimSizes = Sizes;
+        }
+        explicit SparseNDArray (unsigned Dimensions, initializer_list<unsigned> SizeList) : SparseNDArray(Dimensions, Array<unsigned>(SizeList)) {}
+        /**
+         * @brief Construct SparseNDArray from coordinates (COO). Duplicate coordinates are summed, zeros are not stored
+         * @param Dimensions Dimension count
+         * @param Sizes Shape
+         * @param Coords Coordinates of value k at Coords[k * Dimensions] .. Coords[k * Dimensions + Dimensions - 1] (negative counts from the end)
+         * @param Values Values
+         */
+        explicit SparseNDArray (unsigned Dimensions, Array<unsigned> Sizes, const Array<int> &Coords, const Array<T> &Values) : SparseNDArray(Dimensions, Sizes) {
+            BA_PROFILE_SCOPE("SparseNDArray::fromCOO");
+            unsigned n = Values.size();
+            if (Coords.size() != (unsigned long long) n * Dimensions) throw std::invalid_argument("Every value needs one coordinate per dimension!");
+            Array<unsigned long long> Positions(n);
+            Array<int> NDIndex(Dimensions);
+            const int* c = Coords.data();
+            int* id = NDIndex.data();
+            for (unsigned k = 0; k < n; k++) {
+                for (unsigned d = 0; d < Dimensions; d++) id[d] = c[(unsigned long long) k * Dimensions + d];
+                Positions[k] = Idx(NDIndex);
+            }
+            assign(Positions, Values);
+        }
+        explicit SparseNDArray (unsigned Dimensions, initializer_list<unsigned> SizeList, const Array<int> &Coords, const Array<T> &Values) : SparseNDArray(Dimensions, Array<unsigned>(SizeList), Coords, Values) {}
+        /**
+         * @brief Construct SparseNDArray from non-zero values of dense NDArray
+         * @param Dense Dense NDArray
+         */
+        explicit SparseNDArray (const NDArray<T> &Dense) : SparseNDArray(Dense.dimension(), Dense.shape()) {
+            BA_PROFILE_SCOPE("SparseNDArray::fromDense");
+            unsigned n = Dense.fullSize();
+            const T* D = Dense.N.data();
+            // Count non-zeros per chunk, then every chunk writes its own range of the result
+            unsigned chunkCount = Parallel::chunks(n, 1u << 16);
+            vector<unsigned> counts(chunkCount + 1, 0);
+            Parallel::forChunks(n, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                unsigned k = 0;
+                for (unsigned long long i = b; i < e; i++) k += D[i] != T();
+                counts[c + 1] = k;
+            });
+            for (unsigned c = 0; c < chunkCount; c++) counts[c + 1] += counts[c];
+            this->I = Array<unsigned long long>(counts[chunkCount]);
+            this->V = Array<T>(counts[chunkCount]);
+            unsigned long long* P = this->I.data();
+            T* v = this->V.data();
+            Parallel::forChunks(n, chunkCount, [&] (unsigned c, unsigned long long b, unsigned long long e) {
+                unsigned k = counts[c];
+                for (unsigned long long i = b; i < e; i++) {
+                    if (D[i] == T()) continue;
+                    P[k] = i;
+                    v[k++] = D[i];
+                }
+            });
+        }
+        /**
+         * @brief Construct 2-D SparseNDArray from compressed matrix
+         * @param M CSR or CSC matrix
+         */
+        explicit SparseNDArray (const CompressedMatrix<T> &M) : SparseNDArray(2, {M.rows, M.cols}) {
+            unsigned major = M.layout == SPARSE_CSR ? M.rows : M.cols;
+            if (M.ptr.size() != major + 1 || M.idx.size() != M.values.size() || M.ptr[(int) major] != M.idx.size()) throw std::invalid_argument("Invalid compressed matrix!");
+            Array<unsigned long long> Positions(M.idx.size());
+            for (unsigned k = 0; k < major; k++) {
+                for (unsigned j = M.ptr[(int) k]; j < M.ptr[(int) k + 1]; j++) {
+                    unsigned minor = M.idx[(int) j];
+                    if (minor >= (M.layout == SPARSE_CSR ? M.cols : M.rows)) throw std::invalid_argument("Invalid compressed matrix!");
+                    Positions[j] = M.layout == SPARSE_CSR ? (unsigned long long) k * M.cols + minor : (unsigned long long) minor * M.cols + k;
+                }
+            }
+            assign(Positions, M.values);
+        }
+        // FUNCTIONS
+        /**
+         * @brief Get number of dimensions
+         * @return unsigned
+         */
+        unsigned dimension () const {return this->dims;}
+        /**
+         * @brief Get shape
+         * @return Array<unsigned> Dimensions shape (length)
+         */
+        Array<unsigned> shape () const {return this->dimSizes;}
+        /**
+         * @brief Get shape of one dimension
+         * @param dim Dimension Index
+         * @return unsigned Dimension shape (length)
+         */
+        unsigned shape (unsigned dim) const {
+            AxisError(dim);
+            return this->dimSizes[dim];
+        }
+        /**
+         * @brief Get element count of the dense equivalent
+         * @return unsigned long long
+         */
+        unsigned long long fullSize () const {
+            unsigned long long n = 1;
+            for (unsigned i = 0; i < this->dims; i++) n *= this->dimSizes[i];
+            return n;
+        }
+        /**
+         * @brief Get number of stored (non-zero) values
+         * @return unsigned
+         */
+        unsigned nnz () const {return this->I.size();}
+        /**
+         * @brief Get stored fraction of all elements
+         * @return double Density in range [0, 1]
+         */
+        double density () const {return fullSize() == 0 ? 0.0 : (double) nnz() / (double) fullSize();}
+        /**
+         * @brief Get stored values in row-major order
+         * @return Array<T>
+         */
+        Array<T> values () const {return this->V;}
+        /**
+         * @brief Get row-major linear positions of stored values
+         * @return Array<unsigned long long>
+         */
+        Array<unsigned long long> positions () const {return this->I;}
+        /**
+         * @brief Get coordinates of stored values (COO), value k at [k * dimension(), (k + 1) * dimension())
+         * @return Array<int>
+         */
+        Array<int> coords () const {
+            Array<int> X((unsigned) ((unsigned long long) this->I.size() * this->dims));
+            int* c = X.data();
+            for (unsigned k = 0; k < this->I.size(); k++) {
+                unsigned long long at = this->I[(int) k];
+                for (int d = (int) this->dims - 1; d >= 0; d--) {
+                    c[(unsigned long long) k * this->dims + d] = (int) (at % this->dimSizes[d]);
+                    at /= this->dimSizes[d];
+                }
+            }
+            return X;
+        }
+        /**
+         * @brief Get value (zero when not stored)
+         * @param NDIndex Index of every dimension (negative counts from the end)
+         * @return T
+         */
+        T at (const Array<int> &NDIndex) const {
+            unsigned k = find(Idx(NDIndex));
+            return k < this->I.size() ? this->V[(int) k] : T();
+        }
+        T at (initializer_list<int> NDIndex) const {return at(Array<int>(NDIndex));}
+        /**
+         * @brief Set value. Zero removes stored value
+         * @param NDIndex Index of every dimension (negative counts from the end)
+         * @param Value New value
+         */
+        void set (const Array<int> &NDIndex, const T& Value) {
+            unsigned long long at = Idx(NDIndex);
+            unsigned k = find(at);
+            if (k < this->I.size()) {
+                if (Value == T()) {
+                    this->I.erase((int) k);
+                    this->V.erase((int) k);
+                }
+                else this->V[(int) k] = Value;
+                return;
+            }
+            if (Value == T()) return;
+            const unsigned long long* P = this->I.data();
+            unsigned pos = (unsigned) (lower_bound(P, P + this->I.size(), at) - P);
+            if (pos == this->I.size()) {
+                this->I.append(at);
+                this->V.append(Value);
+            }
+            else {
+                this->I.insert((int) pos, at);
+                this->V.insert((int) pos, Value);
+            }
+        }
+        void set (initializer_list<int> NDIndex, const T& Value) {set(Array<int>(NDIndex), Value);}
+        /**
+         * @brief Convert to dense NDArray
+         * @return NDArray<T>
+         */
+        NDArray<T> toDense () const {
+            BA_PROFILE_SCOPE("SparseNDArray::toDense");
+            if (fullSize() > 0xFFFFFFFFull) throw std::invalid_argument("SparseNDArray is too large for dense NDArray!");
+            NDArray<T> X(this->dims, this->dimSizes);
+            T* D = X.N.data();
+            const unsigned long long* P = this->I.data();
+            const T* v = this->V.data();
+            for (unsigned k = 0; k < this->I.size(); k++) D[P[k]] = v[k];
+            return X;
+        }
+        /**
+         * @brief Convert 2-D SparseNDArray to compressed matrix
+         * @param Layout SPARSE_CSR or SPARSE_CSC. Default SPARSE_CSR
+         * @return CompressedMatrix<T>
+         */
+        CompressedMatrix<T> compress (SparseLayout Layout = SPARSE_CSR) const {
+            BA_PROFILE_SCOPE("SparseNDArray::compress");
+            MatrixError();
+            CompressedMatrix<T> M;
+            M.layout = Layout;
+            M.rows = this->dimSizes[0];
+            M.cols = this->dimSizes[1];
+            unsigned n = this->I.size(), major = Layout == SPARSE_CSR ? M.rows : M.cols;
+            M.ptr = Array<unsigned>(major + 1);
+            M.idx = Array<unsigned>(n);
+            M.values = Array<T>(n);
+            unsigned* ptr = M.ptr.data();
+            unsigned* idx = M.idx.data();
+            T* vals = M.values.data();
+            const unsigned long long* P = this->I.data();
+            const T* v = this->V.data();
+            // Row-major order already is CSR. CSC is a stable counting sort by column, rows stay increasing
+            for (unsigned k = 0; k < n; k++) ptr[(Layout == SPARSE_CSR ? P[k] / M.cols : P[k] % M.cols) + 1]++;
+            for (unsigned k = 0; k < major; k++) ptr[k + 1] += ptr[k];
+            vector<unsigned> cursor(ptr, ptr + major);
+            for (unsigned k = 0; k < n; k++) {
+                unsigned r = (unsigned) (P[k] / M.cols), c = (unsigned) (P[k] % M.cols);
+                unsigned at = cursor[Layout == SPARSE_CSR ? r : c]++;
+                idx[at] = Layout == SPARSE_CSR ? c : r;
+                vals[at] = v[k];
+            }
+            return M;
+        }
+        /**
+         * @brief Get CSR form of 2-D SparseNDArray
+         */
+        CompressedMatrix<T> toCSR () const {return compress(SPARSE_CSR);}
+        /**
+         * @brief Get CSC form of 2-D SparseNDArray
+         */
+        CompressedMatrix<T> toCSC () const {return compress(SPARSE_CSC);}
+        /**
+         * @brief Get transposed 2-D SparseNDArray
+         * @return SparseNDArray<T>
+         */
+        SparseNDArray<T> transpose () const {
+            CompressedMatrix<T> M = compress(SPARSE_CSC);
+            // Columns of this matrix are rows of the transposed one
+            M.layout = SPARSE_CSR;
+            swap(M.rows, M.cols);
+            return SparseNDArray<T>(M);
+        }
+        /**
+         * @brief Apply function to stored values. Implicit zeros are not visited, so f(0) should be 0
+         * @param f Function T -> T
+         * @return SparseNDArray<T>
+         */
+        template <class F>
+        SparseNDArray<T> map (F f) const {
+            SparseNDArray<T> X(this->dims, this->dimSizes);
+            X.I.reserve(this->I.size());
+            X.V.reserve(this->I.size());
+            for (unsigned k = 0; k < this->I.size(); k++) {
+                T value = f(this->V[(int) k]);
+                if (value == T()) continue;
+                X.I.pushBackUnchecked(this->I[(int) k]);
+                X.V.pushBackUnchecked(value);
+            }
+            return X;
+        }
+        /**
+         * @brief Get sum of all values
+         * @return T
+         */
+        T sum () const {
+            T s = T();
+            for (unsigned k = 0; k < this->V.size(); k++) s += this->V[(int) k];
+            return s;
+        }
+        /**
+         * @brief Get average of all values (implicit zeros included)
+         * @return double
+         */
+        double mean () const {
+            if (fullSize() == 0) throw std::invalid_argument("Empty SparseNDArray!");
+            return (double) sum() / (double) fullSize();
+        }
+        /**
+         * @brief Get maximum value (implicit zeros included)
+         * @return T
+         */
+        T max () const {
+            if (fullSize() == 0) throw std::invalid_argument("Empty SparseNDArray!");
+            if (nnz() == 0) return T();
+            T M = this->V.max();
+            return nnz() < fullSize() && M < T() ? T() : M;
+        }
+        /**
+         * @brief Get minimum value (implicit zeros included)
+         * @return T
+         */
+        T min () const {
+            if (fullSize() == 0) throw std::invalid_argument("Empty SparseNDArray!");
+            if (nnz() == 0) return T();
+            T M = this->V.min();
+            return nnz() < fullSize() && T() < M ? T() : M;
+        }
+        /**
+         * @brief Get sum along axis
+         * @param axis Reduced Dimension
+         * @return NDArray<T> NDArray with shape(axis) = 1
+         */
+        NDArray<T> sum (unsigned axis) const {
+            BA_PROFILE_SCOPE("SparseNDArray::sum");
+            Array<unsigned> Counts;
+            return reduceAxis<T>(axis, T(), [] (T acc, T v) {return acc + v;}, Counts);
+        }
+        /**
+         * @brief Get average along axis (implicit zeros included)
+         * @param axis Reduced Dimension
+         * @return NDArray<double> NDArray with shape(axis) = 1
+         */
+        NDArray<double> mean (unsigned axis) const {
+            BA_PROFILE_SCOPE("SparseNDArray::mean");
+            AxisError(axis);
+            if (this->dimSizes[axis] == 0) throw std::invalid_argument("Empty SparseNDArray!");
+            Array<unsigned> Counts;
+            double len = (double) this->dimSizes[axis];
+            NDArray<double> X = reduceAxis<double>(axis, 0.0, [] (double acc, T v) {return acc + (double) v;}, Counts);
+            double* out = X.N.data();
+            for (unsigned k = 0; k < X.fullSize(); k++) out[k] /= len;
+            return X;
+        }
+        /**
+         * @brief Get maximum along axis (implicit zeros included)
+         * @param axis Reduced Dimension
+         * @return NDArray<T> NDArray with shape(axis) = 1
+         */
+        NDArray<T> max (unsigned axis) const {
+            BA_PROFILE_SCOPE("SparseNDArray::max");
+            AxisError(axis);
+            if (this->dimSizes[axis] == 0) throw std::invalid_argument("Empty SparseNDArray!");
+            Array<unsigned> Counts;
+            NDArray<T> X = reduceAxis<T>(axis, numeric_limits<T>::lowest(), [] (T acc, T v) {return v > acc ? v : acc;}, Counts);
+            T* out = X.N.data();
+            for (unsigned k = 0; k < X.fullSize(); k++) if (Counts[(int) k] < this->dimSizes[axis] && out[k] < T()) out[k] = T();
+            return X;
+        }
+        /**
+         * @brief Get minimum along axis (implicit zeros included)
+         * @param axis Reduced Dimension
+         * @return NDArray<T> NDArray with shape(axis) = 1
+         */
+        NDArray<T> min (unsigned axis) const {
+            BA_PROFILE_SCOPE("SparseNDArray::min");
+            AxisError(axis);
+            if (this->dimSizes[axis] == 0) throw std::invalid_argument("Empty SparseNDArray!");
+            Array<unsigned> Counts;
+            NDArray<T> X = reduceAxis<T>(axis, numeric_limits<T>::max(), [] (T acc, T v) {return v < acc ? v : acc;}, Counts);
+            T* out = X.N.data();
+            for (unsigned k = 0; k < X.fullSize(); k++) if (Counts[(int) k] < this->dimSizes[axis] && T() < out[k]) out[k] = T();
+            return X;
+        }
+        /**
+         * @brief Multiply 2-D SparseNDArray by dense matrix. Work is proportional to nnz * Dense.shape(1)
+         * @param Dense Dense 2-D NDArray with shape(0) = shape(1) of this SparseNDArray
+         * @return NDArray<T> Dense product
+         */
+        NDArray<T> matmul (const NDArray<T> &Dense) const {
+            BA_PROFILE_SCOPE("SparseNDArray::matmul");
+            MatrixError();
+            if (Dense.dimension() != 2 || Dense.shape(0) != this->dimSizes[1]) throw std::invalid_argument("Matrix shapes do not match!");
+            unsigned rows = this->dimSizes[0], k = Dense.shape(1);
+            CompressedMatrix<T> M = compress(SPARSE_CSR);
+            NDArray<T> X(2, {rows, k});
+            const T* B = Dense.N.data();
+            T* C = X.N.data();
+            const unsigned* ptr = M.ptr.data();
+            const unsigned* idx = M.idx.data();
+            const T* v = M.values.data();
+            // Output rows are independent, every stored value adds one scaled dense row
+            unsigned chunkCount = Parallel::chunks((unsigned long long) this->I.size() * k, 1u << 16) > 1 ? Parallel::chunks(rows, 64) : 1;
+            Parallel::forChunks(rows, chunkCount, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                for (unsigned long long r = b; r < e; r++) {
+                    T* out = C + r * k;
+                    for (unsigned j = ptr[r]; j < ptr[r + 1]; j++) {
+                        const T* row = B + (unsigned long long) idx[j] * k;
+                        T a = v[j];
+                        for (unsigned c = 0; c < k; c++) out[c] += a * row[c];
+                    }
+                }
+            });
+            return X;
+        }
+        /**
+         * @brief Multiply dense matrix by 2-D SparseNDArray (Dense x this). Work is proportional to Dense.shape(0) * nnz
+         * @param Dense Dense 2-D NDArray with shape(1) = shape(0) of this SparseNDArray
+         * @return NDArray<T> Dense product
+         */
+        NDArray<T> rmatmul (const NDArray<T> &Dense) const {
+            BA_PROFILE_SCOPE("SparseNDArray::rmatmul");
+            MatrixError();
+            if (Dense.dimension() != 2 || Dense.shape(1) != this->dimSizes[0]) throw std::invalid_argument("Matrix shapes do not match!");
+            unsigned rows = Dense.shape(0), inner = this->dimSizes[0], cols = this->dimSizes[1];
+            CompressedMatrix<T> M = compress(SPARSE_CSR);
+            NDArray<T> X(2, {rows, cols});
+            const T* A = Dense.N.data();
+            T* C = X.N.data();
+            const unsigned* ptr = M.ptr.data();
+            const unsigned* idx = M.idx.data();
+            const T* v = M.values.data();
+            // Every non-zero of a dense row scatters one sparse row into the output row
+            unsigned chunkCount = Parallel::chunks((unsigned long long) rows * this->I.size(), 1u << 16) > 1 ? Parallel::chunks(rows, 16) : 1;
+            Parallel::forChunks(rows, chunkCount, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                for (unsigned long long i = b; i < e; i++) {
+                    const T* row = A + i * inner;
+                    T* out = C + i * cols;
+                    for (unsigned r = 0; r < inner; r++) {
+                        T a = row[r];
+                        if (a == T()) continue;
+                        for (unsigned j = ptr[r]; j < ptr[r + 1]; j++) out[idx[j]] += a * v[j];
+                    }
+                }
+            });
+            return X;
+        }
+        /**
+         * @brief Multiply 2-D SparseNDArray by vector
+         * @param Vec Array with size = shape(1)
+         * @return Array<T> Product with size = shape(0)
+         */
+        Array<T> matmul (const Array<T> &Vec) const {
+            BA_PROFILE_SCOPE("SparseNDArray::matmul");
+            MatrixError();
+            if (Vec.size() != this->dimSizes[1]) throw std::invalid_argument("Matrix shapes do not match!");
+            Array<T> X(this->dimSizes[0]);
+            T* out = X.data();
+            const T* x = Vec.data();
+            const unsigned long long* P = this->I.data();
+            const T* v = this->V.data();
+            unsigned long long cols = this->dimSizes[1];
+            unsigned rows = this->dimSizes[0], n = this->I.size();
+            // Positions are sorted row-major, so a range of rows is one run of stored values found by binary search
+            unsigned chunkCount = Parallel::chunks(n, 1u << 16) > 1 ? Parallel::chunks(rows, 64) : 1;
+            Parallel::forChunks(rows, chunkCount, [&] (unsigned, unsigned long long b, unsigned long long e) {
+                unsigned first = (unsigned) (lower_bound(P, P + n, b * cols) - P), last = (unsigned) (lower_bound(P + first, P + n, e * cols) - P);
+                for (unsigned k = first; k < last; k++) out[P[k] / cols] += v[k] * x[P[k] % cols];
+            });
+            return X;
+        }
+        /**
+         * @brief Display shape and stored values, one per line
+         */
+        void show () const {cout<<format()<<endl;}
+        /**
+         * @brief Format shape and stored values the same way show() prints them
+         * @return string
+         */
+        string format () const {
+            string out = "SparseNDArray(";
+            for (unsigned i = 0; i < this->dims; i++) {
+                if (i > 0) out += ", ";
+                Formatter::append(out, this->dimSizes[i]);
+            }
+            out += "), nnz = ";
+            Formatter::append(out, nnz());
+            Array<int> C = coords();
+            for (unsigned k = 0; k < this->I.size(); k++) {
+                out += "\n  (";
+                for (unsigned d = 0; d < this->dims; d++) {
+                    if (d > 0) out += ", ";
+                    Formatter::append(out, C[(int) (k * this->dims + d)]);
+                }
+                out += "): ";
+                Formatter::append(out, this->V[(int) k]);
+            }
+            return out;
+        }
+        /*
+            OPERATORS OVERLOADING
+        */
+        // Element-wise operations (positions stored in either operand)
+        SparseNDArray<T> operator+ (const SparseNDArray<T> &Other) const {return merge(Other, true, [] (T a, T b) {return a + b;});}
+        SparseNDArray<T> operator- (const SparseNDArray<T> &Other) const {return merge(Other, true, [] (T a, T b) {return a - b;});}
+        // Element-wise product (positions stored in both operands)
+        SparseNDArray<T> operator* (const SparseNDArray<T> &Other) const {return merge(Other, false, [] (T a, T b) {return a * b;});}
+        // Scaling stored values
+        SparseNDArray<T> operator* (const T& Num) const {return map([Num] (T v) {return v * Num;});}
+        SparseNDArray<T> operator/ (const T& Num) const {return map([Num] (T v) {return v / Num;});}
+        SparseNDArray<T> operator- () const {return map([] (T v) {return -v;});}
+        // Dense operand: sum copies the dense values once and adds stored values, product only reads stored positions
+        NDArray<T> operator+ (const NDArray<T> &Dense) const {
+            ShapeError(Dense.shape());
+            NDArray<T> X = Dense;
+            T* D = X.N.data();
+            for (unsigned k = 0; k < this->I.size(); k++) D[this->I[(int) k]] += this->V[(int) k];
+            return X;
+        }
+        SparseNDArray<T> operator* (const NDArray<T> &Dense) const {
+            ShapeError(Dense.shape());
+            const T* D = Dense.N.data();
+            SparseNDArray<T> X(this->dims, this->dimSizes);
+            X.I.reserve(this->I.size());
+            X.V.reserve(this->I.size());
+            for (unsigned k = 0; k < this->I.size(); k++) {
+                T value = this->V[(int) k] * D[this->I[(int) k]];
+                if (value == T()) continue;
+                X.I.pushBackUnchecked(this->I[(int) k]);
+                X.V.pushBackUnchecked(value);
+            }
+            return X;
+        }
+        bool operator== (const SparseNDArray<T> &Other) const {
+            if (this->dims != Other.dims || this->I.size() != Other.I.size()) return false;
+            for (unsigned i = 0; i < this->dims; i++) if (this->dimSizes[i] != Other.dimSizes[i]) return false;
+            for (unsigned k = 0; k < this->I.size(); k++) {
+                if (this->I[(int) k] != Other.I[(int) k] || this->V[(int) k] != Other.V[(int) k]) return false;
+            }
+            return true;
+        }
+        bool operator!= (const SparseNDArray<T> &Other) const {return !(*this == Other);}
+};
+/**
+ * @brief Multiply dense matrix by 2-D SparseNDArray
+ * @param Dense Dense 2-D NDArray with shape(1) = shape(0) of Sparse
+ * @param Sparse 2-D SparseNDArray
+ * @return NDArray<T> Dense product
+ */
+template <class T>
+NDArray<T> matmul (const NDArray<T> &Dense, const SparseNDArray<T> &Sparse) {return Sparse.rmatmul(Dense);}
+#endif // !SPARSE_NDARRAY_H
@@ -0,0 +1,212 @@
+/**
+ * @file table.h
+ * @author DingoMC (www.dingomc.net)
+ * @brief Column-oriented record container for Better Array. Every field lives in its own Array.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) DingoMC Systems 2026
+ * @warning Requires C++17.
+ * @note Full documentation https://github.com/DingoMC/BetterArray/README.md
+ */
+#ifndef TABLE_H
+#define TABLE_H
+#include <tuple>
+#include <utility>
+#include <stdexcept>
+#include "better_array.h"
+using namespace std;
+/**
+ * @brief Struct-of-arrays record container
+ *
+ * Row i is made of element i of every column. Column scans (masks, reductions, sort keys)
+ * only read the column they need instead of whole records.
+ * @tparam Cols Column types, e.g. Table<int, double, string>
+ */
+template <class... Cols>
+class Table {
+    static_assert(sizeof...(Cols) > 0, "Table needs at least one column!");
+    private:
+        tuple < Array < Cols >... > C;
+        unsigned S;
+        template <size_t... I>
+        void appendRowImpl (const tuple<Cols...> &Row, index_sequence<I...>) {
+            (get<I>(this->C).append(get<I>(Row)), ...);
+        }
+        template <size_t... I>
+        tuple<Cols...> rowImpl (int index, index_sequence<I...>) const {
+            return tuple<Cols...>(get<I>(this->C)[index]...);
+        }
+        template <size_t... I>
+        Table<Cols...> maskedImpl (const ArrayMask &Mask, index_sequence<I...>) const {
+            return Table<Cols...>(get<I>(this->C).masked(Mask)...);
+        }
+        template <size_t... I>
+        Table<Cols...> takeImpl (const Array<int> &Rows, index_sequence<I...>) const {
+            return Table<Cols...>(get<I>(this->C).take(Rows)...);
+        }
+        template <size_t... I>
+        void reserveImpl (unsigned n, index_sequence<I...>) {
+            (get<I>(this->C).reserve(n), ...);
+        }
+        template <size_t... I>
+        void appendRowText (string &out, unsigned i, index_sequence<I...>) const {
+            ((out += (I == 0 ? "" : ", "), Formatter::append(out, get<I>(this->C)[(int) i])), ...);
+        }
+        template <size_t... I>
+        unsigned sizesOf (index_sequence<I...>, unsigned i) const {
+            unsigned sizes[] = {get<I>(this->C).size()...};
+            return sizes[i];
+        }
+    public:
+        static const unsigned columnCount = sizeof...(Cols);
+        template <size_t I> using ColumnType = typename tuple_element<I, tuple<Cols...>>::type;
+        // CONSTRUCTORS
+        /**
+         * @brief Construct a new empty Table object
+         */
+        Table () : S(0) {}
+        /**
+         * @brief Construct a new Table object from columns
+         * @param Columns One Array per column, all of the same length
+         */
+        explicit Table (Array<Cols>... Columns) : C(std::move(Columns)...) {
+            this->S = sizesOf(index_sequence_for<Cols...>(), 0);
+            for (unsigned i = 1; i < columnCount; i++) {
+                if (sizesOf(index_sequence_for<Cols...>(), i) != this->S) throw std::invalid_argument("Columns must have the same length!");
+            }
+        }
+        // FUNCTIONS
+        /**
+         * @brief Get number of rows
+         * @return unsigned Row count
+         */
+        unsigned size () const {return this->S;}
+        /**
+         * @brief Preallocate every column for at least n rows
+         * @param n Minimal capacity
+         */
+        void reserve (unsigned n) {reserveImpl(n, index_sequence_for<Cols...>());}
+        /**
+         * @brief Get read-only column. Use existing Array operators for masks, e.g. T.column<1>() > 2.5
+         * @tparam I Column index
+         * @return const Array<ColumnType<I>>&
+         */
+        template <size_t I>
+        const Array<ColumnType<I>>& column () const {return get<I>(this->C);}
+        /**
+         * @brief Replace whole column
+         * @tparam I Column index
+         * @param Column New values, must have the same length as the Table
+         */
+        template <size_t I>
+        void setColumn (const Array<ColumnType<I>> &Column) {
+            if (Column.size() != this->S) throw std::invalid_argument("Column must have the same length as the Table!");
+            get<I>(this->C) = Column;
+        }
+        /**
+         * @brief Get single field
+         * @tparam I Column index
+         * @param index Row index (negative counts from the end)
+         * @return ColumnType<I>& Field reference
+         */
+        template <size_t I>
+        ColumnType<I>& at (int index) {return get<I>(this->C)[index];}
+        template <size_t I>
+        ColumnType<I> at (int index) const {return get<I>(this->C)[index];}
+        /**
+         * @brief Add row to the end of a Table
+         * @param Values One value per column
+         */
+        void appendRow (const Cols&... Values) {appendRow(tuple<Cols...>(Values...));}
+        /**
+         * @brief Add row to the end of a Table
+         * @param Row Tuple with one value per column
+         */
+        void appendRow (const tuple<Cols...> &Row) {
+            appendRowImpl(Row, index_sequence_for<Cols...>());
+            this->S++;
+        }
+        /**
+         * @brief Assemble row from all columns
+         * @param index Row index (negative counts from the end)
+         * @return tuple<Cols...>
+         */
+        tuple<Cols...> row (int index) const {return rowImpl(index, index_sequence_for<Cols...>());}
+        /**
+         * @brief Select rows using boolean mask (same rules as Array::masked)
+         * @param Mask Mask built from any column
+         * @return Table<Cols...> Selected rows
+         */
+        Table<Cols...> masked (const ArrayMask &Mask) const {
+            BA_PROFILE_SCOPE("Table::masked");
+            if (this->S == 0) return *this;
+            return maskedImpl(Mask, index_sequence_for<Cols...>());
+        }
+        /**
+         * @brief Gather rows by index
+         * @param Rows Row indices (negative counts from the end), may repeat
+         * @return Table<Cols...> Gathered rows
+         */
+        Table<Cols...> take (const Array<int> &Rows) const {
+            BA_PROFILE_SCOPE("Table::take");
+            if (Rows.size() == 0) return Table<Cols...>();
+            return takeImpl(Rows, index_sequence_for<Cols...>());
+        }
+        /**
+         * @brief Get row permutation sorting the Table by key column
+         * @tparam I Key column index
+         * @param SOrder ASCending = 1, DESCending = -1. Default ASC
+         * @return Array<int> Row indices in sorted order
+         */
+        template <size_t I>
+        Array<int> argsortBy (Order SOrder = ASC) const {return get<I>(this->C).argsort(SOrder);}
+        /**
+         * @brief Sort rows by key column (stable). Only the key column is compared, other columns are permuted once
+         * @tparam I Key column index
+         * @param SOrder ASCending = 1, DESCending = -1. Default ASC
+         */
+        template <size_t I>
+        void sortBy (Order SOrder = ASC) {
+            BA_PROFILE_SCOPE("Table::sortBy");
+            if (this->S == 0) return;
+            *this = take(argsortBy<I>(SOrder));
+        }
+        /**
+         * @brief Get maximum value of column
+         * @tparam I Column index
+         */
+        template <size_t I>
+        ColumnType<I> max () const {return get<I>(this->C).max();}
+        /**
+         * @brief Get minimum value of column
+         * @tparam I Column index
+         */
+        template <size_t I>
+        ColumnType<I> min () const {return get<I>(this->C).min();}
+        /**
+         * @brief Get average of column
+         * @tparam I Column index
+         */
+        template <size_t I>
+        double mean () const {return get<I>(this->C).mean();}
+        /**
+         * @brief Get sum of column
+         * @tparam I Column index
+         */
+        template <size_t I>
+        ColumnType<I> sum () const {return get<I>(this->C).lazy().sum();}
+        /**
+         * @brief Display Table, one row per line
+         */
+        void show () const {
+            string out;
+            for (unsigned i = 0; i < this->S; i++) {
+                out += "[";
+                appendRowText(out, i, index_sequence_for<Cols...>());
+                out += "]\n";
+            }
+            cout<<out;
+        }
+};
+#endif // !TABLE_H
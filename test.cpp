@@ -1,8 +1,628 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <map>
+#include <set>
+#include <tuple>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include "better_array.h"
+#include "array_compression.h"
+#include "batched_array.h"
+#include "concurrent_array.h"
+#include "table.h"
+#include "async_files.h"
+#include "groupby.h"
+#include "join.h"
 using namespace std;
+template <class T>
+bool sameArray (const Array<T> &X, const Array<T> &Y) {
+    if (X.size() != Y.size()) return false;
+    for (unsigned i = 0; i < X.size(); i++) if (!(X[i] == Y[i])) return false;
+    return true;
+}
+// Every SIMD level must match the scalar loops: exactly, except float and double mean (summation order)
+template <class T>
+bool simdMatchesScalar (unsigned n) {
+    Array<T> X(n), Y(n);
+    for (unsigned i = 0; i < n; i++) {
+        X[i] = (T) ((T) (i * 37 % 101) - (T) 50) / (T) 10;
+        Y[i] = (T) ((T) (i * 53 % 97) + (T) 4) / (T) 4;
+    }
+    Simd::Level Best = Simd::level();
+    Simd::setLevel(Simd::SIMD_SCALAR);
+    Array<T> Sum = X + Y, Diff = X - Y, Prod = X * Y, Quot = X / Y, Masked = X.masked(X < Y);
+    ArrayMask Eq = X == Y, Ne = X != 0, Le = X <= Y, Gt = X > 2;
+    T Max = X.max(), Min = X.min();
+    double Mean = X.mean();
+    bool ok = true;
+    for (int l = Simd::SIMD_SSE2; l <= Best; l++) {
+        Simd::setLevel((Simd::Level) l);
+        ok &= sameArray(X + Y, Sum) && sameArray(X - Y, Diff) && sameArray(X * Y, Prod) && sameArray(X / Y, Quot);
+        ok &= sameArray(X.masked(X < Y), Masked) && sameArray(X == Y, Eq) && sameArray(X != 0, Ne) && sameArray(X <= Y, Le) && sameArray(X > 2, Gt);
+        ok &= X.max() == Max && X.min() == Min;
+        ok &= fabs(X.mean() - Mean) <= (double) n * numeric_limits<double>::epsilon() * (fabs(Mean) + 1.0);
+    }
+    Simd::setLevel(Best);
+    return ok;
+}
+// Batched reductions must match every segment reduced as its own Array, at every SIMD level.
+// Segment lengths cross every vector width, floating types add segments holding NaN
+template <class T>
+bool batchedMatchesArrays () {
+    Array<Array<T>> Segments;
+    for (unsigned len = 1; len <= 40; len++) {
+        Array<T> S(len);
+        for (unsigned i = 0; i < len; i++) S[i] = (T) ((T) ((i * 37 + len * 11) % 101) - (T) 50) / (T) 10;
+        Segments.append(S);
+    }
+    if constexpr (is_floating_point<T>::value) {
+        const T NaN = numeric_limits<T>::quiet_NaN();
+        Segments.append(Array<T>({(T) 1, NaN, (T) 2, (T) 3, (T) 4, (T) 100, (T) 5, (T) 6}));
+        Segments.append(Array<T>({(T) 9, (T) -7, NaN, (T) 8, (T) 6, (T) -20, NaN, (T) 5, (T) 4, (T) 3, (T) 2, (T) 1, (T) 0, (T) 1, (T) 2, (T) 3, (T) 42}));
+        Segments.append(Array<T>({NaN, (T) 1, (T) 2, (T) 3}));
+    }
+    BatchedArray<T> B(Segments);
+    Simd::Level Best = Simd::level();
+    bool ok = true;
+    for (int l = Simd::SIMD_SCALAR; l <= Best; l++) {
+        Simd::setLevel((Simd::Level) l);
+        Array<T> Max = B.max(), Min = B.min(), Sum = B.sum();
+        Array<int> ArgMax = B.argmax(), ArgMin = B.argmin();
+        Array<double> Mean = B.mean();
+        for (unsigned s = 0; s < Segments.size(); s++) {
+            const Array<T> &S = Segments[s];
+            T M = S.max(), m = S.min(), Total = T();
+            for (unsigned i = 0; i < S.size(); i++) Total += S[i];
+            Array<int> Hi = S.argmax(), Lo = S.argmin();
+            // Same value, or NaN on both sides
+            ok &= (Max[s] == M || (Max[s] != Max[s] && M != M)) && (Min[s] == m || (Min[s] != Min[s] && m != m));
+            ok &= ArgMax[s] == (Hi.size() > 0 ? Hi[0] : 0) && ArgMin[s] == (Lo.size() > 0 ? Lo[0] : 0);
+            ok &= Sum[s] == Total || (Sum[s] != Sum[s] && Total != Total);
+            double Avg = S.mean();
+            ok &= fabs(Mean[s] - Avg) <= (double) S.size() * numeric_limits<double>::epsilon() * (fabs(Avg) + 1.0) || (Mean[s] != Mean[s] && Avg != Avg);
+        }
+    }
+    Simd::setLevel(Best);
+    return ok;
+}
+// Async jobs on the same file must run in call order: the append lands after the whole save
+bool asyncKeepsFileOrder (AsyncIO::Backend B) {
+    AsyncIO::setBackend(B);
+    const string Name = "async_order_test.txt";
+    Array<int> Big(200000), Small({-1, -2, -3});
+    for (unsigned i = 0; i < Big.size(); i++) Big[i] = (int) (i * 7 % 1000);
+    bool ok = true;
+    for (unsigned run = 0; run < 5; run++) {
+        future<void> Saved = Files::saveArrayAsync(Big, Name);
+        future<void> Appended = Files::appendArrayAsync(Small, Name);
+        future<Array<int>> Read = Files::readArrayAsync<int>(Name);
+        Saved.get();
+        Appended.get();
+        Array<int> X = Read.get(), Expected = Big;
+        Expected.append(Small);
+        ok &= sameArray(X, Expected);
+    }
+    remove(Name.c_str());
+    return ok;
+}
+// Scans must match serial loops (split into parallel blocks for large Arrays), windows must match direct window loops
+bool scansMatchLoops (unsigned n) {
+    Array<long long> A(n), Signs(n);
+    for (unsigned i = 0; i < n; i++) {
+        A[i] = (long long) (i * 7919 % 2003) - 1000;
+        Signs[i] = i % 7 == 3 ? -1 : 1;
+    }
+    Array<long long> Sum = A.cumsum(), Prod = Signs.cumprod(), Max = A.cummax(), Diff = A.diff();
+    long long s = 0, p = 1, m = A[0];
+    bool ok = Sum.size() == n && Prod.size() == n && Max.size() == n && Diff.size() == n - 1;
+    for (unsigned i = 0; ok && i < n; i++) {
+        s += A[i];
+        p *= Signs[i];
+        m = A[i] > m ? A[i] : m;
+        ok &= Sum[i] == s && Prod[i] == p && Max[i] == m && (i + 1 == n || Diff[i] == A[i + 1] - A[i]);
+    }
+    return ok;
+}
+bool windowsMatchLoops () {
+    const unsigned n = 2000;
+    Array<int> A(n);
+    for (unsigned i = 0; i < n; i++) A[i] = (int) (i * 37 % 101) - 50;
+    bool ok = A.slice(0, 0).diff().size() == 0;
+    for (unsigned w : {1u, 2u, 3u, 50u, n - 1, n, n + 1}) {
+        Array<int> Sum = A.rolling(w).sum(), Max = A.rolling(w).max(), Min = A.rolling(w).min();
+        Array<double> Mean = A.rolling(w).mean();
+        unsigned windows = w > n ? 0 : n - w + 1;
+        ok &= Sum.size() == windows && Max.size() == windows && Min.size() == windows && Mean.size() == windows;
+        for (unsigned k = 0; ok && k < windows; k++) {
+            int S = 0, M = A[k], m = A[k];
+            for (unsigned i = k; i < k + w; i++) {
+                S += A[i];
+                M = A[i] > M ? A[i] : M;
+                m = A[i] < m ? A[i] : m;
+            }
+            ok &= Sum[k] == S && Max[k] == M && Min[k] == m && fabs(Mean[k] - (double) S / w) < 1e-9;
+        }
+    }
+    try {
+        A.rolling(0);
+        ok = false;
+    }
+    catch (const invalid_argument&) {}
+    return ok;
+}
+// Selection must agree with a full sort: ranks, prefixes, ties ordered by index and interpolated quantiles
+bool selectionMatchesSort (unsigned n) {
+    Array<int> A(n);
+    for (unsigned i = 0; i < n; i++) A[i] = (int) (i * 7919 % 1009) % 200 - 100;
+    // References are sorted with std::sort, Array::sort() is a bubble sort
+    Array<int> Asc = A, Desc = A;
+    std::sort(Asc.data(), Asc.data() + n);
+    std::sort(Desc.data(), Desc.data() + n, greater<int>());
+    bool ok = true;
+    for (unsigned k : {0u, 1u, n / 3, n / 2, n - 1}) {
+        if (k >= n) continue;
+        ok &= A.nthElement(k) == Asc[k] && A.nthElement(k, DESC) == Desc[k];
+        Array<int> P = A;
+        P.partialSort(k + 1);
+        ok &= sameArray(P.slice(0, (int) k), Asc.slice(0, (int) k));
+        std::sort(P.data(), P.data() + n);
+        ok &= sameArray(P, Asc);
+    }
+    // Stable index order gives the expected tie breaking
+    vector<int> Idx(n);
+    for (unsigned i = 0; i < n; i++) Idx[i] = (int) i;
+    vector<int> Big = Idx, Small = Idx;
+    stable_sort(Big.begin(), Big.end(), [&A] (int x, int y) {return A[x] > A[y];});
+    stable_sort(Small.begin(), Small.end(), [&A] (int x, int y) {return A[x] < A[y];});
+    for (unsigned k : {1u, 5u, n / 2, n, n + 10}) {
+        unsigned m = k < n ? k : n;
+        Array<int> TopIdx = A.argtopk(k), LowIdx = A.argtopk(k, ASC), Top = A.topk(k);
+        ok &= TopIdx.size() == m && LowIdx.size() == m && Top.size() == m;
+        for (unsigned i = 0; ok && i < m; i++) ok &= TopIdx[i] == Big[i] && LowIdx[i] == Small[i] && Top[i] == A[Big[i]];
+    }
+    for (double q : {0.0, 0.1, 0.25, 0.5, 0.9, 1.0}) {
+        double pos = q * (n - 1);
+        unsigned lo = (unsigned) pos;
+        double Expected = lo + 1 < n ? Asc[lo] + (Asc[lo + 1] - Asc[lo]) * (pos - lo) : Asc[lo];
+        ok &= fabs(A.quantile(q) - Expected) < 1e-9;
+    }
+    ok &= A.median() == A.quantile(0.5);
+    return ok;
+}
+// Sketch quantiles must land close to the exact rank, also after merging sketches of file chunks
+bool sketchMatchesRanks () {
+    const unsigned n = 200000;
+    Array<int> A(n);
+    for (unsigned i = 0; i < n; i++) A[i] = (int) ((unsigned long long) i * 2654435761u % 1000003);
+    Files::saveArray(A, "sketch_test.txt");
+    QuantileSketch<int> Whole, Merged;
+    Whole.add(A);
+    unsigned long long read = Files::readChunks<int>("sketch_test.txt", 7777, [&Merged] (const Array<int> &Chunk) {
+        QuantileSketch<int> Part;
+        Part.add(Chunk);
+        Merged.merge(Part);
+    });
+    remove("sketch_test.txt");
+    Array<int> Sorted = A;
+    std::sort(Sorted.data(), Sorted.data() + n);
+    bool ok = read == n && Whole.count() == n && Merged.count() == n;
+    for (double q : {0.01, 0.25, 0.5, 0.75, 0.99}) {
+        for (const QuantileSketch<int> *S : {&Whole, &Merged}) {
+            int v = S->quantile(q);
+            double rank = (double) (lower_bound(Sorted.data(), Sorted.data() + n, v) - Sorted.data()) / n;
+            ok &= fabs(rank - q) < 0.02;
+        }
+    }
+    return ok;
+}
+// Moments, histograms and describe() must match two-pass loops, also for chunks merged in any order
+bool statsMatchNaive (unsigned n) {
+    Array<double> A(n);
+    // Large offset: a sum-of-squares variance would lose most digits here
+    for (unsigned i = 0; i < n; i++) A[i] = 1e6 + (double) ((i * 7919u) % 1013) / 8.0 - (i % 3 == 0 ? 40.0 : 0.0);
+    double mean = 0.0, m2 = 0.0, lo = A[0], hi = A[0];
+    for (unsigned i = 0; i < n; i++) {
+        mean += A[i];
+        lo = min(lo, A[i]);
+        hi = max(hi, A[i]);
+    }
+    mean /= n;
+    for (unsigned i = 0; i < n; i++) m2 += (A[i] - mean) * (A[i] - mean);
+    auto close = [] (double x, double y) {return fabs(x - y) <= 1e-9 * max(1.0, fabs(y));};
+    bool ok = close(A.var(), m2 / n) && close(A.std(), sqrt(m2 / n));
+    if (n > 1) ok &= close(A.var(1), m2 / (n - 1)) && close(A.std(1), sqrt(m2 / (n - 1)));
+    // Uneven chunks merged back to front give the same state as one pass
+    Stats::Moments Merged;
+    for (unsigned e = n; e > 0; ) {
+        unsigned b = e > 333 ? e - 333 : 0;
+        Merged.merge(A.slice((int) b, (int) e - 1).moments());
+        e = b;
+    }
+    ok &= Merged.count == n && close(Merged.mean, mean) && close(Merged.var(), m2 / n) && Merged.min == lo && Merged.max == hi;
+    // Histogram over a range that cuts both tails, the upper edge falls into the last bin
+    const unsigned bins = 7;
+    double from = hi - lo > 8.0 ? lo + 3.0 : lo - 1.0, to = hi - lo > 8.0 ? hi - 5.0 : hi + 1.0;
+    vector<unsigned> Count(bins, 0);
+    for (unsigned i = 0; i < n; i++) {
+        if (A[i] < from || A[i] > to) continue;
+        unsigned k = (unsigned) ((A[i] - from) * bins / (to - from));
+        Count[k < bins ? k : bins - 1]++;
+    }
+    Array<unsigned> H = A.histogram(bins, from, to);
+    ok &= H.size() == bins;
+    for (unsigned k = 0; ok && k < bins; k++) ok &= H[k] == Count[k];
+    // Edges hit exact values, those count to the bin on the right
+    Array<double> Edges({lo, mean, A[n / 2], hi});
+    std::sort(Edges.data(), Edges.data() + Edges.size());
+    Array<int> D = A.digitize(Edges);
+    ok &= D.size() == n;
+    for (unsigned i = 0; ok && i < n; i++) {
+        int Expected = 0;
+        for (unsigned j = 0; j < Edges.size(); j++) Expected += Edges[j] <= A[i];
+        ok &= D[i] == Expected;
+    }
+    Stats::Description S = A.describe();
+    ok &= S.count == n && close(S.mean, mean) && close(S.std, sqrt(m2 / n)) && S.min == lo && S.max == hi;
+    ok &= close(S.q25, A.quantile(0.25)) && close(S.median, A.quantile(0.5)) && close(S.q75, A.quantile(0.75));
+    return ok;
+}
+// Set operations must match std::set bookkeeping: first appearance order, ascending when both inputs are sorted
+template <class T>
+bool setsMatchNaive (const Array<T> &A, const Array<T> &B) {
+    set<T> InA, InB, Seen;
+    for (unsigned i = 0; i < A.size(); i++) InA.insert(A[i]);
+    for (unsigned j = 0; j < B.size(); j++) InB.insert(B[j]);
+    Array<T> Union, Inter, Diff;
+    auto add = [&Seen] (Array<T> &X, const T& v) {
+        if (Seen.insert(v).second) X.append(v);
+    };
+    for (unsigned i = 0; i < A.size(); i++) add(Union, A[i]);
+    for (unsigned j = 0; j < B.size(); j++) add(Union, B[j]);
+    Seen.clear();
+    for (unsigned i = 0; i < A.size(); i++) if (InB.count(A[i])) add(Inter, A[i]);
+    Seen.clear();
+    for (unsigned i = 0; i < A.size(); i++) if (!InB.count(A[i])) add(Diff, A[i]);
+    if (A.isSorted() && B.isSorted()) {
+        Union.sort();
+        Inter.sort();
+        Diff.sort();
+    }
+    bool ok = sameArray(A.setUnion(B), Union) && sameArray(A.setIntersection(B), Inter) && sameArray(A.setDifference(B), Diff);
+    const ArrayMask In = A.isin(B);
+    for (unsigned i = 0; i < A.size(); i++) ok &= In[i] == (InB.count(A[i]) > 0);
+    return ok;
+}
+bool setsMatch () {
+    Array<int> A(3000), B(200000);
+    Array<double> C(500), D(700);
+    Array<string> S(300), U(200);
+    for (unsigned i = 0; i < A.size(); i++) A[i] = (int) (i * 7919 % 4001) - 2000;
+    for (unsigned j = 0; j < B.size(); j++) B[j] = (int) (j * 104729 % 400009) - 200000;
+    for (unsigned i = 0; i < C.size(); i++) C[i] = (double) (i * 37 % 211) / 4.0;
+    for (unsigned j = 0; j < D.size(); j++) D[j] = (double) (j * 53 % 307) / 8.0;
+    for (unsigned i = 0; i < S.size(); i++) S[i] = "s" + to_string(i * 13 % 97);
+    for (unsigned j = 0; j < U.size(); j++) U[j] = "s" + to_string(j * 7 % 151);
+    Array<int> SmallB = B.slice(0, 999), SortedA = A, SortedB = SmallB;
+    SortedA.sort();
+    SortedB.sort();
+    Array<double> SortedC = C, SortedD = D;
+    SortedC.sort();
+    SortedD.sort();
+    bool ok = setsMatchNaive(A, SmallB) && setsMatchNaive(A, B) && setsMatchNaive(SortedA, SortedB) && setsMatchNaive(SortedB, SortedA);
+    ok &= setsMatchNaive(C, D) && setsMatchNaive(SortedC, SortedD) && setsMatchNaive(S, U) && setsMatchNaive(A, Array<int>());
+    return ok;
+}
+// Group-by aggregates must match a std::map pass. Hash methods list keys by first appearance, sort ascending
+template <class K>
+bool groupbyMatchesNaive (const Array<K> &Keys, const Array<long long> &Values, GroupMethod Method) {
+    struct Naive {
+        long long sum, max, min;
+        unsigned count;
+    };
+    map<K, Naive> M;
+    Array<K> Order;
+    for (unsigned i = 0; i < Keys.size(); i++) {
+        auto it = M.find(Keys[i]);
+        if (it == M.end()) {
+            M[Keys[i]] = {Values[i], Values[i], Values[i], 1};
+            Order.append(Keys[i]);
+            continue;
+        }
+        it->second.sum += Values[i];
+        it->second.max = Values[i] > it->second.max ? Values[i] : it->second.max;
+        it->second.min = Values[i] < it->second.min ? Values[i] : it->second.min;
+        it->second.count++;
+    }
+    if (Method == GROUP_SORT) Order.sort();
+    GroupBy<K, long long> G = groupby(Keys, Values, Method);
+    GroupResult<K, long long> Sum = G.sum(), Max = G.max(), Min = G.min();
+    GroupResult<K, unsigned> Count = G.count();
+    GroupResult<K, double> Mean = G.mean();
+    GroupResult<K, long long> Squares = G.aggregate(0ll, [] (long long& a, const long long& v) {a += v * v;}, [] (long long& a, const long long& b) {a += b;});
+    bool ok = G.groups() == M.size() && sameArray(G.keys(), Order) && sameArray(Sum.keys, Order) && sameArray(Mean.keys, Order);
+    for (unsigned g = 0; ok && g < Order.size(); g++) {
+        const Naive &N = M[Order[g]];
+        ok &= Sum.values[g] == N.sum && Max.values[g] == N.max && Min.values[g] == N.min && Count.values[g] == N.count;
+        ok &= fabs(Mean.values[g] - (double) N.sum / N.count) < 1e-9;
+    }
+    long long Total = 0, TotalSquares = 0;
+    for (unsigned i = 0; i < Values.size(); i++) {
+        Total += Values[i];
+        TotalSquares += Values[i] * Values[i];
+        ok &= G.keys()[G.groupIds()[i]] == Keys[i];
+    }
+    long long GroupedSquares = 0;
+    for (unsigned g = 0; g < Squares.values.size(); g++) GroupedSquares += Squares.values[g];
+    return ok && GroupedSquares == TotalSquares && Sum.values.lazy().sum() == Total;
+}
+bool groupbyMatches () {
+    const unsigned n = 5000;
+    Array<int> IntKeys(n);
+    Array<string> TextKeys(n);
+    Array<long long> Values(n);
+    for (unsigned i = 0; i < n; i++) {
+        IntKeys[i] = (int) (i * 7919 % 97) - 40;
+        TextKeys[i] = "k" + to_string(i * 31 % 53);
+        Values[i] = (long long) (i * 37 % 1001) - 500;
+    }
+    bool ok = true;
+    for (GroupMethod Method : {GROUP_AUTO, GROUP_HASH, GROUP_SORT, GROUP_PARTITIONED}) {
+        ok &= groupbyMatchesNaive(IntKeys, Values, Method) && groupbyMatchesNaive(TextKeys, Values, Method);
+    }
+    // Temporaries passed in are kept by the GroupBy
+    GroupBy<int, long long> G = groupby(Array<int>({3, 1, 3}), Array<long long>({10, 20, 30}));
+    GroupResult<int, long long> Sum = G.sum();
+    return ok && sameArray(Sum.keys, Array<int>({3, 1})) && sameArray(Sum.values, Array<long long>({40, 20}));
+}
+// Every join method must give the nested loop pairs: left row order, then right row order
+template <class T>
+bool sameJoin (const Array<T> &Left, const Array<T> &Right, JoinType How, JoinMethod Method) {
+    JoinResult R = joinIndices(Left, Right, How, Method);
+    Array<int> L, Rt;
+    for (unsigned i = 0; i < Left.size(); i++) {
+        unsigned hits = 0;
+        for (unsigned j = 0; j < Right.size(); j++) {
+            if (!(Left[i] == Right[j])) continue;
+            hits++;
+            if (How == INNER_JOIN || How == LEFT_JOIN) {
+                L.append((int) i);
+                Rt.append((int) j);
+            }
+        }
+        if ((How == SEMI_JOIN && hits > 0) || (How == ANTI_JOIN && hits == 0)) L.append((int) i);
+        if (How == LEFT_JOIN && hits == 0) {
+            L.append((int) i);
+            Rt.append(-1);
+        }
+    }
+    return sameArray(R.left, L) && sameArray(R.right, Rt);
+}
+// Key with hashing and equality but no ordering
+struct Tag {
+    int id;
+    bool operator== (const Tag &Other) const {return id == Other.id;}
+};
+namespace std {
+    template <> struct hash<Tag> {
+        size_t operator() (const Tag &T) const {return hash<int>()(T.id);}
+    };
+}
+bool joinMatchesNaive () {
+    Array<int> Left(300), Right(200);
+    for (unsigned i = 0; i < Left.size(); i++) Left[i] = (int) (i * 37 % 61);
+    for (unsigned j = 0; j < Right.size(); j++) Right[j] = (int) (j * 53 % 47) + 10;
+    Array<int> SortedLeft = Left, SortedRight = Right;
+    SortedLeft.sort();
+    SortedRight.sort();
+    Array<bool> BoolLeft({true, false, true}), BoolRight({false, false, true});
+    Array<Tag> TagLeft({{1}, {2}, {3}, {2}}), TagRight({{2}, {5}, {1}, {2}});
+    bool ok = true;
+    for (JoinType How : {INNER_JOIN, LEFT_JOIN, SEMI_JOIN, ANTI_JOIN}) {
+        for (JoinMethod Method : {JOIN_AUTO, JOIN_HASH, JOIN_PARTITIONED}) {
+            ok &= sameJoin(Left, Right, How, Method) && sameJoin(SortedLeft, SortedRight, How, Method);
+            ok &= sameJoin(BoolLeft, BoolRight, How, Method) && sameJoin(TagLeft, TagRight, How, Method);
+        }
+        ok &= sameJoin(SortedLeft, SortedRight, How, JOIN_MERGE) && sameJoin(SortedLeft, Right, How, JOIN_HASH);
+    }
+    // Merge join needs sorted keys with operator<
+    try {
+        joinIndices(Left, SortedRight, INNER_JOIN, JOIN_MERGE);
+        ok = false;
+    }
+    catch (const invalid_argument&) {}
+    try {
+        joinIndices(TagLeft, TagRight, INNER_JOIN, JOIN_MERGE);
+        ok = false;
+    }
+    catch (const invalid_argument&) {}
+    return ok;
+}
+// Compressed files must give back the saved values, slices must equal Array::slice()
+template <class T>
+bool compressionRoundTrip (const Array<T> &A, unsigned blockSize) {
+    const string Name = "compression_test.baz";
+    Files::saveCompressed(A, Name, blockSize);
+    bool ok = Files::compressedSize<T>(Name) == A.size() && sameArray(Files::readCompressed<T>(Name), A);
+    int n = (int) A.size();
+    for (int From : {0, 1, (int) blockSize - 1, (int) blockSize, n / 2, n - 1}) {
+        for (int To : {From, From + 1, From + (int) blockSize, n - 1}) {
+            if (From >= n || To >= n) continue;
+            ok &= sameArray(Files::readCompressed<T>(Name, From, To), A.slice(From, To));
+        }
+    }
+    ok &= sameArray(Files::readCompressed<T>(Name, -3), A.slice(n - 3, n - 1));
+    if ((int) blockSize + 2 <= n) ok &= sameArray(Files::readCompressed<T>(Name, -(int) blockSize - 2, -2), A.slice(n - (int) blockSize - 2, n - 2));
+    try {
+        Files::readCompressed<T>(Name, n - 1, n);
+        ok = false;
+    }
+    catch (const invalid_argument&) {}
+    // Cut file: index or block data is missing
+    ifstream In(Name, ios::binary);
+    string Bytes((istreambuf_iterator<char>(In)), istreambuf_iterator<char>());
+    In.close();
+    ofstream(Name, ios::binary | ios::trunc).write(Bytes.data(), Bytes.size() / 2);
+    try {
+        Files::readCompressed<T>(Name);
+        ok = false;
+    }
+    catch (const invalid_argument&) {}
+    remove(Name.c_str());
+    return ok;
+}
+bool compressionMatches () {
+    const unsigned n = 1037;
+    Array<int> I(n);
+    Array<long long> L(n);
+    Array<double> D(n);
+    Array<string> S(n);
+    for (unsigned i = 0; i < n; i++) {
+        I[i] = i % 100 == 7 ? (i % 200 == 7 ? numeric_limits<int>::min() : numeric_limits<int>::max()) : (int) (i * 3) - 500;
+        L[i] = (long long) i * i * 1000003ll - (i % 2 ? 1ll << 40 : 0);
+        D[i] = i % 50 == 3 ? -0.0 : (i % 50 == 4 ? numeric_limits<double>::infinity() : sin((double) i) * 1e3);
+        S[i] = i % 9 == 0 ? string() : "key_" + to_string(i % 37) + string(i % 5, 'x');
+    }
+    return compressionRoundTrip(I, 100) && compressionRoundTrip(L, 64) && compressionRoundTrip(D, 128) && compressionRoundTrip(S, 50) && compressionRoundTrip(I, 16384);
+}
+// Every producer's values must be published once, range appends stay contiguous
+bool concurrentKeepsAppends (unsigned producers, unsigned perProducer) {
+    ConcurrentArray<int> C;
+    vector<thread> T;
+    vector<unsigned long long> ranges(producers);
+    for (unsigned p = 0; p < producers; p++) {
+        T.emplace_back([&C, &ranges, p, perProducer] () {
+            for (unsigned i = 0; i < perProducer; i++) C.append((int) (p * perProducer + i));
+            ranges[p] = C.append({-1 - (int) p, -1 - (int) p, -1 - (int) p});
+        });
+    }
+    for (thread &t : T) t.join();
+    bool ok = C.size() == (unsigned long long) producers * (perProducer + 3);
+    Array<int> S = C.snapshot();
+    vector<unsigned> seen(producers * perProducer, 0);
+    for (unsigned i = 0; i < S.size(); i++) if (S[i] >= 0) seen[S[i]]++;
+    for (unsigned v = 0; v < seen.size(); v++) ok &= seen[v] == 1;
+    for (unsigned p = 0; p < producers; p++) {
+        for (unsigned k = 0; k < 3; k++) ok &= C[(long long) (ranges[p] + k)] == -1 - (int) p;
+    }
+    ok &= C[-1] == S[-1] && C.view().size() == C.size();
+    return ok;
+}
+// Copy constructor throwing for negative values while armed
+struct Fragile {
+    int v;
+    static bool armed;
+    Fragile (int V = 0) : v(V) {}
+    Fragile (const Fragile &Other) : v(Other.v) {
+        if (armed && v < 0) throw runtime_error("Fragile copy failed");
+    }
+    Fragile& operator= (const Fragile&) = default;
+};
+bool Fragile::armed = false;
+// Failed slots are tombstoned: later elements are still published, reading the slot throws, snapshots skip it
+bool concurrentSkipsFailedSlots () {
+    ConcurrentArray<Fragile> C;
+    Array<Fragile> Values({Fragile(1), Fragile(2), Fragile(-3), Fragile(4)});
+    C.append(Fragile(0));
+    Fragile::armed = true;
+    bool ok = false;
+    try {
+        C.append(Values);
+    }
+    catch (const runtime_error&) {ok = true;}
+    C.append(Fragile(5));
+    Fragile::armed = false;
+    ok &= C.size() == 6 && C[1].v == 1 && C[2].v == 2 && C[5].v == 5;
+    for (long long i : {3, 4}) {
+        try {
+            C[i];
+            ok = false;
+        }
+        catch (const invalid_argument&) {}
+    }
+    Array<Fragile> S = C.snapshot();
+    ok &= S.size() == 4 && S[0].v == 0 && S[1].v == 1 && S[2].v == 2 && S[3].v == 5;
+    return ok;
+}
+// Table operations must act on whole rows, as the same operations on a vector of tuples
+bool tableMatchesRows () {
+    typedef tuple<int, double, string> Row;
+    vector<Row> Rows;
+    Table<int, double, string> T;
+    for (unsigned i = 0; i < 500; i++) {
+        Row R((int) (i * 37 % 23), (double) (i * 53 % 101) / 4.0, "r" + to_string(i));
+        Rows.push_back(R);
+        T.appendRow(R);
+    }
+    auto same = [] (const Table<int, double, string> &X, const vector<Row> &Y) {
+        if (X.size() != Y.size()) return false;
+        for (unsigned i = 0; i < Y.size(); i++) if (X.row((int) i) != Y[i]) return false;
+        return true;
+    };
+    bool ok = same(T, Rows) && T.row(-1) == Rows.back();
+    vector<Row> Selected;
+    for (const Row &R : Rows) if (get<1>(R) > 12.5) Selected.push_back(R);
+    ok &= same(T.masked(T.column<1>() > 12.5), Selected);
+    Array<int> Picks({5, -1, 5, 0, 499});
+    vector<Row> Taken = {Rows[5], Rows[499], Rows[5], Rows[0], Rows[499]};
+    ok &= same(T.take(Picks), Taken);
+    // Equal keys keep insertion order in both directions
+    vector<Row> Asc = Rows, Desc = Rows;
+    stable_sort(Asc.begin(), Asc.end(), [] (const Row &A, const Row &B) {return get<0>(A) < get<0>(B);});
+    stable_sort(Desc.begin(), Desc.end(), [] (const Row &A, const Row &B) {return get<0>(A) > get<0>(B);});
+    Table<int, double, string> SortedAsc = T, SortedDesc = T;
+    SortedAsc.sortBy<0>();
+    SortedDesc.sortBy<0>(DESC);
+    ok &= same(SortedAsc, Asc) && same(SortedDesc, Desc);
+    double Sum = 0.0, Max = get<1>(Rows[0]), Min = Max;
+    for (const Row &R : Rows) {
+        Sum += get<1>(R);
+        Max = get<1>(R) > Max ? get<1>(R) : Max;
+        Min = get<1>(R) < Min ? get<1>(R) : Min;
+    }
+    ok &= T.sum<1>() == Sum && T.max<1>() == Max && T.min<1>() == Min && fabs(T.mean<1>() - Sum / Rows.size()) < 1e-12;
+    try {
+        Table<int, double> Bad(Array<int>({1, 2}), Array<double>({1.0}));
+        ok = false;
+    }
+    catch (const invalid_argument&) {}
+    return ok;
+}
+// Lazy chains must give the values of the same stages applied one by one
+bool lazyMatchesEager (unsigned n, unsigned maskSize, unsigned limit) {
+    Array<int> A(n);
+    for (unsigned i = 0; i < n; i++) A[i] = (int) (i * 37 % 101) - 50;
+    Array<int> Pattern(maskSize);
+    for (unsigned i = 0; i < maskSize; i++) Pattern[i] = (int) (i % 3);
+    const ArrayMask M = Pattern != 1;
+    auto odd = [] (const int& v) {return v % 2 != 0;};
+    auto twice = [] (const int& v) {return 2 * v + 1;};
+    // filter -> map -> mask -> take, mask tests source indices (past its end values are kept)
+    Array<int> Expected;
+    for (unsigned i = 0; i < n && Expected.size() < limit; i++) {
+        if (odd(A[i]) && (i >= maskSize || M[i])) Expected.append(twice(A[i]));
+    }
+    Array<int> All;
+    for (unsigned i = 0; i < n; i++) if (odd(A[i]) && (i >= maskSize || M[i])) All.append(twice(A[i]));
+    bool ok = sameArray(A.lazy().filter(odd).map(twice).mask(M).take(limit).toArray(), Expected);
+    ok &= A.lazy().filter(odd).map(twice).mask(M).take(limit).count() == Expected.size();
+    ok &= sameArray(A.lazy().filter(odd).map(twice).mask(M).toArray(), All);
+    ok &= sameArray(A.lazy().filter(odd).map(twice).mask(M).parallel(4).toArray(), All);
+    long long Total = 0;
+    for (unsigned i = 0; i < All.size(); i++) Total += All[i];
+    ok &= A.lazy().filter(odd).map(twice).mask(M).parallel(4).sum() == (int) Total;
+    ok &= A.lazy().filter(odd).map(twice).mask(M).reduce(0ll, [] (long long x, const int& v) {return x + v;}) == Total;
+    if (All.size() > 0) {
+        ok &= A.lazy().filter(odd).map(twice).mask(M).max() == All.max() && A.lazy().filter(odd).map(twice).mask(M).parallel(4).min() == All.min();
+        ok &= fabs(A.lazy().filter(odd).map(twice).mask(M).mean() - (double) Total / All.size()) < 1e-9;
+    }
+    // take() before later stages limits source elements, not results
+    Array<int> Head;
+    for (unsigned i = 0; i < n && i < limit; i++) if (odd(A[i])) Head.append(A[i]);
+    ok &= sameArray(A.lazy().take(limit).filter(odd).toArray(), Head);
+    return ok;
+}
 bool CustomMask (int Array_Elem) {
     return Array_Elem < 2 || Array_Elem > 6;
 }
@@ -101,6 +721,27 @@ int main () {
     string conv_string = Converter::toString(C);
     cout<<conv_string<<endl;
     Converter::toCharArray(conv_string).show(true);
+    cout<<"SIMD levels up to "<<Simd::levelName(Simd::level())<<" match scalar: ";
+    cout<<(simdMatchesScalar<int>(1003) && simdMatchesScalar<unsigned>(1003) && simdMatchesScalar<long long>(1003) && simdMatchesScalar<float>(1003) && simdMatchesScalar<double>(1003) ? "OK" : "FAILED")<<endl;
+    cout<<"Batched reductions match per-segment Arrays: ";
+    cout<<(batchedMatchesArrays<int>() && batchedMatchesArrays<unsigned>() && batchedMatchesArrays<long long>() && batchedMatchesArrays<float>() && batchedMatchesArrays<double>() ? "OK" : "FAILED")<<endl;
+    unsigned Threads = Parallel::threads();
+    Parallel::threads(4);       // Async pool is sized on first use, several workers run even on single core machines
+    AsyncIO::Backend Backend = AsyncIO::backend();
+    cout<<"Async save, append and read keep order ("<<AsyncIO::backendName(Backend)<<"): "<<(asyncKeepsFileOrder(Backend) ? "OK" : "FAILED")<<endl;
+    cout<<"Async save, append and read keep order (threads): "<<(asyncKeepsFileOrder(AsyncIO::ASYNC_THREADS) ? "OK" : "FAILED")<<endl;
+    AsyncIO::setBackend(Backend);
+    cout<<"Compressed files round trip with slices: "<<(compressionMatches() ? "OK" : "FAILED")<<endl;
+    cout<<"Concurrent appends published once: "<<(concurrentKeepsAppends(4, 20000) && concurrentSkipsFailedSlots() ? "OK" : "FAILED")<<endl;
+    cout<<"Table rows match tuples: "<<(tableMatchesRows() ? "OK" : "FAILED")<<endl;
+    cout<<"Lazy chains match eager stages: "<<(lazyMatchesEager(5000, 3000, 700) && lazyMatchesEager(200000, 200000, 0) && lazyMatchesEager(100, 0, 1000) ? "OK" : "FAILED")<<endl;
+    cout<<"Scans and rolling windows match loops: "<<(scansMatchLoops(1) && scansMatchLoops(1000) && scansMatchLoops(1000000) && windowsMatchLoops() ? "OK" : "FAILED")<<endl;
+    cout<<"Selection matches full sort: "<<(selectionMatchesSort(1) && selectionMatchesSort(7) && selectionMatchesSort(1000) && selectionMatchesSort(100000) && sketchMatchesRanks() ? "OK" : "FAILED")<<endl;
+    cout<<"Statistics match two-pass loops: "<<(statsMatchNaive(1) && statsMatchNaive(1000) && statsMatchNaive(300000) ? "OK" : "FAILED")<<endl;
+    cout<<"Set operations match std::set: "<<(setsMatch() ? "OK" : "FAILED")<<endl;
+    cout<<"Group-by matches map aggregation: "<<(groupbyMatches() ? "OK" : "FAILED")<<endl;
+    cout<<"Joins match nested loops: "<<(joinMatchesNaive() ? "OK" : "FAILED")<<endl;
+    Parallel::threads(Threads);
     /*Files::saveArray(A, "A.txt");
     Files::appendArray(A, "A.txt");
     Files::readArray<int>("A.txt").show();*/
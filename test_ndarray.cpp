@@ -1,6 +1,273 @@
 #include <iostream>
+#include <cmath>
 #include "ndarray.h"
+#include "sparse_ndarray.h"
+#include "fft.h"
+#include "mapped_ndarray.h"
+#include "convolution.h"
 using namespace std;
+// Naive O(n^2) DFT of x[first], x[first + step], ... (n values)
+Array<complex<double>> naiveDft (const Array<complex<double>> &X, unsigned first, unsigned step, unsigned n, bool inverse) {
+    Array<complex<double>> Y(n);
+    for (unsigned k = 0; k < n; k++) {
+        complex<double> S = 0.0;
+        for (unsigned j = 0; j < n; j++) S += X[first + j * step] * polar(1.0, (inverse ? 2.0 : -2.0) * M_PI * (double) ((unsigned long long) j * k % n) / (double) n);
+        Y[k] = inverse ? S / (double) n : S;
+    }
+    return Y;
+}
+bool closeTo (const complex<double> &A, const complex<double> &B, unsigned n) {
+    return abs(A - B) <= 1e-12 * (double) n * (abs(B) + 1.0);
+}
+// fft and ifft must match a naive DFT and round trip, at every SIMD level (Stockham and Bluestein lengths)
+bool fftMatchesDft () {
+    Simd::Level Best = Simd::level();
+    bool ok = true;
+    for (int l = Simd::SIMD_SCALAR; l <= Best; l++) {
+        Simd::setLevel((Simd::Level) l);
+        for (unsigned n : {1u, 2u, 3u, 8u, 12u, 17u, 60u, 97u, 128u, 210u}) {
+            Array<complex<double>> X(n);
+            Array<double> Re(n);
+            for (unsigned i = 0; i < n; i++) {
+                X[i] = complex<double>((double) (i * 37 % 101) / 10.0 - 5.0, (double) (i * 53 % 97) / 10.0 - 4.0);
+                Re[i] = X[i].real();
+            }
+            Array<complex<double>> F = fft(X), D = naiveDft(X, 0, 1, n, false), Back = ifft(F), I = ifft(X), DI = naiveDft(X, 0, 1, n, true);
+            Array<complex<double>> RF = rfft(Re), RD = fft(Re);
+            Array<double> RBack = irfft(RF, n);
+            for (unsigned k = 0; k < n; k++) {
+                ok &= closeTo(F[k], D[k], n) && closeTo(Back[k], X[k], n) && closeTo(I[k], DI[k], n);
+                ok &= closeTo(RBack[k], Re[k], n) && (k > n / 2 || closeTo(RF[k], RD[k], n));
+            }
+        }
+        // Axis 0 lines are strided, 11 columns cover a full and a partial gather block
+        unsigned rows = 24, cols = 11;
+        Array<complex<double>> V(rows * cols);
+        for (unsigned i = 0; i < V.size(); i++) V[i] = complex<double>((double) (i % 13), (double) (i % 7) - 3.0);
+        Array<complex<double>> F = fft(NDArray<complex<double>>(2, Array<unsigned>({rows, cols}), V), 0).flatten();
+        for (unsigned c = 0; c < cols; c++) {
+            Array<complex<double>> D = naiveDft(V, c, cols, rows, false);
+            for (unsigned k = 0; k < rows; k++) ok &= closeTo(F[k * cols + c], D[k], rows);
+        }
+    }
+    Simd::setLevel(Best);
+    return ok;
+}
+// Sparse products must equal dense triple loops (small integer values keep double sums exact)
+bool sparseMatchesDense (unsigned rows, unsigned inner, unsigned cols) {
+    Array<double> a(rows * inner), b(inner * cols), d(cols * rows), x(inner);
+    for (unsigned i = 0; i < a.size(); i++) a[i] = (i * 7919u) % 20 == 0 ? (double) (i % 9) - 4.0 : 0.0;
+    for (unsigned i = 0; i < b.size(); i++) b[i] = (double) (i % 5) - 2.0;
+    for (unsigned i = 0; i < d.size(); i++) d[i] = (double) (i % 3);
+    for (unsigned i = 0; i < x.size(); i++) x[i] = (double) (i % 7) - 3.0;
+    NDArray<double> A(2, Array<unsigned>({rows, inner}), a), B(2, Array<unsigned>({inner, cols}), b), D(2, Array<unsigned>({cols, rows}), d);
+    SparseNDArray<double> S(A);
+    Array<double> AB = S.matmul(B).flatten(), DA = matmul(D, S).flatten(), Ax = S.matmul(x);
+    bool ok = true;
+    for (unsigned r = 0; r < rows; r++) {
+        double y = 0.0;
+        for (unsigned k = 0; k < inner; k++) y += a[r * inner + k] * x[k];
+        ok &= Ax[r] == y;
+        for (unsigned c = 0; c < cols; c++) {
+            double p = 0.0;
+            for (unsigned k = 0; k < inner; k++) p += a[r * inner + k] * b[k * cols + c];
+            ok &= AB[r * cols + c] == p;
+        }
+    }
+    for (unsigned c = 0; c < cols; c++) {
+        for (unsigned k = 0; k < inner; k++) {
+            double p = 0.0;
+            for (unsigned r = 0; r < rows; r++) p += d[c * rows + r] * a[r * inner + k];
+            ok &= DA[c * inner + k] == p;
+        }
+    }
+    return ok;
+}
+// Axis scans and windows must equal the Array operation applied to every line along the axis
+bool axisScansMatchLines () {
+    const unsigned shape[3] = {4, 5, 6};
+    Array<int> V(120);
+    for (unsigned i = 0; i < V.size(); i++) V[i] = (int) (i * 37 % 23) - 11;
+    NDArray<int> X(3, Array<unsigned>({4, 5, 6}), V);
+    bool ok = true;
+    for (unsigned axis = 0; axis < 3; axis++) {
+        unsigned len = shape[axis], inner = 1, outer = 1;
+        for (unsigned d = axis + 1; d < 3; d++) inner *= shape[d];
+        for (unsigned d = 0; d < axis; d++) outer *= shape[d];
+        Array<int> Sum = X.cumsum(axis).flatten(), Max = X.cummax(axis).flatten(), Diff = X.diff(axis).flatten();
+        Array<int> RSum = X.rollingSum(2, axis).flatten(), RMin = X.rollingMin(3, axis).flatten();
+        for (unsigned o = 0; o < outer; o++) {
+            for (unsigned in = 0; in < inner; in++) {
+                Array<int> Line(len);
+                for (unsigned k = 0; k < len; k++) Line[k] = V[(o * len + k) * inner + in];
+                auto same = [&] (const Array<int> &Flat, const Array<int> &Expected) {
+                    bool eq = true;
+                    unsigned m = Expected.size();
+                    for (unsigned k = 0; k < m; k++) eq &= Flat[(o * m + k) * inner + in] == Expected[k];
+                    return eq;
+                };
+                ok &= same(Sum, Line.cumsum()) && same(Max, Line.cummax()) && same(Diff, Line.diff());
+                ok &= same(RSum, Line.rolling(2).sum()) && same(RMin, Line.rolling(3).min());
+            }
+        }
+    }
+    return ok;
+}
+template <class T>
+bool sameValues (const Array<T> &A, const Array<T> &B) {
+    if (A.size() != B.size()) return false;
+    for (unsigned i = 0; i < A.size(); i++) if (A[i] != B[i]) return false;
+    return true;
+}
+// Mapped files must give back the saved values, slices and per-axis reductions of line loops, copy-on-write never reaches the file
+bool mappedMatchesLines (unsigned d0, unsigned d1, unsigned d2) {
+    const unsigned shape[3] = {d0, d1, d2};
+    Array<int> V(d0 * d1 * d2);
+    for (unsigned i = 0; i < V.size(); i++) V[i] = (int) (i * 7919u % 1201) - 600;
+    NDArray<int> X(3, Array<unsigned>({d0, d1, d2}), V);
+    Files::saveMapped(X, "mapped_test.band");
+    MappedNDArray<int> M = Files::mapNDArray<int>("mapped_test.band");
+    bool ok = M.dimension() == 3 && M.fullSize() == V.size() && M.accessMode() == MAPPED_READ;
+    for (unsigned d = 0; d < 3; d++) ok &= M.shape(d) == shape[d];
+    ok &= sameValues(M.toNDArray().flatten(), V) && sameValues(M.flatten(), V);
+    ok &= M.at({0, 0, 0}) == V[0] && M.at({-1, -1, -1}) == V[V.size() - 1] && M.flatten(-3, -2)[0] == V[V.size() - 3];
+    long long total = 0;
+    for (unsigned i = 0; i < V.size(); i++) total += V[i];
+    ok &= M.sum() == total && fabs(M.mean() - (double) total / V.size()) < 1e-9 && M.max() == V.max() && M.min() == V.min();
+    for (unsigned axis = 0; axis < 3; axis++) {
+        unsigned len = shape[axis], inner = 1, outer = 1;
+        for (unsigned d = axis + 1; d < 3; d++) inner *= shape[d];
+        for (unsigned d = 0; d < axis; d++) outer *= shape[d];
+        Array<int> Sum = M.sum(axis).flatten(), Max = M.max(axis).flatten(), Min = M.min(axis).flatten();
+        Array<double> Mean = M.mean(axis).flatten();
+        NDArray<int> Last = M.slice(len - 1, len - 1, axis);
+        ok &= Sum.size() == outer * inner && Last.shape()[axis] == 1;
+        for (unsigned o = 0; ok && o < outer; o++) {
+            for (unsigned in = 0; in < inner; in++) {
+                int s = 0, hi = V[o * len * inner + in], lo = hi;
+                for (unsigned k = 0; k < len; k++) {
+                    int v = V[(o * len + k) * inner + in];
+                    s += v;
+                    hi = max(hi, v);
+                    lo = min(lo, v);
+                }
+                unsigned c = o * inner + in;
+                ok &= Sum[c] == s && Max[c] == hi && Min[c] == lo && fabs(Mean[c] - (double) s / len) < 1e-9;
+                ok &= Last.flatten()[c] == V[(o * len + len - 1) * inner + in];
+            }
+        }
+    }
+    // Read-only mappings refuse writes, private copies keep them away from the file
+    try {
+        M.set({0, 0, 0}, 1);
+        ok = false;
+    }
+    catch (const invalid_argument&) {}
+    MappedNDArray<int> C("mapped_test.band", MAPPED_COPY_ON_WRITE);
+    C.set({-1, 0, 0}, 12345);
+    C.writableData()[0] = -12345;
+    ok &= C.at({-1, 0, 0}) == 12345 && C.at({0, 0, 0}) == -12345 && M.at({0, 0, 0}) == V[0];
+    ok &= sameValues(MappedNDArray<int>("mapped_test.band").flatten(), V);
+    // Type mismatch is refused from the header
+    try {
+        MappedNDArray<double> Wrong("mapped_test.band");
+        ok = false;
+    }
+    catch (const invalid_argument&) {}
+    remove("mapped_test.band");
+    return ok;
+}
+// Full correlation of flat 3-D shapes by definition, out[o] = sum of S[o + off - (k - 1) + j] * K[j] (kernel reversed when flip)
+template <class T>
+Array<T> naiveCorrelate (const Array<T> &S, const unsigned sn[3], const Array<T> &K, const unsigned kn[3], ConvolveMode Mode, bool flip, unsigned on[3]) {
+    unsigned off[3];
+    for (unsigned d = 0; d < 3; d++) {
+        on[d] = Mode == CONVOLVE_FULL ? sn[d] + kn[d] - 1 : (Mode == CONVOLVE_SAME ? sn[d] : sn[d] - kn[d] + 1);
+        off[d] = Mode == CONVOLVE_FULL ? 0 : (Mode == CONVOLVE_SAME ? (kn[d] - 1) / 2 : kn[d] - 1);
+    }
+    Array<T> X(on[0] * on[1] * on[2]);
+    for (unsigned z = 0; z < on[0]; z++) for (unsigned y = 0; y < on[1]; y++) for (unsigned x = 0; x < on[2]; x++) {
+        T acc = T();
+        for (unsigned i = 0; i < kn[0]; i++) for (unsigned j = 0; j < kn[1]; j++) for (unsigned k = 0; k < kn[2]; k++) {
+            long long a = (long long) z + off[0] + i - (kn[0] - 1), b = (long long) y + off[1] + j - (kn[1] - 1), c = (long long) x + off[2] + k - (kn[2] - 1);
+            if (a < 0 || b < 0 || c < 0 || a >= sn[0] || b >= sn[1] || c >= sn[2]) continue;
+            unsigned t = flip ? ((kn[0] - 1 - i) * kn[1] + kn[1] - 1 - j) * kn[2] + kn[2] - 1 - k : (i * kn[1] + j) * kn[2] + k;
+            acc += S[(a * sn[1] + b) * sn[2] + c] * K[t];
+        }
+        X[(z * on[1] + y) * on[2] + x] = acc;
+    }
+    return X;
+}
+// Convolution and correlation must match the definition in every mode, direct and through spectra, for Arrays and NDArrays
+template <class T>
+bool convolutionMatchesNaive (unsigned dims, const unsigned sn[3], const unsigned kn[3]) {
+    Array<T> S(sn[0] * sn[1] * sn[2]), K(kn[0] * kn[1] * kn[2]);
+    for (unsigned i = 0; i < S.size(); i++) S[i] = (T) ((int) (i * 37 % 19) - 9);
+    for (unsigned i = 0; i < K.size(); i++) K[i] = (T) ((int) (i * 11 % 7) - 3);
+    Array<unsigned> SShape, KShape;
+    for (unsigned d = 3 - dims; d < 3; d++) {
+        SShape.append(sn[d]);
+        KShape.append(kn[d]);
+    }
+    NDArray<T> SND(dims, SShape, S), KND(dims, KShape, K);
+    bool ok = true;
+    for (ConvolveMode Mode : {CONVOLVE_FULL, CONVOLVE_SAME, CONVOLVE_VALID}) {
+        bool fits = kn[0] <= sn[0] && kn[1] <= sn[1] && kn[2] <= sn[2];
+        for (ConvolveMethod Method : {CONVOLVE_AUTO, CONVOLVE_DIRECT, CONVOLVE_FFT}) {
+            for (bool flip : {true, false}) {
+                if (Mode == CONVOLVE_VALID && !fits) {
+                    try {
+                        flip ? convolve(SND, KND, Mode, Method) : correlate(SND, KND, Mode, Method);
+                        ok = false;
+                    }
+                    catch (const invalid_argument&) {}
+                    continue;
+                }
+                unsigned on[3];
+                Array<T> Expected = naiveCorrelate(S, sn, K, kn, Mode, flip, on);
+                NDArray<T> Got = flip ? convolve(SND, KND, Mode, Method) : correlate(SND, KND, Mode, Method);
+                Array<T> Flat = Got.flatten();
+                ok &= Got.dimension() == dims && Flat.size() == Expected.size();
+                for (unsigned d = 0; d < dims; d++) ok &= Got.shape(d) == on[3 - dims + d];
+                if (dims == 1) {
+                    Array<T> Line = flip ? convolve(S, K, Mode, Method) : correlate(S, K, Mode, Method);
+                    ok &= Line.size() == Expected.size();
+                    for (unsigned i = 0; ok && i < Line.size(); i++) ok &= fabs((double) Line[i] - (double) Expected[i]) <= 1e-9 * (1.0 + fabs((double) Expected[i]));
+                }
+                // Integral FFT results are rounded, so they stay exact
+                for (unsigned i = 0; ok && i < Flat.size(); i++) ok &= fabs((double) Flat[i] - (double) Expected[i]) <= 1e-9 * (1.0 + fabs((double) Expected[i]));
+            }
+        }
+    }
+    return ok;
+}
+bool convolutionMatches () {
+    const unsigned shapes[][6] = {
+        {1, 1, 1, 1, 1, 1}, {1, 1, 10, 1, 1, 3}, {1, 1, 9, 1, 1, 4}, {1, 1, 3, 1, 1, 7}, {1, 1, 5000, 1, 1, 77},
+        {1, 7, 9, 1, 3, 2}, {1, 40, 50, 1, 9, 8}, {1, 2, 3, 1, 4, 2}, {4, 5, 6, 3, 2, 3}, {5, 4, 3, 2, 5, 1}
+    };
+    bool ok = true;
+    for (const unsigned *s : shapes) {
+        unsigned dims = s[0] > 1 || s[3] > 1 ? 3 : (s[1] > 1 || s[4] > 1 ? 2 : 1);
+        ok &= convolutionMatchesNaive<double>(dims, s, s + 3) && convolutionMatchesNaive<int>(dims, s, s + 3);
+    }
+    return ok;
+}
+// Summarized output keeps edge items of every dimension around "...", edge 0 leaves only "..."
+bool summaryMatches () {
+    Array<int> V(20);
+    for (unsigned i = 0; i < V.size(); i++) V[i] = (int) i;
+    NDArray<int> M(2, Array<unsigned>({4, 5}), V);
+    bool ok = M.format() == "[[0,1,2,3,4],[5,6,7,8,9],[10,11,12,13,14],[15,16,17,18,19]]";
+    Formatter::setPrintOptions(5, 0);
+    ok &= M.format() == "[...]";
+    Formatter::setPrintOptions(5, 1);
+    ok &= M.format() == "[[0,...,4],...,[15,...,19]]";
+    Formatter::setPrintOptions(5, 2);
+    ok &= M.format() == "[[0,1,...,3,4],[5,6,...,8,9],[10,11,...,13,14],[15,16,...,18,19]]";
+    Formatter::setPrintOptions(0);
+    return ok;
+}
 int main () {
     NDArray<int> A(3, {3, 2, 4});
     A.fill({1, 2, 3, 4, 5, 6, 7, 8, 9}, 2);
@@ -25,6 +292,21 @@ int main () {
     A = A.slice(1, 2, 2).slice(1, 1, 3);
     A.collapse();
     A.show();
+    unsigned Threads = Parallel::threads();
+    Parallel::threads(4);       // Parallel row chunks run even on single core machines
+    cout<<"Sparse matmul matches dense: "<<(sparseMatchesDense(7, 5, 3) && sparseMatchesDense(2000, 1000, 8) ? "OK" : "FAILED")<<endl;
+    cout<<"Mapped files match saved NDArray: "<<(mappedMatchesLines(3, 4, 5) && mappedMatchesLines(300, 40, 20) && mappedMatchesLines(4, 20, 3000) ? "OK" : "FAILED")<<endl;
+    cout<<"Convolution matches definition in every mode: "<<(convolutionMatches() ? "OK" : "FAILED")<<endl;
+    Parallel::threads(Threads);
+    NDArray<bool> Even = A.map([] (const int& v) {return v % 2 == 0;});
+    NDArray<int> Back = Even.map([] (const bool& e) {return e ? 1 : 0;});
+    Array<int> Flat = A.flatten(), BackFlat = Back.flatten();
+    bool mapOk = Even.dimension() == A.dimension() && Even.fullSize() == A.fullSize();
+    for (unsigned i = 0; i < A.fullSize(); i++) mapOk &= BackFlat[i] == (Flat[i] % 2 == 0 ? 1 : 0);
+    cout<<"FFT matches naive DFT at SIMD levels up to "<<Simd::levelName(Simd::level())<<": "<<(fftMatchesDft() ? "OK" : "FAILED")<<endl;
+    cout<<"Axis scans and windows match lines: "<<(axisScansMatchLines() ? "OK" : "FAILED")<<endl;
+    cout<<"Summarized format keeps edge items: "<<(summaryMatches() ? "OK" : "FAILED")<<endl;
+    cout<<"Bool map matches elements: "<<(mapOk ? "OK" : "FAILED")<<endl;
     cin.ignore();
     cin.get();
     return 0;